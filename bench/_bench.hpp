@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+
+template <class T>
+inline void do_not_optimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<const volatile char *>(&value);
+#endif
+}
+
+struct timer {
+    using clock = std::chrono::steady_clock;
+
+    clock::time_point start = clock::now();
+
+    void reset() {
+        start = clock::now();
+    }
+
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(clock::now() - start)
+            .count();
+    }
+};
+
+// Prints one result line: total time and time per operation.
+inline void report(const char *name, double ms, std::size_t ops) {
+    std::printf("%-40s %10.2f ms %10.2f ns/op\n", name, ms,
+                ops ? ms * 1e6 / static_cast<double>(ops) : 0.0);
+}
+
+// The first command line argument, if any, overrides the problem size.
+inline std::size_t problem_size(int argc, char **argv, std::size_t fallback) {
+    if (argc > 1) {
+        return static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+    }
+    return fallback;
+}
+
+} // namespace bench
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+namespace bench {
+
+// Calls to the global operator new so far; compare before and after a run.
+inline std::size_t allocations = 0;
+
+} // namespace bench
+
+// These replace the allocation functions of the whole program, so only the
+// benches that report allocation counts define BENCH_COUNT_ALLOCATIONS.
+void *operator new(std::size_t size) {
+    ++bench::allocations;
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+#endif
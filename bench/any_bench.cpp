@@ -0,0 +1,54 @@
+#define BENCH_COUNT_ALLOCATIONS
+#include "_bench.hpp"
+#include <any>
+#include <cstdint>
+#include <utility/any.hpp>
+#include <vector>
+
+// a property bag full of small scalars: fill it, copy it, read every value
+// back. Counts heap allocations per value alongside time.
+template <class Any, class Cast>
+void run(const char *label, std::size_t n, Cast cast) {
+    char name[64];
+    std::vector<Any> bag;
+    bag.reserve(n);
+    std::size_t before = bench::allocations;
+    bench::timer t;
+    for (std::size_t i = 0; i != n; ++i) {
+        if (i % 2) {
+            bag.emplace_back(static_cast<std::int64_t>(i));
+        } else {
+            bag.emplace_back(static_cast<double>(i));
+        }
+    }
+    std::vector<Any> copy = bag;
+    double sum = 0;
+    for (Any &value: copy) {
+        if (const std::int64_t *p = cast.template operator()<std::int64_t>(
+                &value)) {
+            sum += static_cast<double>(*p);
+        } else {
+            sum += *cast.template operator()<double>(&value);
+        }
+    }
+    double ms = t.elapsed_ms();
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s fill+copy+read", label);
+    bench::report(name, ms, n);
+    std::printf("%-40s %10.2f allocs/value\n", "",
+                static_cast<double>(bench::allocations - before - 1) /
+                    static_cast<double>(n));
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 1000000);
+    std::printf("n = %zu\n", n);
+    for (int round = 0; round != 2; ++round) {
+        run<Marcus::any>("Marcus::any", n, []<class T>(Marcus::any *a) {
+            return Marcus::any_cast<T>(a);
+        });
+        run<std::any>("std::any", n, []<class T>(std::any *a) {
+            return std::any_cast<T>(a);
+        });
+    }
+}
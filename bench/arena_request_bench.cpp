@@ -0,0 +1,106 @@
+#include "_bench.hpp"
+#include <containers/deque.hpp>
+#include <containers/forward_list.hpp>
+#include <containers/list.hpp>
+#include <containers/map.hpp>
+#include <containers/set.hpp>
+#include <containers/vector.hpp>
+#include <cstdint>
+#include <memory/memory_resource.hpp>
+
+// one simulated request: build a handful of scratch containers from the
+// request's items, do a little work on them, and tear them all down again.
+// the same request runs with the global heap, a pool_resource kept across
+// requests, and a monotonic_arena released after every request.
+template <class Alloc>
+static std::uint64_t mixed_request(std::size_t items, std::uint64_t seed,
+                                    const Alloc &alloc) {
+    using pair_alloc = typename std::allocator_traits<
+        Alloc>::template rebind_alloc<std::pair<const int, int>>;
+    Marcus::vector<int, Alloc> ids(alloc);
+    Marcus::deque<int, Alloc> queue(alloc);
+    Marcus::list<int, Alloc> pending(alloc);
+    Marcus::map<int, int, std::less<int>, pair_alloc> counts(alloc);
+    Marcus::set<int, std::less<int>, Alloc> seen(alloc);
+    std::uint64_t state = seed;
+    for (std::size_t i = 0; i != items; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int id = static_cast<int>((state >> 33) % 512);
+        ids.push_back(id);
+        queue.push_back(id);
+        pending.push_back(id);
+        ++counts[id];
+        seen.insert(id);
+    }
+    std::uint64_t sum = 0;
+    for (auto &kv: counts) {
+        sum += kv.first * kv.second;
+    }
+    return sum + seen.size() + ids.size() + queue.size() + pending.size();
+}
+
+// a request that only builds linked lists: here allocation and teardown are
+// most of the work, so the allocator differences show up undiluted.
+template <class Alloc>
+static std::uint64_t list_request(std::size_t items, std::uint64_t seed,
+                                  const Alloc &alloc) {
+    Marcus::list<std::uint64_t, Alloc> pending(alloc);
+    Marcus::forward_list<std::uint64_t, Alloc> done(alloc);
+    for (std::size_t i = 0; i != items; ++i) {
+        pending.push_back(seed + i);
+        done.push_front(seed ^ i);
+    }
+    return pending.back() + done.front();
+}
+
+template <class Request>
+static void run(const char *kind, std::size_t requests, Request request) {
+    char name[64];
+    {
+        bench::timer t;
+        std::uint64_t sum = 0;
+        for (std::size_t r = 0; r != requests; ++r) {
+            sum += request(r, std::allocator<int>());
+        }
+        bench::do_not_optimize(sum);
+        std::snprintf(name, sizeof name, "%s, std::allocator", kind);
+        bench::report(name, t.elapsed_ms(), requests);
+    }
+    {
+        Marcus::pool_resource pool;
+        bench::timer t;
+        std::uint64_t sum = 0;
+        for (std::size_t r = 0; r != requests; ++r) {
+            sum += request(r, Marcus::polymorphic_allocator<int>(&pool));
+        }
+        bench::do_not_optimize(sum);
+        std::snprintf(name, sizeof name, "%s, pool_resource", kind);
+        bench::report(name, t.elapsed_ms(), requests);
+    }
+    {
+        // the first block is reused by every request after release()
+        alignas(std::max_align_t) static char buffer[256 * 1024];
+        Marcus::monotonic_arena arena(buffer, sizeof buffer);
+        bench::timer t;
+        std::uint64_t sum = 0;
+        for (std::size_t r = 0; r != requests; ++r) {
+            sum += request(r, Marcus::polymorphic_allocator<int>(&arena));
+            arena.release();
+        }
+        bench::do_not_optimize(sum);
+        std::snprintf(name, sizeof name, "%s, monotonic_arena", kind);
+        bench::report(name, t.elapsed_ms(), requests);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::size_t requests = bench::problem_size(argc, argv, 2000);
+    std::size_t items = 1000;
+    std::printf("requests = %zu, items per request = %zu\n", requests, items);
+    run("mixed", requests, [&](std::uint64_t seed, const auto &alloc) {
+        return mixed_request(items, seed, alloc);
+    });
+    run("lists", requests, [&](std::uint64_t seed, const auto &alloc) {
+        return list_request(items, seed, alloc);
+    });
+}
@@ -0,0 +1,67 @@
+#include "_bench.hpp"
+#include <algorithm>
+#include <containers/map.hpp>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <random>
+#include <vector>
+
+template <class Map>
+void run(const char *label, const std::vector<std::uint64_t> &keys,
+         const std::vector<std::uint64_t> &probes) {
+    char name[64];
+    Map m;
+    bench::timer t;
+    for (std::uint64_t k: keys) {
+        m.emplace(k, k);
+    }
+    std::snprintf(name, sizeof name, "%s insert", label);
+    bench::report(name, t.elapsed_ms(), keys.size());
+
+    t.reset();
+    std::uint64_t sum = 0;
+    for (std::uint64_t k: probes) {
+        auto it = m.find(k);
+        sum += it != m.end() ? it->second : 0;
+    }
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s lookup", label);
+    bench::report(name, t.elapsed_ms(), probes.size());
+
+    t.reset();
+    sum = 0;
+    for (auto it = m.begin(); it != m.end(); ++it) {
+        sum += it->second;
+    }
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s iterate", label);
+    bench::report(name, t.elapsed_ms(), keys.size());
+
+    t.reset();
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+        m.erase(keys[i]);
+    }
+    std::snprintf(name, sizeof name, "%s erase half", label);
+    bench::report(name, t.elapsed_ms(), keys.size() / 2);
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 1000000);
+    std::vector<std::uint64_t> keys(n);
+    std::iota(keys.begin(), keys.end(), std::uint64_t(0));
+    std::mt19937_64 rng(42);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::vector<std::uint64_t> probes(n);
+    for (auto &p: probes) {
+        p = rng() % (n + n / 4); // about 20% misses
+    }
+
+    std::printf("n = %zu, btree node slots = %zu\n", n,
+                Marcus::btree_map<std::uint64_t, std::uint64_t>::node_slots());
+    run<std::map<std::uint64_t, std::uint64_t>>("std::map", keys, probes);
+    run<Marcus::map<std::uint64_t, std::uint64_t>>("Marcus::map", keys,
+                                                   probes);
+    run<Marcus::btree_map<std::uint64_t, std::uint64_t>>("Marcus::btree_map",
+                                                         keys, probes);
+}
@@ -0,0 +1,60 @@
+#include "_bench.hpp"
+#include <containers/circular_buffer.hpp>
+#include <containers/deque.hpp>
+#include <cstdint>
+#include <numeric>
+
+// Sliding-window analytics: keep the last `window` samples of a stream and
+// recompute the window sum every `stride` samples. A deque used as a FIFO
+// keeps allocating blocks at the back and freeing them at the front; the
+// circular buffer reuses one allocation and hands the window to the sum as
+// (at most) two plain arrays.
+static std::uint64_t next_sample(std::uint64_t &state) {
+    state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+    return state & 0xffff;
+}
+
+static void run_deque(std::size_t n, std::size_t window, std::size_t stride) {
+    Marcus::deque<std::uint64_t> d;
+    std::uint64_t state = 88172645463325252ull, total = 0;
+    bench::timer t;
+    for (std::size_t i = 0; i != n; ++i) {
+        if (d.size() == window) {
+            d.pop_front();
+        }
+        d.push_back(next_sample(state));
+        if (i % stride == 0) {
+            total += std::accumulate(d.begin(), d.end(), std::uint64_t(0));
+        }
+    }
+    double ms = t.elapsed_ms();
+    bench::do_not_optimize(total);
+    bench::report("deque window", ms, n);
+}
+
+static void run_circular_buffer(std::size_t n, std::size_t window,
+                                std::size_t stride) {
+    Marcus::circular_buffer<std::uint64_t> buf(
+        window, Marcus::circular_buffer_mode::overwrite_oldest);
+    std::uint64_t state = 88172645463325252ull, total = 0;
+    bench::timer t;
+    for (std::size_t i = 0; i != n; ++i) {
+        buf.push_back(next_sample(state));
+        if (i % stride == 0) {
+            auto [a, b] = buf.as_spans();
+            total += std::accumulate(a.begin(), a.end(), std::uint64_t(0));
+            total += std::accumulate(b.begin(), b.end(), std::uint64_t(0));
+        }
+    }
+    double ms = t.elapsed_ms();
+    bench::do_not_optimize(total);
+    bench::report("circular_buffer window", ms, n);
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 20000000);
+    std::size_t window = 4096, stride = 1024;
+    std::printf("n = %zu, window = %zu, stride = %zu\n", n, window, stride);
+    run_deque(n, window, stride);
+    run_circular_buffer(n, window, stride);
+}
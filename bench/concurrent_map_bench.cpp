@@ -0,0 +1,81 @@
+#include "_bench.hpp"
+#include <containers/concurrent_map.hpp>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// 90% lookups / 10% upserts over a shared table, one global mutex around a
+// Marcus::map against the sharded concurrent_map
+struct locked_map {
+    mutable std::mutex mutex;
+    Marcus::map<std::uint64_t, std::uint64_t> table;
+
+    template <class F>
+    bool find_and_apply(std::uint64_t key, F &&f) const {
+        std::lock_guard lock(mutex);
+        auto it = table.find(key);
+        if (it == table.end()) {
+            return false;
+        }
+        f(it->second);
+        return true;
+    }
+
+    template <class F>
+    bool upsert(std::uint64_t key, F &&f, std::uint64_t value) {
+        std::lock_guard lock(mutex);
+        auto result = table.try_emplace(key, value);
+        if (!result.second) {
+            f(result.first->second);
+        }
+        return result.second;
+    }
+};
+
+template <class Map>
+void run(const char *label, std::size_t keys, std::size_t ops,
+         unsigned threads) {
+    Map table;
+    for (std::uint64_t k = 0; k != keys; ++k) {
+        table.upsert(k, [](std::uint64_t &) {}, k);
+    }
+    std::vector<std::thread> workers;
+    bench::timer t;
+    for (unsigned i = 0; i != threads; ++i) {
+        workers.emplace_back([&, i] {
+            std::mt19937_64 rng(i);
+            std::uint64_t sum = 0;
+            for (std::size_t n = ops / threads; n != 0; --n) {
+                std::uint64_t key = rng() % keys;
+                if (rng() % 10 == 0) {
+                    table.upsert(key, [](std::uint64_t &v) { ++v; }, key);
+                } else {
+                    table.find_and_apply(key, [&](const std::uint64_t &v) {
+                        sum += v;
+                    });
+                }
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+    char name[64];
+    std::snprintf(name, sizeof name, "%s %u threads", label, threads);
+    bench::report(name, t.elapsed_ms(), ops);
+}
+
+int main(int argc, char **argv) {
+    std::size_t ops = bench::problem_size(argc, argv, 2000000);
+    std::size_t keys = 100000;
+    std::printf("%zu ops over %zu keys, 90%% reads, %u hardware threads\n",
+                ops, keys, std::thread::hardware_concurrency());
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u, 64u}) {
+        run<locked_map>("mutex+map", keys, ops, threads);
+        run<Marcus::concurrent_map<std::uint64_t, std::uint64_t>>(
+            "concurrent_map", keys, ops, threads);
+    }
+}
@@ -0,0 +1,109 @@
+#include "_bench.hpp"
+#include <algorithm>
+#include <containers/deque.hpp>
+#include <containers/vector.hpp>
+#include <cstdint>
+#include <numeric>
+
+// Bulk algorithms over a large deque: the std algorithms step a deque
+// iterator one element at a time, the Marcus overloads run a plain pointer
+// loop per block. The same std algorithms over a vector are the baseline.
+static void run_std_vector(std::size_t n, int rounds) {
+    Marcus::vector<int> src(n, 1), dst(n);
+    bench::timer t;
+    for (int r = 0; r != rounds; ++r) {
+        std::fill(src.begin(), src.end(), r);
+        bench::do_not_optimize(src.back());
+    }
+    bench::report("vector fill", t.elapsed_ms(), n * rounds);
+    t.reset();
+    for (int r = 0; r != rounds; ++r) {
+        std::copy(src.begin(), src.end(), dst.begin());
+        bench::do_not_optimize(dst.back());
+    }
+    bench::report("vector copy", t.elapsed_ms(), n * rounds);
+    t.reset();
+    for (int r = 0; r != rounds; ++r) {
+        auto it = std::find(src.begin(), src.end(), -1);
+        bench::do_not_optimize(it);
+    }
+    bench::report("vector find (miss)", t.elapsed_ms(), n * rounds);
+    t.reset();
+    std::uint64_t sum = 0;
+    for (int r = 0; r != rounds; ++r) {
+        sum += std::accumulate(src.begin(), src.end(), std::uint64_t(0));
+    }
+    bench::do_not_optimize(sum);
+    bench::report("vector accumulate", t.elapsed_ms(), n * rounds);
+}
+
+static void run_std_deque(std::size_t n, int rounds) {
+    Marcus::deque<int> src(n, 1), dst(n);
+    bench::timer t;
+    for (int r = 0; r != rounds; ++r) {
+        std::fill(src.begin(), src.end(), r);
+        bench::do_not_optimize(src.back());
+    }
+    bench::report("deque std::fill", t.elapsed_ms(), n * rounds);
+    t.reset();
+    for (int r = 0; r != rounds; ++r) {
+        std::copy(src.begin(), src.end(), dst.begin());
+        bench::do_not_optimize(dst.back());
+    }
+    bench::report("deque std::copy", t.elapsed_ms(), n * rounds);
+    t.reset();
+    for (int r = 0; r != rounds; ++r) {
+        auto it = std::find(src.begin(), src.end(), -1);
+        bench::do_not_optimize(it);
+    }
+    bench::report("deque std::find (miss)", t.elapsed_ms(), n * rounds);
+    t.reset();
+    std::uint64_t sum = 0;
+    for (int r = 0; r != rounds; ++r) {
+        sum += std::accumulate(src.begin(), src.end(), std::uint64_t(0));
+    }
+    bench::do_not_optimize(sum);
+    bench::report("deque std::accumulate", t.elapsed_ms(), n * rounds);
+}
+
+static void run_segmented_deque(std::size_t n, int rounds) {
+    Marcus::deque<int> src(n, 1), dst(n);
+    bench::timer t;
+    for (int r = 0; r != rounds; ++r) {
+        Marcus::fill(src.begin(), src.end(), r);
+        bench::do_not_optimize(src.back());
+    }
+    bench::report("deque Marcus::fill", t.elapsed_ms(), n * rounds);
+    t.reset();
+    for (int r = 0; r != rounds; ++r) {
+        Marcus::copy(src.begin(), src.end(), dst.begin());
+        bench::do_not_optimize(dst.back());
+    }
+    bench::report("deque Marcus::copy", t.elapsed_ms(), n * rounds);
+    t.reset();
+    for (int r = 0; r != rounds; ++r) {
+        auto it = Marcus::find(src.begin(), src.end(), -1);
+        bench::do_not_optimize(it);
+    }
+    bench::report("deque Marcus::find (miss)", t.elapsed_ms(), n * rounds);
+    t.reset();
+    std::uint64_t sum = 0;
+    for (int r = 0; r != rounds; ++r) {
+        Marcus::for_each_segment(
+            src.cbegin(), src.cend(), [&](const int *first, const int *last) {
+                sum = std::accumulate(first, last, sum);
+            });
+    }
+    bench::do_not_optimize(sum);
+    bench::report("deque for_each_segment accumulate", t.elapsed_ms(),
+                  n * rounds);
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 10000000);
+    int rounds = 10;
+    std::printf("n = %zu, rounds = %d\n", n, rounds);
+    run_std_vector(n, rounds);
+    run_std_deque(n, rounds);
+    run_segmented_deque(n, rounds);
+}
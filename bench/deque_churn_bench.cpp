@@ -0,0 +1,72 @@
+#define BENCH_COUNT_ALLOCATIONS
+#include "_bench.hpp"
+#include <adaptors/queue.hpp>
+#include <containers/deque.hpp>
+#include <cstdint>
+
+// FIFO churn: a work queue that is filled with a short burst and then drained,
+// over and over, so it keeps crossing block boundaries while almost empty.
+// Spare blocks let those crossings reuse memory instead of going to the heap
+// each time. Also a deque whose size oscillates by one around a block
+// boundary, the worst case for freeing a block as soon as it empties.
+static void report(const char *label, double ms, std::size_t ops,
+                   std::size_t allocs) {
+    bench::report(label, ms, ops);
+    std::printf("%-40s %10.4f allocs/op\n", "",
+                static_cast<double>(allocs) / static_cast<double>(ops));
+}
+
+template <class Queue>
+static void run_queue(const char *label, std::size_t n) {
+    Queue q;
+    std::uint64_t state = 88172645463325252ull, sum = 0;
+    std::size_t ops = 0;
+    std::size_t before = bench::allocations;
+    bench::timer t;
+    while (ops < n) {
+        state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+        std::size_t burst = 1 + state % 64;
+        for (std::size_t i = 0; i != burst; ++i) {
+            q.push(static_cast<int>(i));
+        }
+        while (!q.empty()) {
+            sum += q.front();
+            q.pop();
+        }
+        ops += 2 * burst;
+    }
+    double ms = t.elapsed_ms();
+    bench::do_not_optimize(sum);
+    report(label, ms, ops, bench::allocations - before);
+}
+
+template <class Deque>
+static void run_boundary(const char *label, std::size_t n) {
+    Deque d;
+    // park the back right at the end of a block
+    while (d.size() != Deque::iterator::_block_size - 1) {
+        d.push_back(0);
+    }
+    std::size_t before = bench::allocations;
+    bench::timer t;
+    for (std::size_t i = 0; i != n; ++i) {
+        d.push_back(static_cast<int>(i));
+        d.pop_back();
+    }
+    double ms = t.elapsed_ms();
+    bench::do_not_optimize(d.back());
+    report(label, ms, 2 * n, bench::allocations - before);
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 20000000);
+    std::printf("n = %zu\n", n);
+    run_queue<Marcus::queue<int>>("queue bursts, 128 per block", n);
+    run_queue<Marcus::queue<int, Marcus::deque<int, std::allocator<int>, 16>>>(
+        "queue bursts, 16 per block", n);
+    run_queue<
+        Marcus::queue<int, Marcus::deque<int, std::allocator<int>, 1024>>>(
+        "queue bursts, 1024 per block", n);
+    run_boundary<Marcus::deque<int>>("deque push/pop at block boundary",
+                                     n / 2);
+}
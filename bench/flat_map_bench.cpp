@@ -0,0 +1,72 @@
+#include "_bench.hpp"
+#include <algorithm>
+#include <containers/flat_map.hpp>
+#include <containers/map.hpp>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+using entry = std::pair<std::uint64_t, std::uint64_t>;
+
+template <class Map>
+void run(const char *label, const std::vector<entry> &items,
+         const std::vector<entry> &batch,
+         const std::vector<std::uint64_t> &probes) {
+    char name[64];
+    bench::timer t;
+    Map m(items.begin(), items.end());
+    std::snprintf(name, sizeof name, "%s build", label);
+    bench::report(name, t.elapsed_ms(), items.size());
+
+    t.reset();
+    std::uint64_t sum = 0;
+    for (std::uint64_t k: probes) {
+        auto it = m.find(k);
+        sum += it != m.end() ? it->second : 0;
+    }
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s lookup", label);
+    bench::report(name, t.elapsed_ms(), probes.size());
+
+    t.reset();
+    sum = 0;
+    for (auto it = m.begin(); it != m.end(); ++it) {
+        sum += it->second;
+    }
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s iterate", label);
+    bench::report(name, t.elapsed_ms(), items.size());
+
+    t.reset();
+    m.insert(batch.begin(), batch.end());
+    std::snprintf(name, sizeof name, "%s insert batch", label);
+    bench::report(name, t.elapsed_ms(), batch.size());
+    bench::do_not_optimize(m.size());
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 1000000);
+    std::vector<std::uint64_t> keys(n + n / 10);
+    std::iota(keys.begin(), keys.end(), std::uint64_t(0));
+    std::mt19937_64 rng(42);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::vector<entry> items, batch;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        (i < n ? items : batch).emplace_back(keys[i], keys[i]);
+    }
+    std::vector<std::uint64_t> probes(n);
+    for (auto &p: probes) {
+        p = rng() % (n + n / 4); // about 20% misses
+    }
+
+    std::printf("n = %zu, batch = %zu\n", n, batch.size());
+    run<std::map<std::uint64_t, std::uint64_t>>("std::map", items, batch,
+                                                probes);
+    run<Marcus::map<std::uint64_t, std::uint64_t>>("Marcus::map", items,
+                                                   batch, probes);
+    run<Marcus::flat_map<std::uint64_t, std::uint64_t>>("Marcus::flat_map",
+                                                        items, batch, probes);
+}
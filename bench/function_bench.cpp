@@ -0,0 +1,75 @@
+#define BENCH_COUNT_ALLOCATIONS
+#include "_bench.hpp"
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility/functional.hpp>
+#include <vector>
+
+// an event dispatcher's hot path: wrap a small capturing lambda, store it,
+// copy it once (move for MoveOnlyFunction), call it. Counts heap allocations per event alongside time.
+template <class Fn>
+void run(const char *label, std::size_t n) {
+    char name[64];
+    std::vector<Fn> handlers;
+    handlers.reserve(n);
+    std::uint64_t sum = 0;
+    {
+        std::size_t before = bench::allocations;
+        bench::timer t;
+        for (std::uint64_t i = 0; i != n; ++i) {
+            std::uint64_t a = i, b = i * 3;
+            Fn f = [a, b](std::uint64_t x) {
+                return a + b + x;
+            };
+            sum += f(i);
+            if constexpr (std::is_copy_constructible_v<Fn>) {
+                Fn copy = f;
+                handlers.push_back(std::move(copy));
+            } else {
+                handlers.push_back(std::move(f));
+            }
+        }
+        double ms = t.elapsed_ms();
+        std::snprintf(name, sizeof name, "%s build+copy+call", label);
+        bench::report(name, ms, n);
+        std::printf("%-40s %10.2f allocs/op\n", "",
+                    double(bench::allocations - before) / double(n));
+    }
+    {
+        bench::timer t;
+        for (int round = 0; round != 10; ++round) {
+            for (const Fn &f: handlers) {
+                sum += f(round);
+            }
+        }
+        std::snprintf(name, sizeof name, "%s call", label);
+        bench::report(name, t.elapsed_ms(), n * 10);
+    }
+    {
+        std::uint64_t a = 1, b = 2, c = 3, d = 4;
+        std::size_t before = bench::allocations;
+        bench::timer t;
+        for (std::uint64_t i = 0; i != n; ++i) {
+            Fn f = [a, b, c, d, i](std::uint64_t x) {
+                return a + b + c + d + i + x;
+            };
+            sum += f(i);
+        }
+        double ms = t.elapsed_ms();
+        std::snprintf(name, sizeof name, "%s build+call (40B capture)", label);
+        bench::report(name, ms, n);
+        std::printf("%-40s %10.2f allocs/op\n", "",
+                    double(bench::allocations - before) / double(n));
+    }
+    bench::do_not_optimize(sum);
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 1000000);
+    std::printf("n = %zu\n", n);
+    run<std::function<std::uint64_t(std::uint64_t)>>("std::function", n);
+    run<Marcus::Function<std::uint64_t(std::uint64_t)>>("Marcus::Function", n);
+    run<Marcus::MoveOnlyFunction<std::uint64_t(std::uint64_t)>>(
+        "MoveOnlyFunction", n);
+}
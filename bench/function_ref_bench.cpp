@@ -0,0 +1,89 @@
+#include "_bench.hpp"
+#include <cstdint>
+#include <utility/functional.hpp>
+
+// a synchronous callback parameter: the callee is kept out of line so every
+// call goes through the type-erased path, and the caller builds the callback
+// at the call site each time, as hot call sites do
+using raw_callback = std::uint64_t (*)(void *, std::uint64_t);
+
+[[gnu::noinline]] std::uint64_t
+visit_raw(raw_callback f, void *context, std::uint64_t n) {
+    std::uint64_t sum = 0;
+    for (std::uint64_t i = 0; i != n; ++i) {
+        sum += f(context, i);
+    }
+    return sum;
+}
+
+[[gnu::noinline]] std::uint64_t
+visit_ref(Marcus::function_ref<std::uint64_t(std::uint64_t)> f,
+          std::uint64_t n) {
+    std::uint64_t sum = 0;
+    for (std::uint64_t i = 0; i != n; ++i) {
+        sum += f(i);
+    }
+    return sum;
+}
+
+[[gnu::noinline]] std::uint64_t
+visit_function(const Marcus::Function<std::uint64_t(std::uint64_t)> &f,
+               std::uint64_t n) {
+    std::uint64_t sum = 0;
+    for (std::uint64_t i = 0; i != n; ++i) {
+        sum += f(i);
+    }
+    return sum;
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 10000000);
+    std::uint64_t a = 3, b = 5, c = 7, d = 11, sum = 0;
+    std::printf("n = %zu\n", n);
+    for (std::uint64_t batch : {1000000ull, 1ull}) {
+        std::uint64_t rounds = n / batch;
+        char name[64];
+        {
+            bench::timer t;
+            for (std::uint64_t r = 0; r != rounds; ++r) {
+                std::uint64_t context[] = {a, b, c, d + r};
+                sum += visit_raw(
+                    +[](void *p, std::uint64_t x) {
+                        auto *k = static_cast<std::uint64_t *>(p);
+                        return k[0] * x + k[1] + k[2] + k[3];
+                    },
+                    context, batch);
+            }
+            std::snprintf(name, sizeof name, "function pointer, %llu calls",
+                          static_cast<unsigned long long>(batch));
+            bench::report(name, t.elapsed_ms(), rounds * batch);
+        }
+        {
+            bench::timer t;
+            for (std::uint64_t r = 0; r != rounds; ++r) {
+                sum += visit_ref(
+                    [a, b, c, d, r](std::uint64_t x) {
+                        return a * x + b + c + d + r;
+                    },
+                    batch);
+            }
+            std::snprintf(name, sizeof name, "function_ref, %llu calls",
+                          static_cast<unsigned long long>(batch));
+            bench::report(name, t.elapsed_ms(), rounds * batch);
+        }
+        {
+            bench::timer t;
+            for (std::uint64_t r = 0; r != rounds; ++r) {
+                sum += visit_function(
+                    [a, b, c, d, r](std::uint64_t x) {
+                        return a * x + b + c + d + r;
+                    },
+                    batch);
+            }
+            std::snprintf(name, sizeof name, "Function, %llu calls",
+                          static_cast<unsigned long long>(batch));
+            bench::report(name, t.elapsed_ms(), rounds * batch);
+        }
+    }
+    bench::do_not_optimize(sum);
+}
@@ -0,0 +1,87 @@
+#define BENCH_COUNT_ALLOCATIONS
+#include "_bench.hpp"
+#include <containers/list.hpp>
+#include <containers/map.hpp>
+#include <cstdint>
+#include <utility>
+
+// An LRU cache built from Marcus::list (recency order) and Marcus::map
+// (key -> list position). A hit moves the entry to the front, a miss evicts
+// the back. Moving to the front by erase + push_front costs a free and an
+// allocation per hit; splice only relinks the node. The node cache lets the
+// evicted node be reused by the entry that replaces it.
+struct lru_cache {
+    using entry = std::pair<std::uint64_t, std::uint64_t>;
+    using list_type = Marcus::list<entry>;
+
+    list_type order;
+    Marcus::map<std::uint64_t, list_type::iterator> index;
+    std::size_t capacity;
+    bool use_splice;
+
+    lru_cache(std::size_t capacity, bool use_splice, bool node_cache)
+        : capacity(capacity), use_splice(use_splice) {
+        if (node_cache) {
+            order.set_node_cache_limit(64);
+        }
+    }
+
+    std::uint64_t get(std::uint64_t key) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            if (use_splice) {
+                order.splice(order.cbegin(), order, it->second);
+            } else {
+                std::uint64_t value = it->second->second;
+                order.erase(it->second);
+                order.emplace_front(key, value);
+                it->second = order.begin();
+            }
+            return order.front().second;
+        }
+        if (index.size() == capacity) {
+            index.erase(order.back().first);
+            order.pop_back();
+        }
+        order.emplace_front(key, key * 2654435761u);
+        index.emplace(key, order.begin());
+        return order.front().second;
+    }
+};
+
+static void run(const char *label, std::size_t capacity, std::size_t ops,
+                bool use_splice, bool node_cache) {
+    lru_cache cache(capacity, use_splice, node_cache);
+    std::uint64_t state = 88172645463325252ull, sum = 0;
+    auto next_key = [&] {
+        state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+        // 90% of requests hit the hot 3/4 of the capacity, the rest are
+        // spread over twice the capacity and mostly miss
+        return state % 10 != 0 ? (state >> 8) % (capacity * 3 / 4)
+                               : (state >> 8) % (capacity * 2);
+    };
+    // warm up until the cache is full, so every later miss evicts
+    while (cache.index.size() != capacity) {
+        sum += cache.get(next_key());
+    }
+    std::size_t before = bench::allocations;
+    bench::timer t;
+    for (std::size_t i = 0; i != ops; ++i) {
+        sum += cache.get(next_key());
+    }
+    double ms = t.elapsed_ms();
+    bench::do_not_optimize(sum);
+    bench::report(label, ms, ops);
+    std::printf("%-40s %10.4f allocs/op\n", "",
+                static_cast<double>(bench::allocations - before) /
+                    static_cast<double>(ops));
+}
+
+int main(int argc, char **argv) {
+    std::size_t capacity = bench::problem_size(argc, argv, 1000000);
+    std::size_t ops = 4 * capacity;
+    std::printf("capacity = %zu, ops = %zu\n", capacity, ops);
+    run("lru erase + push_front", capacity, ops, false, false);
+    run("lru splice", capacity, ops, true, false);
+    run("lru splice + node cache", capacity, ops, true, true);
+}
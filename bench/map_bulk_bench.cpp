@@ -0,0 +1,56 @@
+#include "_bench.hpp"
+#include <containers/map.hpp>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+using item = std::pair<std::uint64_t, std::uint64_t>;
+
+template <class Map>
+void run(const char *label, const std::vector<item> &items) {
+    char name[64];
+    bench::timer t;
+    Map m(items.begin(), items.end());
+    std::snprintf(name, sizeof name, "%s range ctor", label);
+    bench::report(name, t.elapsed_ms(), items.size());
+
+    t.reset();
+    Map copy = m;
+    std::snprintf(name, sizeof name, "%s copy", label);
+    bench::report(name, t.elapsed_ms(), items.size());
+
+    t.reset();
+    std::uint64_t sum = 0;
+    for (const item &kv: items) {
+        sum += copy.find(kv.first)->second;
+    }
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s find", label);
+    bench::report(name, t.elapsed_ms(), items.size());
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 1000000);
+    std::vector<item> items(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        items[i] = {i * 2, i};
+    }
+
+    std::printf("n = %zu, sorted input\n", n);
+    run<std::map<std::uint64_t, std::uint64_t>>("std::map", items);
+    run<Marcus::map<std::uint64_t, std::uint64_t>>("Marcus::map", items);
+
+    // the same keys inserted one at a time, for comparison
+    bench::timer t;
+    Marcus::map<std::uint64_t, std::uint64_t> m;
+    for (const item &kv: items) {
+        m.emplace(kv.first, kv.second);
+    }
+    bench::report("Marcus::map emplace loop", t.elapsed_ms(), n);
+    _RbTreeMemoryStats stats =
+        Marcus::map<std::uint64_t, std::uint64_t>(items.begin(), items.end())
+            .memory_stats();
+    std::printf("bulk build: chunks=%zu reserved=%zu\n", stats.chunks,
+                stats.nodes_reserved);
+}
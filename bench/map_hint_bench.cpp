@@ -0,0 +1,49 @@
+#include "_bench.hpp"
+#include <containers/map.hpp>
+#include <cstdint>
+#include <map>
+
+// appending monotonically increasing timestamps, the common log/time-series
+// pattern: every key lands just before end()
+template <class Map>
+void run(const char *label, std::size_t n) {
+    char name[64];
+    {
+        Map m;
+        bench::timer t;
+        for (std::uint64_t i = 0; i != n; ++i) {
+            m.emplace(i * 16, i);
+        }
+        std::snprintf(name, sizeof name, "%s emplace", label);
+        bench::report(name, t.elapsed_ms(), n);
+        bench::do_not_optimize(m);
+    }
+    {
+        Map m;
+        bench::timer t;
+        for (std::uint64_t i = 0; i != n; ++i) {
+            m.emplace_hint(m.end(), i * 16, i);
+        }
+        std::snprintf(name, sizeof name, "%s emplace_hint(end)", label);
+        bench::report(name, t.elapsed_ms(), n);
+        bench::do_not_optimize(m);
+    }
+    {
+        Map m;
+        auto hint = m.end();
+        bench::timer t;
+        for (std::uint64_t i = 0; i != n; ++i) {
+            hint = m.emplace_hint(hint, i * 16, i);
+        }
+        std::snprintf(name, sizeof name, "%s emplace_hint(last)", label);
+        bench::report(name, t.elapsed_ms(), n);
+        bench::do_not_optimize(m);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 1000000);
+    std::printf("n = %zu, ascending keys\n", n);
+    run<std::map<std::uint64_t, std::uint64_t>>("std::map", n);
+    run<Marcus::map<std::uint64_t, std::uint64_t>>("Marcus::map", n);
+}
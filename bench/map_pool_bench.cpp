@@ -0,0 +1,69 @@
+#include "_bench.hpp"
+#include <algorithm>
+#include <containers/map.hpp>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <random>
+#include <vector>
+
+template <class Map>
+void run(const char *label, const std::vector<std::uint64_t> &keys) {
+    char name[64];
+    Map m;
+    bench::timer t;
+    for (std::uint64_t k: keys) {
+        m.emplace(k, k);
+    }
+    std::snprintf(name, sizeof name, "%s insert", label);
+    bench::report(name, t.elapsed_ms(), keys.size());
+
+    t.reset();
+    std::uint64_t sum = 0;
+    for (std::uint64_t k: keys) {
+        sum += m.find(k)->second;
+    }
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s find", label);
+    bench::report(name, t.elapsed_ms(), keys.size());
+
+    // steady-state churn: erase one key, insert a fresh one
+    t.reset();
+    for (std::size_t i = 0; i != keys.size(); ++i) {
+        m.erase(keys[i]);
+        m.emplace(keys[i] + 1, i);
+    }
+    std::snprintf(name, sizeof name, "%s erase+insert", label);
+    bench::report(name, t.elapsed_ms(), keys.size());
+
+    t.reset();
+    m.clear();
+    std::snprintf(name, sizeof name, "%s clear", label);
+    bench::report(name, t.elapsed_ms(), keys.size());
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 1000000);
+    std::vector<std::uint64_t> keys(n);
+    std::iota(keys.begin(), keys.end(), std::uint64_t(0));
+    for (auto &k: keys) {
+        k *= 2; // leave odd gaps for the churn phase
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+
+    std::printf("n = %zu\n", n);
+    run<std::map<std::uint64_t, std::uint64_t>>("std::map", keys);
+    run<Marcus::map<std::uint64_t, std::uint64_t>>("Marcus::map", keys);
+
+    Marcus::map<std::uint64_t, std::uint64_t> m;
+    for (std::uint64_t k: keys) {
+        m.emplace(k, k);
+    }
+    _RbTreeMemoryStats stats = m.memory_stats();
+    std::printf("node_size=%zu in_use=%zu free=%zu reserved=%zu chunks=%zu "
+                "bytes=%zu (%.1f bytes/element)\n",
+                stats.node_size, stats.nodes_in_use, stats.nodes_free,
+                stats.nodes_reserved, stats.chunks, stats.bytes_reserved,
+                static_cast<double>(stats.bytes_reserved) /
+                    static_cast<double>(n));
+}
@@ -0,0 +1,76 @@
+#include "_bench.hpp"
+#include <adaptors/mpmc_queue.hpp>
+#include <adaptors/queue.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// N producers hand integers to N consumers through a bounded queue, from 1+1
+// up to 32+32 threads: Marcus::queue under a mutex and two condition
+// variables against the lock-free mpmc_queue with blocking push/pop
+constexpr std::size_t capacity = 1024;
+
+struct locked_queue {
+    std::mutex mutex;
+    std::condition_variable not_empty, not_full;
+    Marcus::queue<std::uint64_t> queue;
+
+    void push(std::uint64_t value) {
+        std::unique_lock lock(mutex);
+        not_full.wait(lock, [&] { return queue.size() < capacity; });
+        queue.push(value);
+        lock.unlock();
+        not_empty.notify_one();
+    }
+
+    void pop(std::uint64_t &value) {
+        std::unique_lock lock(mutex);
+        not_empty.wait(lock, [&] { return !queue.empty(); });
+        value = queue.front();
+        queue.pop();
+        lock.unlock();
+        not_full.notify_one();
+    }
+};
+
+template <class Queue>
+void run(const char *label, std::size_t ops, unsigned pairs) {
+    Queue queue;
+    std::size_t per_thread = ops / pairs;
+    std::vector<std::thread> threads;
+    bench::timer t;
+    for (unsigned i = 0; i != pairs; ++i) {
+        threads.emplace_back([&] {
+            for (std::size_t n = 0; n != per_thread; ++n) {
+                queue.push(n);
+            }
+        });
+        threads.emplace_back([&] {
+            std::uint64_t sum = 0, value;
+            for (std::size_t n = 0; n != per_thread; ++n) {
+                queue.pop(value);
+                sum += value;
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+    char name[64];
+    std::snprintf(name, sizeof name, "%s %u+%u threads", label, pairs, pairs);
+    bench::report(name, t.elapsed_ms(), per_thread * pairs);
+}
+
+int main(int argc, char **argv) {
+    std::size_t ops = bench::problem_size(argc, argv, 2000000);
+    std::printf("%zu items, capacity %zu, %u hardware threads\n", ops,
+                capacity, std::thread::hardware_concurrency());
+    for (unsigned pairs : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        run<locked_queue>("mutex+queue", ops, pairs);
+        run<Marcus::mpmc_queue<std::uint64_t, capacity>>("mpmc_queue", ops,
+                                                          pairs);
+    }
+}
@@ -0,0 +1,83 @@
+#include "_bench.hpp"
+#include <containers/deque.hpp>
+#include <containers/vector.hpp>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+// bulk-loading n ints into an empty container: one element at a time versus
+// append_range / assign_range, which size the destination once and copy
+// contiguous trivially copyable sources with memcpy.
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 1 << 20);
+    std::size_t rounds = 20;
+    std::vector<int> contiguous(n);
+    std::iota(contiguous.begin(), contiguous.end(), 0);
+    std::list<int> linked(contiguous.begin(), contiguous.end());
+    std::printf("elements = %zu, rounds = %zu\n", n, rounds);
+
+    {
+        bench::timer t;
+        for (std::size_t r = 0; r != rounds; ++r) {
+            Marcus::vector<int> v;
+            for (int x: contiguous) {
+                v.push_back(x);
+            }
+            bench::do_not_optimize(v.data());
+        }
+        bench::report("vector push_back loop", t.elapsed_ms(), rounds);
+    }
+    {
+        bench::timer t;
+        for (std::size_t r = 0; r != rounds; ++r) {
+            Marcus::vector<int> v;
+            v.append_range(contiguous);
+            bench::do_not_optimize(v.data());
+        }
+        bench::report("vector append_range(contiguous)", t.elapsed_ms(),
+                      rounds);
+    }
+    {
+        bench::timer t;
+        for (std::size_t r = 0; r != rounds; ++r) {
+            Marcus::vector<int> v;
+            v.append_range(linked);
+            bench::do_not_optimize(v.data());
+        }
+        bench::report("vector append_range(list)", t.elapsed_ms(), rounds);
+    }
+    {
+        // a forward view without size(): one pass to count, one to copy
+        bench::timer t;
+        for (std::size_t r = 0; r != rounds; ++r) {
+            Marcus::vector<int> v;
+            v.append_range(std::views::iota(0, static_cast<int>(n)) |
+                           std::views::filter([](int) { return true; }));
+            bench::do_not_optimize(v.data());
+        }
+        bench::report("vector append_range(filter view)", t.elapsed_ms(),
+                      rounds);
+    }
+    {
+        bench::timer t;
+        for (std::size_t r = 0; r != rounds; ++r) {
+            Marcus::deque<int> d;
+            for (int x: contiguous) {
+                d.push_back(x);
+            }
+            bench::do_not_optimize(&d.back());
+        }
+        bench::report("deque push_back loop", t.elapsed_ms(), rounds);
+    }
+    {
+        bench::timer t;
+        for (std::size_t r = 0; r != rounds; ++r) {
+            Marcus::deque<int> d;
+            d.assign_range(contiguous);
+            bench::do_not_optimize(&d.back());
+        }
+        bench::report("deque assign_range(contiguous)", t.elapsed_ms(),
+                      rounds);
+    }
+}
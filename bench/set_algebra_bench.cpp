@@ -0,0 +1,86 @@
+#include "_bench.hpp"
+#include <algorithm>
+#include <containers/set.hpp>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+using key = std::uint64_t;
+
+template <class Set>
+Set make_set(const std::vector<key> &keys) {
+    Set s;
+    for (key k: keys) {
+        s.insert(k);
+    }
+    return s;
+}
+
+// the iterator-and-insert baseline: walk both sets, insert into a fresh one
+template <class Set, class Algorithm>
+void run_iterators(const char *label, std::size_t n, const Set &lhs,
+                   const Set &rhs, Algorithm algorithm) {
+    bench::timer t;
+    Set out;
+    algorithm(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+              std::inserter(out, out.end()));
+    bench::report(label, t.elapsed_ms(), 2 * n);
+    bench::do_not_optimize(out);
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 1000000);
+    std::mt19937_64 rng(42);
+    std::vector<key> lhs_keys(n), rhs_keys(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        lhs_keys[i] = rng() % (n * 3);
+        rhs_keys[i] = rng() % (n * 3);
+    }
+    std::printf("n = %zu per side, %u hardware threads\n", n,
+                std::thread::hardware_concurrency());
+
+    auto std_lhs = make_set<std::set<key>>(lhs_keys);
+    auto std_rhs = make_set<std::set<key>>(rhs_keys);
+    auto union_ = [](auto... args) { std::set_union(args...); };
+    auto intersection = [](auto... args) { std::set_intersection(args...); };
+    auto difference = [](auto... args) { std::set_difference(args...); };
+    run_iterators("std::set iterators union", n, std_lhs, std_rhs, union_);
+    run_iterators("std::set iterators intersection", n, std_lhs, std_rhs,
+                  intersection);
+    run_iterators("std::set iterators difference", n, std_lhs, std_rhs,
+                  difference);
+
+    using set = Marcus::set<key>;
+    set lhs = make_set<set>(lhs_keys);
+    set rhs = make_set<set>(rhs_keys);
+    run_iterators("Marcus::set iterators union", n, lhs, rhs, union_);
+
+    // the join-based operations work in place, so time each on fresh copies
+    {
+        set a = lhs, b = rhs;
+        bench::timer t;
+        a.merge(b);
+        bench::report("Marcus::set merge", t.elapsed_ms(), 2 * n);
+    }
+    {
+        set a = lhs, b = rhs;
+        bench::timer t;
+        a.set_union(std::move(b));
+        bench::report("Marcus::set set_union(&&)", t.elapsed_ms(), 2 * n);
+    }
+    {
+        set a = lhs;
+        bench::timer t;
+        a.set_intersection(rhs);
+        bench::report("Marcus::set set_intersection", t.elapsed_ms(), 2 * n);
+    }
+    {
+        set a = lhs;
+        bench::timer t;
+        a.set_difference(rhs);
+        bench::report("Marcus::set set_difference", t.elapsed_ms(), 2 * n);
+    }
+}
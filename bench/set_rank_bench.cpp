@@ -0,0 +1,60 @@
+#include "_bench.hpp"
+#include <containers/set.hpp>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+
+// percentile queries over a multiset of prices: std::multiset has to walk
+// iterators, Marcus::multiset answers nth/rank from the subtree sizes
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 100000);
+    std::size_t queries = 1000;
+    std::mt19937_64 rng(42);
+    std::multiset<std::uint32_t> expected;
+    Marcus::multiset<std::uint32_t> ranked;
+    for (std::size_t i = 0; i != n; ++i) {
+        std::uint32_t price = rng() % (n * 4);
+        expected.insert(price);
+        ranked.insert(price);
+    }
+    std::printf("n = %zu, %zu queries\n", n, queries);
+    {
+        std::uint64_t sum = 0;
+        bench::timer t;
+        for (std::size_t q = 0; q != queries; ++q) {
+            sum += *std::next(expected.begin(), rng() % n);
+        }
+        bench::report("std::multiset std::next", t.elapsed_ms(), queries);
+        bench::do_not_optimize(sum);
+    }
+    {
+        std::uint64_t sum = 0;
+        bench::timer t;
+        for (std::size_t q = 0; q != queries; ++q) {
+            sum += *ranked.nth(rng() % n);
+        }
+        bench::report("Marcus::multiset nth", t.elapsed_ms(), queries);
+        bench::do_not_optimize(sum);
+    }
+    {
+        std::uint64_t sum = 0;
+        bench::timer t;
+        for (std::size_t q = 0; q != queries; ++q) {
+            std::uint32_t price = rng() % (n * 4);
+            sum += std::distance(expected.begin(), expected.lower_bound(price));
+        }
+        bench::report("std::multiset lower_bound+distance", t.elapsed_ms(),
+                      queries);
+        bench::do_not_optimize(sum);
+    }
+    {
+        std::uint64_t sum = 0;
+        bench::timer t;
+        for (std::size_t q = 0; q != queries; ++q) {
+            sum += ranked.rank(static_cast<std::uint32_t>(rng() % (n * 4)));
+        }
+        bench::report("Marcus::multiset rank", t.elapsed_ms(), queries);
+        bench::do_not_optimize(sum);
+    }
+}
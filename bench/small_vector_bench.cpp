@@ -0,0 +1,45 @@
+#define BENCH_COUNT_ALLOCATIONS
+#include "_bench.hpp"
+#include <containers/small_vector.hpp>
+#include <containers/vector.hpp>
+#include <cstdint>
+#include <vector>
+
+// per-request scratch vectors: each request builds a short list (mostly under
+// 8 elements, occasionally more), reads it and throws it away. Counts heap
+// allocations per request alongside time.
+template <class Vector>
+void run(const char *label, std::size_t n) {
+    char name[64];
+    std::uint64_t state = 88172645463325252ull, sum = 0;
+    std::size_t before = bench::allocations;
+    bench::timer t;
+    for (std::size_t i = 0; i != n; ++i) {
+        state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+        // 1 in 16 requests holds 8..23 elements, the rest 0..7
+        std::size_t count = state % 16 ? state % 8 : 8 + (state >> 8) % 16;
+        Vector v;
+        for (std::size_t j = 0; j != count; ++j) {
+            v.push_back(static_cast<std::uint32_t>(state >> j));
+        }
+        for (std::uint32_t x: v) {
+            sum += x;
+        }
+    }
+    double ms = t.elapsed_ms();
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s", label);
+    bench::report(name, ms, n);
+    std::printf("%-40s %10.2f allocs/request\n", "",
+                static_cast<double>(bench::allocations - before) /
+                    static_cast<double>(n));
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 2000000);
+    std::printf("n = %zu\n", n);
+    run<std::vector<std::uint32_t>>("std::vector", n);
+    run<Marcus::vector<std::uint32_t>>("Marcus::vector", n);
+    run<Marcus::small_vector<std::uint32_t, 8>>("Marcus::small_vector<8>",
+                                                n);
+}
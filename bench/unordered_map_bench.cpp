@@ -0,0 +1,101 @@
+#include "_bench.hpp"
+#include <containers/unordered_map.hpp>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+template <class Map, class Key>
+void run(const char *label, const std::vector<Key> &keys,
+         const std::vector<Key> &misses) {
+    char name[64];
+    {
+        Map m;
+        bench::timer t;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            m.emplace(keys[i], i);
+        }
+        std::snprintf(name, sizeof name, "%s insert", label);
+        bench::report(name, t.elapsed_ms(), keys.size());
+    }
+
+    Map m;
+    bench::timer t;
+    m.reserve(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        m.emplace(keys[i], i);
+    }
+    std::snprintf(name, sizeof name, "%s insert reserved", label);
+    bench::report(name, t.elapsed_ms(), keys.size());
+
+    t.reset();
+    std::size_t sum = 0;
+    for (const Key &k: keys) {
+        sum += m.find(k)->second;
+    }
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s lookup hit", label);
+    bench::report(name, t.elapsed_ms(), keys.size());
+
+    t.reset();
+    sum = 0;
+    for (const Key &k: misses) {
+        sum += m.count(k);
+    }
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s lookup miss", label);
+    bench::report(name, t.elapsed_ms(), misses.size());
+
+    t.reset();
+    sum = 0;
+    for (auto it = m.begin(); it != m.end(); ++it) {
+        sum += it->second;
+    }
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s iterate", label);
+    bench::report(name, t.elapsed_ms(), keys.size());
+
+    t.reset();
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+        m.erase(keys[i]);
+    }
+    std::snprintf(name, sizeof name, "%s erase half", label);
+    bench::report(name, t.elapsed_ms(), keys.size() / 2);
+
+    // 删除一半之后的查找，开放寻址不留墓碑，探测链不会变长
+    t.reset();
+    sum = 0;
+    for (const Key &k: keys) {
+        sum += m.count(k);
+    }
+    bench::do_not_optimize(sum);
+    std::snprintf(name, sizeof name, "%s lookup after erase", label);
+    bench::report(name, t.elapsed_ms(), keys.size());
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 1000000);
+    std::mt19937_64 rng(42);
+    std::vector<std::uint64_t> keys(n), misses(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = rng() | 1; // 奇数键命中，偶数键一定不存在
+        misses[i] = rng() & ~std::uint64_t(1);
+    }
+    std::printf("n = %zu, uint64_t keys\n", n);
+    run<std::unordered_map<std::uint64_t, std::size_t>>("std::unordered_map",
+                                                       keys, misses);
+    run<Marcus::unordered_map<std::uint64_t, std::size_t>>(
+        "Marcus::unordered_map", keys, misses);
+
+    std::vector<std::string> skeys(n / 4), smisses(n / 4);
+    for (std::size_t i = 0; i < skeys.size(); ++i) {
+        skeys[i] = "key-" + std::to_string(keys[i]);
+        smisses[i] = "key-" + std::to_string(misses[i]);
+    }
+    std::printf("n = %zu, std::string keys\n", skeys.size());
+    run<std::unordered_map<std::string, std::size_t>>("std::unordered_map",
+                                                      skeys, smisses);
+    run<Marcus::unordered_map<std::string, std::size_t>>(
+        "Marcus::unordered_map", skeys, smisses);
+}
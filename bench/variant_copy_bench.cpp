@@ -0,0 +1,55 @@
+#include "_bench.hpp"
+#include <cstdint>
+#include <utility/variant.hpp>
+#include <variant>
+#include <vector>
+
+// vectors of small trivially copyable variants: the size of one element, then
+// growing a vector with push_back (every reallocation relocates the elements),
+// copying it whole, and summing it.
+template <template <typename...> class Variant>
+void run(const char *label, std::size_t n) {
+    using value = Variant<std::int32_t, float, std::uint16_t>;
+    char name[64];
+    std::printf("sizeof(%s<int32_t, float, uint16_t>) = %zu\n", label,
+                sizeof(value));
+    std::vector<value> values;
+    {
+        bench::timer t;
+        for (std::size_t i = 0; i != n; ++i) {
+            if (i % 3 == 0) {
+                values.push_back(value(static_cast<std::int32_t>(i)));
+            } else if (i % 3 == 1) {
+                values.push_back(value(static_cast<float>(i)));
+            } else {
+                values.push_back(value(static_cast<std::uint16_t>(i)));
+            }
+        }
+        std::snprintf(name, sizeof name, "%s push_back", label);
+        bench::report(name, t.elapsed_ms(), n);
+    }
+    {
+        bench::timer t;
+        std::vector<value> copy(values);
+        bench::do_not_optimize(copy.data());
+        std::snprintf(name, sizeof name, "%s copy", label);
+        bench::report(name, t.elapsed_ms(), n);
+    }
+    {
+        bench::timer t;
+        std::size_t sum = 0;
+        for (const value &v: values) {
+            sum += v.index();
+        }
+        bench::do_not_optimize(sum);
+        std::snprintf(name, sizeof name, "%s sum of index()", label);
+        bench::report(name, t.elapsed_ms(), n);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 10000000);
+    std::printf("n = %zu\n", n);
+    run<Marcus::variant>("Marcus::variant", n);
+    run<std::variant>("std::variant", n);
+}
@@ -0,0 +1,134 @@
+#include "_bench.hpp"
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility/variant.hpp>
+#include <vector>
+
+// a feed handler's message loop: a vector of message-type variants, each
+// visited once by a small handler. "table" is the previous dispatch, one
+// function pointer per alternative that the compiler cannot see through.
+struct heartbeat {
+    std::uint32_t seq;
+};
+
+struct order {
+    std::uint64_t id;
+    std::uint32_t price;
+    std::uint32_t qty;
+};
+
+struct cancel {
+    std::uint64_t id;
+};
+
+struct trade {
+    std::uint64_t id;
+    std::uint32_t price;
+    std::uint32_t qty;
+};
+
+using message = Marcus::variant<heartbeat, order, cancel, trade>;
+
+struct handler {
+    std::uint64_t operator()(const heartbeat &m) const {
+        return m.seq;
+    }
+
+    std::uint64_t operator()(const order &m) const {
+        return m.id + m.price * m.qty;
+    }
+
+    std::uint64_t operator()(const cancel &m) const {
+        return m.id ^ 0x5555;
+    }
+
+    std::uint64_t operator()(const trade &m) const {
+        return m.price - m.qty;
+    }
+};
+
+template <typename... Ts, typename Fn>
+std::uint64_t table_visit(const Marcus::variant<Ts...> &v, Fn &&fn) {
+    using entry = std::uint64_t (*)(const Marcus::variant<Ts...> &, Fn &&);
+    static entry table[] = {[](const Marcus::variant<Ts...> &v,
+                               Fn &&fn) -> std::uint64_t {
+        return std::invoke(std::forward<Fn>(fn), *v.template get_if<Ts>());
+    }...};
+    return table[v.index()](v, std::forward<Fn>(fn));
+}
+
+void run(const char *label, const std::vector<message> &messages) {
+    char name[64];
+    std::size_t n = messages.size();
+    {
+        bench::timer t;
+        std::uint64_t sum = 0;
+        for (const message &m: messages) {
+            sum += table_visit(m, handler{});
+        }
+        bench::do_not_optimize(sum);
+        std::snprintf(name, sizeof name, "table dispatch, %s", label);
+        bench::report(name, t.elapsed_ms(), n);
+    }
+    {
+        bench::timer t;
+        std::uint64_t sum = 0;
+        for (const message &m: messages) {
+            sum += m.visit(handler{});
+        }
+        bench::do_not_optimize(sum);
+        std::snprintf(name, sizeof name, "switch dispatch, %s", label);
+        bench::report(name, t.elapsed_ms(), n);
+    }
+    {
+        bench::timer t;
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i + 1 < n; i += 2) {
+            sum += Marcus::visit(
+                [](const auto &a, const auto &b) {
+                    return handler{}(a) - handler{}(b);
+                },
+                messages[i], messages[i + 1]);
+        }
+        bench::do_not_optimize(sum);
+        std::snprintf(name, sizeof name, "two-variant visit, %s", label);
+        bench::report(name, t.elapsed_ms(), n / 2);
+    }
+}
+
+// consecutive messages share a type in runs of `burst`; 1 is fully random
+std::vector<message> make_messages(std::size_t n, std::size_t burst) {
+    std::vector<message> messages;
+    messages.reserve(n);
+    std::uint64_t state = 88172645463325252ull, kind = 0;
+    for (std::size_t i = 0; i != n; ++i) {
+        state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+        std::uint32_t r = static_cast<std::uint32_t>(state);
+        if (i % burst == 0) {
+            kind = state >> 32;
+        }
+        switch (kind % 4) {
+        case 0:
+            messages.emplace_back(heartbeat{r});
+            break;
+        case 1:
+            messages.emplace_back(order{i, r, r >> 8});
+            break;
+        case 2:
+            messages.emplace_back(cancel{i});
+            break;
+        default:
+            messages.emplace_back(trade{i, r, r >> 8});
+            break;
+        }
+    }
+    return messages;
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 10000000);
+    std::printf("n = %zu\n", n);
+    run("random", make_messages(n, 1));
+    run("bursts", make_messages(n, 64));
+}
@@ -0,0 +1,63 @@
+#include "_bench.hpp"
+#include <containers/vector.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// push_back from empty (every reallocation relocates the whole buffer),
+// insert at the front (shifts the whole tail) and erase from the front, for a
+// trivially copyable and a non-trivial element type.
+template <class Vector, class Make>
+void run(const char *label, std::size_t n, std::size_t inserts, Make make) {
+    char name[80];
+    {
+        bench::timer t;
+        Vector v;
+        for (std::size_t i = 0; i != n; ++i) {
+            v.push_back(make(i));
+        }
+        bench::do_not_optimize(v.data());
+        std::snprintf(name, sizeof name, "%s push_back", label);
+        bench::report(name, t.elapsed_ms(), n);
+    }
+    {
+        Vector v;
+        for (std::size_t i = 0; i != inserts; ++i) {
+            v.push_back(make(i));
+        }
+        bench::timer t;
+        for (std::size_t i = 0; i != inserts; ++i) {
+            v.insert(v.begin(), make(i));
+        }
+        std::snprintf(name, sizeof name, "%s insert front", label);
+        bench::report(name, t.elapsed_ms(), inserts);
+        t.reset();
+        for (std::size_t i = 0; i != inserts; ++i) {
+            v.erase(v.begin());
+        }
+        std::snprintf(name, sizeof name, "%s erase front", label);
+        bench::report(name, t.elapsed_ms(), inserts);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 10000000);
+    std::size_t inserts = n / 500;
+    auto make_int = [](std::size_t i) {
+        return static_cast<std::uint64_t>(i);
+    };
+    auto make_string = [](std::size_t i) {
+        return std::string(i % 23, 'x');
+    };
+    std::printf("n = %zu, front inserts = %zu\n", n, inserts);
+    run<Marcus::vector<std::uint64_t>>("Marcus::vector<u64>", n, inserts,
+                                       make_int);
+    run<Marcus::vector<std::uint64_t, std::allocator<std::uint64_t>,
+                       Marcus::geometric_growth<3, 2>>>(
+        "Marcus::vector<u64>, x1.5", n, inserts, make_int);
+    run<std::vector<std::uint64_t>>("std::vector<u64>", n, inserts, make_int);
+    run<Marcus::vector<std::string>>("Marcus::vector<string>", n / 10,
+                                     inserts / 4, make_string);
+    run<std::vector<std::string>>("std::vector<string>", n / 10, inserts / 4,
+                                  make_string);
+}
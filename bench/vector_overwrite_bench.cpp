@@ -0,0 +1,54 @@
+#include "_bench.hpp"
+#include <algorithm>
+#include <containers/vector.hpp>
+#include <cstdint>
+#include <cstring>
+
+// a receive loop reusing one large byte buffer: each round the buffer is
+// emptied, grown back to full size and overwritten by a "read" (a memcpy from
+// a source block). resize() zeroes the bytes first; the other two do not.
+static std::size_t fake_read(const std::uint8_t *src, std::uint8_t *dst,
+                             std::size_t n) {
+    std::memcpy(dst, src, n);
+    return n;
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = bench::problem_size(argc, argv, 64 << 20);
+    std::size_t rounds = 20;
+    Marcus::vector<std::uint8_t> source(n, 7);
+    std::printf("buffer = %zu bytes, rounds = %zu\n", n, rounds);
+    Marcus::vector<std::uint8_t> buf;
+    buf.reserve(n);
+    {
+        bench::timer t;
+        for (std::size_t r = 0; r != rounds; ++r) {
+            buf.clear();
+            buf.resize(n);
+            fake_read(source.data(), buf.data(), n);
+            bench::do_not_optimize(buf.data());
+        }
+        bench::report("resize + read", t.elapsed_ms(), rounds);
+    }
+    {
+        bench::timer t;
+        for (std::size_t r = 0; r != rounds; ++r) {
+            buf.clear();
+            buf.resize_for_overwrite(n);
+            fake_read(source.data(), buf.data(), n);
+            bench::do_not_optimize(buf.data());
+        }
+        bench::report("resize_for_overwrite + read", t.elapsed_ms(), rounds);
+    }
+    {
+        bench::timer t;
+        for (std::size_t r = 0; r != rounds; ++r) {
+            buf.clear();
+            buf.append_with(n, [&](std::uint8_t *p, std::size_t m) {
+                return fake_read(source.data(), p, m);
+            });
+            bench::do_not_optimize(buf.data());
+        }
+        bench::report("append_with(read)", t.elapsed_ms(), rounds);
+    }
+}
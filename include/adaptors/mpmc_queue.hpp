@@ -0,0 +1,232 @@
+#pragma once
+
+#include <atomic>
+#include <common/_common.hpp>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Marcus {
+
+// 有界多生产者多消费者队列：环形数组的每个格子带一个序号，
+// 格子序号等于位置时可写，等于位置 + 1 时可读，读完后加上容量留给下一圈。
+// 生产者和消费者只在队首/队尾下标上用 CAS 竞争，不加锁
+template <typename _Tp, std::size_t _Capacity>
+class mpmc_queue {
+    static_assert(_Capacity >= 2 && (_Capacity & (_Capacity - 1)) == 0,
+                  "mpmc_queue: capacity must be a power of two");
+    static_assert(std::is_nothrow_move_constructible_v<_Tp> &&
+                      std::is_nothrow_move_assignable_v<_Tp> &&
+                      std::is_nothrow_destructible_v<_Tp>,
+                  "mpmc_queue: element type must be nothrow movable");
+
+public:
+    using value_type = _Tp;
+    using size_type = std::size_t;
+
+private:
+    static constexpr size_type _S_mask = _Capacity - 1;
+
+    struct _Cell {
+        std::atomic<size_type> _M_seq;
+        union {
+            _Tp _M_value;
+        };
+
+        _Cell() noexcept {}
+
+        ~_Cell() noexcept {}
+    };
+
+    alignas(_LIBPENGCXX_CACHE_LINE) std::atomic<size_type> _M_tail{0};
+    alignas(_LIBPENGCXX_CACHE_LINE) std::atomic<size_type> _M_head{0};
+    alignas(_LIBPENGCXX_CACHE_LINE) _Cell _M_cells[_Capacity];
+
+    _Cell &_M_cell(size_type __pos) noexcept {
+        return _M_cells[__pos & _S_mask];
+    }
+
+    // 在 __index 上认领从 __pos 开始、至多 __n 个连续的位置。_Offset 为 0 时
+    // 认领空格子（生产者），为 1 时认领满格子（消费者）。格子的序号只有认领者
+    // 才能改变，所以先检查再 CAS 是安全的。返回 0 时 __pos 处的格子尚未就绪，
+    // __seq 是观察到的序号，阻塞等待时用它
+    template <size_type _Offset>
+    size_type _M_claim(std::atomic<size_type> &__index, size_type __n,
+                       size_type &__pos, size_type &__seq) noexcept {
+        if (__n == 0) {
+            return 0;
+        }
+        __pos = __index.load(std::memory_order_relaxed);
+        for (;;) {
+            __seq = _M_cell(__pos)._M_seq.load(std::memory_order_acquire);
+            std::ptrdiff_t __diff =
+                static_cast<std::ptrdiff_t>(__seq - (__pos + _Offset));
+            if (__diff < 0) {
+                return 0;
+            }
+            if (__diff > 0) { // 别的线程已经认领了 __pos，重读下标
+                __pos = __index.load(std::memory_order_relaxed);
+                continue;
+            }
+            size_type __count = 1;
+            while (__count < __n &&
+                   _M_cell(__pos + __count)
+                           ._M_seq.load(std::memory_order_acquire) ==
+                       __pos + __count + _Offset) {
+                ++__count;
+            }
+            if (__index.compare_exchange_weak(__pos, __pos + __count,
+                                              std::memory_order_relaxed)) {
+                return __count;
+            }
+        }
+    }
+
+    void _M_publish(_Cell &__cell, size_type __seq) noexcept {
+        __cell._M_seq.store(__seq, std::memory_order_release);
+        __cell._M_seq.notify_all();
+    }
+
+    template <class... _Args>
+    void _M_fill(size_type __pos, _Args &&...__args) noexcept {
+        _Cell &__cell = _M_cell(__pos);
+        new (std::addressof(__cell._M_value))
+            _Tp(std::forward<_Args>(__args)...);
+        this->_M_publish(__cell, __pos + 1);
+    }
+
+    void _M_drain(size_type __pos, _Tp &__out) noexcept {
+        _Cell &__cell = _M_cell(__pos);
+        __out = std::move(__cell._M_value);
+        __cell._M_value.~_Tp();
+        this->_M_publish(__cell, __pos + _Capacity);
+    }
+
+    // 构造可能抛出异常时先在外面构造好再认领格子，免得认领后的格子永远不发布
+    template <class... _Args>
+    static constexpr bool _S_construct_in_place =
+        std::is_nothrow_constructible_v<_Tp, _Args...>;
+
+public:
+    mpmc_queue() noexcept {
+        for (size_type __i = 0; __i != _Capacity; ++__i) {
+            _M_cells[__i]._M_seq.store(__i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_queue(mpmc_queue &&) = delete;
+
+    mpmc_queue &operator=(mpmc_queue &&) = delete;
+
+    ~mpmc_queue() noexcept {
+        size_type __head = _M_head.load(std::memory_order_relaxed);
+        size_type __tail = _M_tail.load(std::memory_order_relaxed);
+        for (; __head != __tail; ++__head) {
+            _M_cell(__head)._M_value.~_Tp();
+        }
+    }
+
+    static constexpr size_type capacity() noexcept {
+        return _Capacity;
+    }
+
+    // 并发修改时只是一个近似值
+    size_type size() const noexcept {
+        size_type __head = _M_head.load(std::memory_order_relaxed);
+        size_type __tail = _M_tail.load(std::memory_order_relaxed);
+        return __tail > __head ? __tail - __head : 0;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return this->size() == 0;
+    }
+
+    template <class... _Args>
+    bool try_emplace(_Args &&...__args) {
+        if constexpr (_S_construct_in_place<_Args...>) {
+            size_type __pos, __seq;
+            if (!this->_M_claim<0>(_M_tail, 1, __pos, __seq)) {
+                return false;
+            }
+            this->_M_fill(__pos, std::forward<_Args>(__args)...);
+            return true;
+        } else {
+            _Tp __value(std::forward<_Args>(__args)...);
+            return this->try_emplace(std::move(__value));
+        }
+    }
+
+    bool try_push(const _Tp &__value) {
+        return this->try_emplace(__value);
+    }
+
+    bool try_push(_Tp &&__value) noexcept {
+        return this->try_emplace(std::move(__value));
+    }
+
+    bool try_pop(_Tp &__out) noexcept {
+        size_type __pos, __seq;
+        if (!this->_M_claim<1>(_M_head, 1, __pos, __seq)) {
+            return false;
+        }
+        this->_M_drain(__pos, __out);
+        return true;
+    }
+
+    // 满时在队尾格子的序号上阻塞，直到消费者把它腾出来
+    template <class... _Args>
+    void emplace(_Args &&...__args) {
+        if constexpr (_S_construct_in_place<_Args...>) {
+            size_type __pos, __seq;
+            while (!this->_M_claim<0>(_M_tail, 1, __pos, __seq)) {
+                _M_cell(__pos)._M_seq.wait(__seq, std::memory_order_acquire);
+            }
+            this->_M_fill(__pos, std::forward<_Args>(__args)...);
+        } else {
+            _Tp __value(std::forward<_Args>(__args)...);
+            this->emplace(std::move(__value));
+        }
+    }
+
+    void push(const _Tp &__value) {
+        this->emplace(__value);
+    }
+
+    void push(_Tp &&__value) noexcept {
+        this->emplace(std::move(__value));
+    }
+
+    // 空时在队首格子的序号上阻塞，直到生产者填入
+    void pop(_Tp &__out) noexcept {
+        size_type __pos, __seq;
+        while (!this->_M_claim<1>(_M_head, 1, __pos, __seq)) {
+            _M_cell(__pos)._M_seq.wait(__seq, std::memory_order_acquire);
+        }
+        this->_M_drain(__pos, __out);
+    }
+
+    // 一次 CAS 认领至多 __n 个连续空位，从 __first 开始的数组移入，
+    // 返回实际入队个数。只接受数组，保证认领之后的每一步都不会抛出异常
+    size_type try_push_n(_Tp *__first, size_type __n) noexcept {
+        size_type __pos, __seq;
+        size_type __count = this->_M_claim<0>(_M_tail, __n, __pos, __seq);
+        for (size_type __i = 0; __i != __count; ++__i) {
+            this->_M_fill(__pos + __i, std::move(__first[__i]));
+        }
+        return __count;
+    }
+
+    // 一次 CAS 认领至多 __n 个连续元素移到 __out 开始的数组，返回实际出队个数
+    size_type try_pop_n(_Tp *__out, size_type __n) noexcept {
+        size_type __pos, __seq;
+        size_type __count = this->_M_claim<1>(_M_head, __n, __pos, __seq);
+        for (size_type __i = 0; __i != __count; ++__i) {
+            this->_M_drain(__pos + __i, __out[__i]);
+        }
+        return __count;
+    }
+};
+
+} // namespace Marcus
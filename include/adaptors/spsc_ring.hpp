@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <common/_common.hpp>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace Marcus {
+
+// 单生产者单消费者环形缓冲：槽位里的对象常驻，生产者通过 reserve/commit
+// 直接在槽位上写消息，消费者通过 peek/release 原地读取，不发生拷贝。
+// 队首/队尾下标各自独占缓存行，双方再各缓存一份对方的下标，只有缓存的
+// 值不够用时才去读对方那条缓存行
+template <typename _Tp, std::size_t _Capacity>
+class spsc_ring {
+    static_assert(_Capacity >= 2 && (_Capacity & (_Capacity - 1)) == 0,
+                  "spsc_ring: capacity must be a power of two");
+    static_assert(std::is_default_constructible_v<_Tp>,
+                  "spsc_ring: slots are constructed up front");
+
+public:
+    using value_type = _Tp;
+    using size_type = std::size_t;
+
+private:
+    static constexpr size_type _S_mask = _Capacity - 1;
+
+    // 生产者独写
+    alignas(_LIBPENGCXX_CACHE_LINE) std::atomic<size_type> _M_tail{0};
+    size_type _M_head_cache = 0;
+    // 消费者独写
+    alignas(_LIBPENGCXX_CACHE_LINE) std::atomic<size_type> _M_head{0};
+    size_type _M_tail_cache = 0;
+    alignas(_LIBPENGCXX_CACHE_LINE) _Tp _M_slots[_Capacity]{};
+
+public:
+    spsc_ring() = default;
+
+    spsc_ring(spsc_ring &&) = delete;
+
+    spsc_ring &operator=(spsc_ring &&) = delete;
+
+    static constexpr size_type capacity() noexcept {
+        return _Capacity;
+    }
+
+    // 另一方并发操作时只是一个近似值。先读队首：队尾只增不减，
+    // 之后读到的队尾不会小于它
+    size_type size() const noexcept {
+        size_type __head = _M_head.load(std::memory_order_acquire);
+        return _M_tail.load(std::memory_order_acquire) - __head;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return this->size() == 0;
+    }
+
+    // 生产者：取得至多 __n 个连续的空槽位。回绕或空间不足时返回的
+    // 区间会更短，为空表示已满。写好后用 commit 发布
+    std::span<_Tp> reserve(size_type __n) noexcept {
+        size_type __tail = _M_tail.load(std::memory_order_relaxed);
+        size_type __free = _Capacity - (__tail - _M_head_cache);
+        if (__free < __n) {
+            _M_head_cache = _M_head.load(std::memory_order_acquire);
+            __free = _Capacity - (__tail - _M_head_cache);
+        }
+        size_type __index = __tail & _S_mask;
+        size_type __count = std::min({__n, __free, _Capacity - __index});
+        return {_M_slots + __index, __count};
+    }
+
+    // 生产者：发布 reserve 得到的区间的前 __n 个槽位
+    void commit(size_type __n) noexcept {
+        size_type __tail = _M_tail.load(std::memory_order_relaxed);
+        assert(__n <= _Capacity - (__tail - _M_head_cache));
+        _M_tail.store(__tail + __n, std::memory_order_release);
+    }
+
+    // 消费者：取得所有已发布且连续的槽位，为空表示没有消息
+    std::span<_Tp> peek() noexcept {
+        size_type __head = _M_head.load(std::memory_order_relaxed);
+        if (__head == _M_tail_cache) {
+            _M_tail_cache = _M_tail.load(std::memory_order_acquire);
+        }
+        size_type __index = __head & _S_mask;
+        size_type __count =
+            std::min(_M_tail_cache - __head, _Capacity - __index);
+        return {_M_slots + __index, __count};
+    }
+
+    // 消费者：归还 peek 得到的区间的前 __n 个槽位，之后不能再访问它们
+    void release(size_type __n) noexcept {
+        size_type __head = _M_head.load(std::memory_order_relaxed);
+        assert(__n <= _M_tail_cache - __head);
+        _M_head.store(__head + __n, std::memory_order_release);
+    }
+
+    template <typename _Up>
+    bool try_push(_Up &&__value) {
+        std::span<_Tp> __slots = this->reserve(1);
+        if (__slots.empty()) {
+            return false;
+        }
+        __slots[0] = std::forward<_Up>(__value);
+        this->commit(1);
+        return true;
+    }
+
+    bool try_pop(_Tp &__out) {
+        std::span<_Tp> __slots = this->peek();
+        if (__slots.empty()) {
+            return false;
+        }
+        __out = std::move(__slots[0]);
+        this->release(1);
+        return true;
+    }
+};
+
+} // namespace Marcus
@@ -10,6 +10,9 @@
 # include <compare>
 #endif
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
 
 #if __cpp_concepts && __cpp_lib_concepts
 # define _LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(__category, _Type) \
@@ -25,15 +28,22 @@
           class = typename _Compare##Tp::is_transparent, \
           class = \
               decltype(std::declval<bool &>() = std::declval<_Compare##Tp>()( \
-                           std::declval<_Tv>(), std::declval<_Tp>()) = \
-                           std::declval<_Compare##Tp>()(std::declval<_Tp>(), \
-                                                        std::declval<_Tv>()))
+                           std::declval<_Tv>(), std::declval<_Tp>()), \
+                       std::declval<bool &>() = std::declval<_Compare##Tp>()( \
+                           std::declval<_Tp>(), std::declval<_Tv>()))
+#define _LIBPENGCXX_REQUIRES_TRANSPARENT_HASH(_Hash, _KeyEqual) \
+    class _Hash##Tp = _Hash, class _KeyEqual##Tp = _KeyEqual, \
+          class = typename _Hash##Tp::is_transparent, \
+          class = typename _KeyEqual##Tp::is_transparent
 
 // #define _LIBPENGCXX_THROW_OUT_OF_RANGE(__i, __n) throw
 // std::runtime_error("out of range at index " + std::to_string(__i) + ", size "
 // + std::to_string(__n))
 #define _LIBPENGCXX_THROW_OUT_OF_RANGE(__i, __n) throw std::out_of_range("")
 
+// 并发容器按这个粒度隔开被不同线程写的字段，避免伪共享
+#define _LIBPENGCXX_CACHE_LINE 64
+
 #if defined(_MSC_VER)
 # define _LIBPENGCXX_UNREACHABLE() __assume(0)
 #elif defined(__clang__)
@@ -85,3 +95,54 @@
          return !(*this < __that); \
      }
 #endif
+
+namespace Marcus {
+
+// 可以用 memcpy 整体搬到别处、原处不再析构的类型。默认只认平凡可复制的
+// 类型，其他类型（例如只持有指针的句柄）可以特化为 true
+template <typename _Tp>
+struct is_trivially_relocatable : std::is_trivially_copyable<_Tp> {};
+
+template <typename _Tp>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<_Tp>::value;
+
+// 分配器的 deallocate 什么也不做（例如内存随 monotonic_arena 整体回收）时
+// 返回 true，容器销毁时就不必逐个归还节点。分配器通过成员函数
+// deallocate_is_noop() 声明这一点，没有这个成员的一律当作 false
+template <typename _Alloc>
+bool _deallocate_is_noop(const _Alloc &__alloc) noexcept {
+    if constexpr (requires { bool(__alloc.deallocate_is_noop()); }) {
+        return __alloc.deallocate_is_noop();
+    } else {
+        return false;
+    }
+}
+
+// 从 __first 起复制构造 __n 个元素到未初始化的 __dst，返回源的下一个位置。
+// 源是连续存放的同类型平凡可复制元素时整块 memcpy。中途抛异常时销毁已构造的
+template <typename _It, typename _Tp>
+_It _uninitialized_copy_n(_It __first, std::size_t __n, _Tp *__dst) {
+    if constexpr (std::contiguous_iterator<_It> &&
+                  std::is_same_v<std::iter_value_t<_It>, _Tp> &&
+                  std::is_trivially_copyable_v<_Tp>) {
+        if (__n != 0) {
+            std::memcpy(static_cast<void *>(__dst), std::to_address(__first),
+                        __n * sizeof(_Tp));
+        }
+        return __first + __n;
+    } else {
+        _Tp *__cur = __dst;
+        try {
+            for (; __n != 0; --__n, ++__first, ++__cur) {
+                std::construct_at(__cur, *__first);
+            }
+        } catch (...) {
+            std::destroy(__dst, __cur);
+            throw;
+        }
+        return __first;
+    }
+}
+
+} // namespace Marcus
@@ -0,0 +1,543 @@
+#pragma once
+
+#include <algorithm>
+#include <common/_common.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#if __cpp_lib_three_way_comparison
+# include <compare>
+#endif
+
+namespace Marcus {
+
+// 满了以后再插入时的行为
+enum class circular_buffer_mode {
+    bounded,          // 抛出 std::length_error
+    overwrite_oldest, // 丢掉另一端最旧的元素
+};
+
+// 按逻辑下标 (0 为队首) 访问的随机访问迭代器，解引用时才回绕到物理位置
+template <typename _Tp, typename _Ref, typename _Ptr>
+struct circular_buffer_iterator {
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = _Tp;
+    using difference_type = std::ptrdiff_t;
+    using pointer = _Ptr;
+    using reference = _Ref;
+
+    _Tp *_M_data = nullptr;
+    std::size_t _M_capacity = 0;
+    std::size_t _M_head = 0;
+    difference_type _M_index = 0;
+
+    circular_buffer_iterator() noexcept = default;
+
+    circular_buffer_iterator(_Tp *__data, std::size_t __capacity,
+                             std::size_t __head,
+                             difference_type __index) noexcept
+        : _M_data(__data),
+          _M_capacity(__capacity),
+          _M_head(__head),
+          _M_index(__index) {}
+
+    template <typename _OtherRef, typename _OtherPtr>
+    circular_buffer_iterator(
+        const circular_buffer_iterator<_Tp, _OtherRef, _OtherPtr>
+            &__other) noexcept
+        : _M_data(__other._M_data),
+          _M_capacity(__other._M_capacity),
+          _M_head(__other._M_head),
+          _M_index(__other._M_index) {}
+
+    reference operator*() const noexcept {
+        std::size_t __pos = _M_head + static_cast<std::size_t>(_M_index);
+        return _M_data[__pos >= _M_capacity ? __pos - _M_capacity : __pos];
+    }
+
+    pointer operator->() const noexcept {
+        return std::addressof(**this);
+    }
+
+    reference operator[](difference_type __n) const noexcept {
+        return *(*this + __n);
+    }
+
+    circular_buffer_iterator &operator++() noexcept {
+        ++_M_index;
+        return *this;
+    }
+
+    circular_buffer_iterator operator++(int) noexcept {
+        circular_buffer_iterator __temp = *this;
+        ++_M_index;
+        return __temp;
+    }
+
+    circular_buffer_iterator &operator--() noexcept {
+        --_M_index;
+        return *this;
+    }
+
+    circular_buffer_iterator operator--(int) noexcept {
+        circular_buffer_iterator __temp = *this;
+        --_M_index;
+        return __temp;
+    }
+
+    circular_buffer_iterator &operator+=(difference_type __n) noexcept {
+        _M_index += __n;
+        return *this;
+    }
+
+    circular_buffer_iterator &operator-=(difference_type __n) noexcept {
+        _M_index -= __n;
+        return *this;
+    }
+
+    circular_buffer_iterator operator+(difference_type __n) const noexcept {
+        circular_buffer_iterator __temp = *this;
+        return __temp += __n;
+    }
+
+    circular_buffer_iterator operator-(difference_type __n) const noexcept {
+        circular_buffer_iterator __temp = *this;
+        return __temp -= __n;
+    }
+
+    friend circular_buffer_iterator
+    operator+(difference_type __n,
+              const circular_buffer_iterator &__x) noexcept {
+        return __x + __n;
+    }
+
+    template <typename _OtherRef, typename _OtherPtr>
+    difference_type
+    operator-(const circular_buffer_iterator<_Tp, _OtherRef, _OtherPtr>
+                  &__other) const noexcept {
+        return _M_index - __other._M_index;
+    }
+
+    template <typename _OtherRef, typename _OtherPtr>
+    bool operator==(const circular_buffer_iterator<_Tp, _OtherRef, _OtherPtr>
+                        &__other) const noexcept {
+        return _M_index == __other._M_index;
+    }
+
+    template <typename _OtherRef, typename _OtherPtr>
+    auto operator<=>(const circular_buffer_iterator<_Tp, _OtherRef, _OtherPtr>
+                         &__other) const noexcept {
+        return _M_index <=> __other._M_index;
+    }
+};
+
+// 容量固定的双端环形缓冲区：所有元素放在一次分配的连续内存里，首尾下标
+// 回绕使用，插入删除不会移动元素也不会再分配。as_spans() 按逻辑顺序给出
+// 至多两段连续内存，可以直接交给按指针处理的循环
+template <typename _Tp, typename _Alloc = std::allocator<_Tp>>
+class circular_buffer {
+public:
+    using value_type = _Tp;
+    using allocator_type = _Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = _Tp &;
+    using const_reference = const _Tp &;
+    using pointer = _Tp *;
+    using const_pointer = const _Tp *;
+    using iterator = circular_buffer_iterator<_Tp, _Tp &, _Tp *>;
+    using const_iterator =
+        circular_buffer_iterator<_Tp, const _Tp &, const _Tp *>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    _Tp *_M_data = nullptr;
+    size_type _M_capacity = 0;
+    size_type _M_head = 0; // 队首的物理下标
+    size_type _M_size = 0;
+    circular_buffer_mode _M_mode = circular_buffer_mode::bounded;
+    [[no_unique_address]] _Alloc _M_alloc;
+
+    // __pos 不超过 2 * capacity，减一次就够，编译成条件传送而不是跳转
+    size_type _M_wrap(size_type __pos) const noexcept {
+        return __pos >= _M_capacity ? __pos - _M_capacity : __pos;
+    }
+
+    size_type _M_tail() const noexcept {
+        return _M_wrap(_M_head + _M_size);
+    }
+
+    size_type _M_before_head() const noexcept {
+        return _M_head == 0 ? _M_capacity - 1 : _M_head - 1;
+    }
+
+    [[noreturn]] static void _S_throw_full() {
+        throw std::length_error("circular_buffer: full");
+    }
+
+    // 满时用 __args 构造的新值顶替物理下标 __pos 处的元素
+    template <typename... _Args>
+    _Tp &_M_replace(size_type __pos, _Args &&...__args) {
+        if (_M_mode != circular_buffer_mode::overwrite_oldest ||
+            _M_capacity == 0) {
+            _S_throw_full();
+        }
+        _Tp __value(std::forward<_Args>(__args)...);
+        _Tp *__slot = _M_data + __pos;
+        if constexpr (std::is_move_assignable_v<_Tp>) {
+            *__slot = std::move(__value);
+        } else {
+            std::destroy_at(__slot);
+            std::construct_at(__slot, std::move(__value));
+        }
+        return *__slot;
+    }
+
+    // 按逻辑顺序把 __other 的元素复制到本对象 (必须为空) 的开头
+    void _M_copy_from(const circular_buffer &__other) {
+        auto [__a, __b] = __other.as_spans();
+        _Tp *__mid = std::uninitialized_copy(__a.begin(), __a.end(), _M_data);
+        try {
+            std::uninitialized_copy(__b.begin(), __b.end(), __mid);
+        } catch (...) {
+            std::destroy(_M_data, __mid);
+            throw;
+        }
+        _M_head = 0;
+        _M_size = __other._M_size;
+    }
+
+    void _M_reallocate(size_type __n) {
+        circular_buffer __temp(__n, _M_mode, _M_alloc);
+        size_type __drop = _M_size > __n ? _M_size - __n : 0;
+        for (iterator __it = begin() + __drop; __it != end(); ++__it) {
+            std::construct_at(__temp._M_data + __temp._M_size,
+                              std::move_if_noexcept(*__it));
+            ++__temp._M_size;
+        }
+        swap(__temp);
+    }
+
+    void _M_release() noexcept {
+        clear();
+        if (_M_data) {
+            _M_alloc.deallocate(_M_data, _M_capacity);
+            _M_data = nullptr;
+        }
+        _M_capacity = 0;
+    }
+
+public:
+    circular_buffer() noexcept = default;
+
+    explicit circular_buffer(
+        size_type __capacity,
+        circular_buffer_mode __mode = circular_buffer_mode::bounded,
+        const _Alloc &__alloc = _Alloc())
+        : _M_capacity(__capacity),
+          _M_mode(__mode),
+          _M_alloc(__alloc) {
+        if (__capacity != 0) {
+            _M_data = _M_alloc.allocate(__capacity);
+        }
+    }
+
+    // 容量取列表长度
+    circular_buffer(std::initializer_list<_Tp> __list,
+                    circular_buffer_mode __mode = circular_buffer_mode::bounded,
+                    const _Alloc &__alloc = _Alloc())
+        : circular_buffer(__list.size(), __mode, __alloc) {
+        std::uninitialized_copy(__list.begin(), __list.end(), _M_data);
+        _M_size = __list.size();
+    }
+
+    circular_buffer(const circular_buffer &__other)
+        : circular_buffer(__other._M_capacity, __other._M_mode,
+                          __other._M_alloc) {
+        _M_copy_from(__other);
+    }
+
+    circular_buffer(circular_buffer &&__other) noexcept
+        : _M_data(std::exchange(__other._M_data, nullptr)),
+          _M_capacity(std::exchange(__other._M_capacity, 0)),
+          _M_head(std::exchange(__other._M_head, 0)),
+          _M_size(std::exchange(__other._M_size, 0)),
+          _M_mode(__other._M_mode),
+          _M_alloc(std::move(__other._M_alloc)) {}
+
+    circular_buffer &operator=(const circular_buffer &__other) {
+        if (&__other == this) [[unlikely]] {
+            return *this;
+        }
+        circular_buffer __temp(__other);
+        swap(__temp);
+        return *this;
+    }
+
+    circular_buffer &operator=(circular_buffer &&__other) noexcept {
+        if (&__other == this) [[unlikely]] {
+            return *this;
+        }
+        _M_release();
+        _M_alloc = std::move(__other._M_alloc);
+        _M_data = std::exchange(__other._M_data, nullptr);
+        _M_capacity = std::exchange(__other._M_capacity, 0);
+        _M_head = std::exchange(__other._M_head, 0);
+        _M_size = std::exchange(__other._M_size, 0);
+        _M_mode = __other._M_mode;
+        return *this;
+    }
+
+    ~circular_buffer() noexcept {
+        _M_release();
+    }
+
+    void swap(circular_buffer &__other) noexcept {
+        std::swap(_M_data, __other._M_data);
+        std::swap(_M_capacity, __other._M_capacity);
+        std::swap(_M_head, __other._M_head);
+        std::swap(_M_size, __other._M_size);
+        std::swap(_M_mode, __other._M_mode);
+        std::swap(_M_alloc, __other._M_alloc);
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return _M_alloc;
+    }
+
+    circular_buffer_mode mode() const noexcept {
+        return _M_mode;
+    }
+
+    void set_mode(circular_buffer_mode __mode) noexcept {
+        _M_mode = __mode;
+    }
+
+    size_type size() const noexcept {
+        return _M_size;
+    }
+
+    size_type capacity() const noexcept {
+        return _M_capacity;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return _M_size == 0;
+    }
+
+    bool full() const noexcept {
+        return _M_size == _M_capacity;
+    }
+
+    static constexpr size_type max_size() noexcept {
+        return std::numeric_limits<size_type>::max() / sizeof(_Tp) / 2;
+    }
+
+    // 换成容量为 __n 的新缓冲区并把元素排成从头开始连续，放不下时
+    // 按 overwrite_oldest 的语义只保留最新的 __n 个
+    void set_capacity(size_type __n) {
+        if (__n != _M_capacity) {
+            _M_reallocate(__n);
+        }
+    }
+
+    // 让所有元素连续存放，返回首元素的指针。满时原地旋转，
+    // 未满时空槽里没有对象，不能参与旋转，改为搬到一块新缓冲区
+    _Tp *linearize() {
+        if (_M_head + _M_size > _M_capacity) {
+            if (_M_size == _M_capacity) {
+                std::rotate(_M_data, _M_data + _M_head, _M_data + _M_capacity);
+                _M_head = 0;
+            } else {
+                _M_reallocate(_M_capacity);
+            }
+        }
+        return _M_data + _M_head;
+    }
+
+    // 按逻辑顺序的两段连续内存，第二段只在回绕时非空
+    std::pair<std::span<_Tp>, std::span<_Tp>> as_spans() noexcept {
+        size_type __first = std::min(_M_size, _M_capacity - _M_head);
+        return {std::span<_Tp>(_M_data + _M_head, __first),
+                std::span<_Tp>(_M_data, _M_size - __first)};
+    }
+
+    std::pair<std::span<const _Tp>, std::span<const _Tp>>
+    as_spans() const noexcept {
+        size_type __first = std::min(_M_size, _M_capacity - _M_head);
+        return {std::span<const _Tp>(_M_data + _M_head, __first),
+                std::span<const _Tp>(_M_data, _M_size - __first)};
+    }
+
+    iterator begin() noexcept {
+        return iterator(_M_data, _M_capacity, _M_head, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(_M_data, _M_capacity, _M_head,
+                        static_cast<difference_type>(_M_size));
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_iterator(_M_data, _M_capacity, _M_head, 0);
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator(_M_data, _M_capacity, _M_head,
+                              static_cast<difference_type>(_M_size));
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    _Tp &operator[](size_type __i) noexcept {
+        return _M_data[_M_wrap(_M_head + __i)];
+    }
+
+    const _Tp &operator[](size_type __i) const noexcept {
+        return _M_data[_M_wrap(_M_head + __i)];
+    }
+
+    _Tp &at(size_type __i) {
+        if (__i >= _M_size) [[unlikely]] {
+            throw std::out_of_range("circular_buffer::at");
+        }
+        return (*this)[__i];
+    }
+
+    const _Tp &at(size_type __i) const {
+        if (__i >= _M_size) [[unlikely]] {
+            throw std::out_of_range("circular_buffer::at");
+        }
+        return (*this)[__i];
+    }
+
+    _Tp &front() noexcept {
+        return _M_data[_M_head];
+    }
+
+    const _Tp &front() const noexcept {
+        return _M_data[_M_head];
+    }
+
+    _Tp &back() noexcept {
+        return _M_data[_M_wrap(_M_head + _M_size - 1)];
+    }
+
+    const _Tp &back() const noexcept {
+        return _M_data[_M_wrap(_M_head + _M_size - 1)];
+    }
+
+    // 满时按模式抛异常或顶替队首：新值先构造到临时对象里，参数可以引用
+    // 将被顶替的元素，构造抛异常时缓冲区也不变
+    template <typename... _Args>
+    _Tp &emplace_back(_Args &&...__args) {
+        if (_M_size == _M_capacity) [[unlikely]] {
+            _Tp &__slot = _M_replace(_M_head, std::forward<_Args>(__args)...);
+            _M_head = _M_wrap(_M_head + 1);
+            return __slot;
+        }
+        _Tp *__p = _M_data + _M_tail();
+        std::construct_at(__p, std::forward<_Args>(__args)...);
+        ++_M_size;
+        return *__p;
+    }
+
+    // 满时按模式抛异常或顶替队尾，方式同 emplace_back
+    template <typename... _Args>
+    _Tp &emplace_front(_Args &&...__args) {
+        if (_M_size == _M_capacity) [[unlikely]] {
+            size_type __pos = _M_before_head();
+            _Tp &__slot = _M_replace(__pos, std::forward<_Args>(__args)...);
+            _M_head = __pos;
+            return __slot;
+        }
+        size_type __pos = _M_before_head();
+        std::construct_at(_M_data + __pos, std::forward<_Args>(__args)...);
+        _M_head = __pos;
+        ++_M_size;
+        return _M_data[__pos];
+    }
+
+    void push_back(const _Tp &__value) {
+        emplace_back(__value);
+    }
+
+    void push_back(_Tp &&__value) {
+        emplace_back(std::move(__value));
+    }
+
+    void push_front(const _Tp &__value) {
+        emplace_front(__value);
+    }
+
+    void push_front(_Tp &&__value) {
+        emplace_front(std::move(__value));
+    }
+
+    void pop_front() noexcept {
+        std::destroy_at(_M_data + _M_head);
+        _M_head = _M_wrap(_M_head + 1);
+        --_M_size;
+    }
+
+    void pop_back() noexcept {
+        --_M_size;
+        std::destroy_at(_M_data + _M_tail());
+    }
+
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<_Tp>) {
+            auto [__a, __b] = as_spans();
+            std::destroy(__a.begin(), __a.end());
+            std::destroy(__b.begin(), __b.end());
+        }
+        _M_head = 0;
+        _M_size = 0;
+    }
+
+    _LIBPENGCXX_DEFINE_COMPARISON(circular_buffer);
+};
+
+template <typename _Tp, typename _Alloc>
+void swap(circular_buffer<_Tp, _Alloc> &__lhs,
+          circular_buffer<_Tp, _Alloc> &__rhs) noexcept {
+    __lhs.swap(__rhs);
+}
+
+} // namespace Marcus
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <common/_common.hpp>
+#include <containers/map.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+
+namespace Marcus {
+
+// 按键的哈希把键空间分到 _Shards 个 map 上，每个分片各有一把读写锁，
+// 不同分片上的操作互不阻塞。元素只能通过回调在锁内访问，不提供迭代器
+template <typename _Key, typename _Mapped, typename _Compare = std::less<_Key>,
+          typename _Hash = std::hash<_Key>, std::size_t _Shards = 64,
+          typename _Alloc = std::allocator<std::pair<const _Key, _Mapped>>>
+struct concurrent_map {
+    static_assert(_Shards != 0 && (_Shards & (_Shards - 1)) == 0,
+                  "concurrent_map: shard count must be a power of two");
+
+    using key_type = _Key;
+    using mapped_type = _Mapped;
+    using value_type = std::pair<const _Key, _Mapped>;
+    using size_type = std::size_t;
+    using map_type = map<_Key, _Mapped, _Compare, _Alloc>;
+
+private:
+    // 每个分片独占缓存行，避免相邻分片的锁互相伪共享
+    struct alignas(_LIBPENGCXX_CACHE_LINE) _Shard {
+        mutable std::shared_mutex _M_mutex;
+        map_type _M_map;
+    };
+
+    _Shard _M_shards[_Shards];
+    [[no_unique_address]] _Hash _M_hash;
+
+    // std::hash 对整数是恒等映射，先把高位搅进低位再取分片号
+    _Shard &_M_shard_of(const _Key &__key) const noexcept {
+        std::uint64_t __h = _M_hash(__key);
+        __h ^= __h >> 33;
+        __h *= 0xff51afd7ed558ccdull;
+        __h ^= __h >> 33;
+        return const_cast<_Shard &>(_M_shards[__h & (_Shards - 1)]);
+    }
+
+public:
+    concurrent_map() = default;
+
+    explicit concurrent_map(const _Hash &__hash) : _M_hash(__hash) {}
+
+    // 锁不可移动，整个容器也不可复制或移动
+    concurrent_map(concurrent_map &&) = delete;
+
+    concurrent_map &operator=(concurrent_map &&) = delete;
+
+    static constexpr size_type shard_count() noexcept {
+        return _Shards;
+    }
+
+    // 找到时在共享锁下调用 __f(const _Mapped &)，返回是否找到
+    template <typename _Fn>
+    bool find_and_apply(const _Key &__key, _Fn &&__f) const {
+        _Shard &__shard = _M_shard_of(__key);
+        std::shared_lock __lock(__shard._M_mutex);
+        auto __it = __shard._M_map.find(__key);
+        if (__it == __shard._M_map.end()) {
+            return false;
+        }
+        __f(static_cast<const _Mapped &>(__it->second));
+        return true;
+    }
+
+    // 键已存在时在独占锁下调用 __f(_Mapped &)，否则用 __mapped 构造新值；
+    // 返回是否插入了新元素
+    template <typename _Fn, typename... _Ms>
+    bool upsert(const _Key &__key, _Fn &&__f, _Ms &&...__mapped) {
+        _Shard &__shard = _M_shard_of(__key);
+        std::unique_lock __lock(__shard._M_mutex);
+        auto __result = __shard._M_map.try_emplace(
+            __key, std::forward<_Ms>(__mapped)...);
+        if (!__result.second) {
+            __f(__result.first->second);
+        }
+        return __result.second;
+    }
+
+    template <typename... _Ms>
+    bool try_emplace(const _Key &__key, _Ms &&...__mapped) {
+        _Shard &__shard = _M_shard_of(__key);
+        std::unique_lock __lock(__shard._M_mutex);
+        return __shard._M_map.try_emplace(__key, std::forward<_Ms>(__mapped)...)
+            .second;
+    }
+
+    template <typename _Mp>
+    bool insert_or_assign(const _Key &__key, _Mp &&__mapped) {
+        _Shard &__shard = _M_shard_of(__key);
+        std::unique_lock __lock(__shard._M_mutex);
+        return __shard._M_map
+            .insert_or_assign(__key, std::forward<_Mp>(__mapped))
+            .second;
+    }
+
+    // 找到且 __pred(_Mapped &) 为真时删除，判断与删除在同一把锁内完成
+    template <typename _Pred>
+    bool erase_if(const _Key &__key, _Pred &&__pred) {
+        _Shard &__shard = _M_shard_of(__key);
+        std::unique_lock __lock(__shard._M_mutex);
+        auto __it = __shard._M_map.find(__key);
+        if (__it == __shard._M_map.end() || !__pred(__it->second)) {
+            return false;
+        }
+        __shard._M_map.erase(__it);
+        return true;
+    }
+
+    // 逐个分片删除 __pred(const value_type &) 为真的元素，返回删除个数；
+    // 整体上不是原子的，其他线程能看到只清理了一部分分片的状态
+    template <typename _Pred>
+    size_type erase_if(_Pred &&__pred) {
+        size_type __num = 0;
+        for (_Shard &__shard: _M_shards) {
+            std::unique_lock __lock(__shard._M_mutex);
+            auto __it = __shard._M_map.begin();
+            while (__it != __shard._M_map.end()) {
+                if (__pred(static_cast<const value_type &>(*__it))) {
+                    __it = __shard._M_map.erase(__it);
+                    ++__num;
+                } else {
+                    ++__it;
+                }
+            }
+        }
+        return __num;
+    }
+
+    bool erase(const _Key &__key) {
+        return this->erase_if(__key, [](const _Mapped &) {
+            return true;
+        });
+    }
+
+    bool contains(const _Key &__key) const {
+        _Shard &__shard = _M_shard_of(__key);
+        std::shared_lock __lock(__shard._M_mutex);
+        return __shard._M_map.contains(__key);
+    }
+
+    // 逐个分片在共享锁下调用 __f(const value_type &)，同一分片内按键有序
+    template <typename _Fn>
+    void for_each(_Fn &&__f) const {
+        for (const _Shard &__shard: _M_shards) {
+            std::shared_lock __lock(__shard._M_mutex);
+            for (const value_type &__value: __shard._M_map) {
+                __f(__value);
+            }
+        }
+    }
+
+    // 并发修改时只是一个近似值
+    size_type size() const {
+        size_type __size = 0;
+        for (const _Shard &__shard: _M_shards) {
+            std::shared_lock __lock(__shard._M_mutex);
+            __size += __shard._M_map.size();
+        }
+        return __size;
+    }
+
+    bool empty() const {
+        return this->size() == 0;
+    }
+
+    void clear() {
+        for (_Shard &__shard: _M_shards) {
+            std::unique_lock __lock(__shard._M_mutex);
+            __shard._M_map.clear();
+        }
+    }
+};
+
+} // namespace Marcus
@@ -0,0 +1,940 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <common/_common.hpp>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// B 树节点的目标大小（4 个缓存行），节点内的值连续存放
+inline constexpr size_t _BTreeNodeTargetBytes = 256;
+
+template <class _Tp>
+struct _BTreeNode {
+    static constexpr size_t _S_header_bytes =
+        sizeof(void *) + 2 * sizeof(unsigned short) + sizeof(bool);
+    static constexpr size_t _S_slots = std::max<size_t>(
+        3, (_BTreeNodeTargetBytes - _S_header_bytes) / sizeof(_Tp));
+
+    static_assert(_S_slots <= 0xffff);
+
+    _BTreeNode *_M_parent;
+    unsigned short _M_position; // 本节点在父节点 _M_children 中的下标
+    unsigned short _M_count;    // 节点中值的个数
+    bool _M_leaf;
+
+    union {
+        _Tp _M_values[_S_slots];
+    }; // 和 _RbTreeNodeImpl 一样，用 union 阻止自动构造
+
+    _BTreeNode() noexcept {}
+
+    ~_BTreeNode() noexcept {}
+};
+
+template <class _Tp>
+struct _BTreeInternalNode : _BTreeNode<_Tp> {
+    _BTreeNode<_Tp> *_M_children[_BTreeNode<_Tp>::_S_slots + 1];
+};
+
+template <class _Tp>
+inline _BTreeNode<_Tp> *&_BTreeChild(_BTreeNode<_Tp> *__node,
+                                     size_t __i) noexcept {
+    assert(!__node->_M_leaf);
+    return static_cast<_BTreeInternalNode<_Tp> *>(__node)->_M_children[__i];
+}
+
+// 迭代器是 (节点, 下标) 对；end() 是 (最右叶子, 最右叶子的元素个数)
+template <class _Tp, class _Vp>
+struct _BTreeIterator {
+protected:
+    using _Node = _BTreeNode<_Tp>;
+
+    _Node *_M_node;
+    size_t _M_pos;
+
+    template <class, class, class>
+    friend struct _BTreeImpl;
+
+    template <class, class>
+    friend struct _BTreeIterator;
+
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::remove_const_t<_Vp>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = _Vp *;
+    using reference = _Vp &;
+
+    _BTreeIterator() noexcept : _M_node(nullptr), _M_pos(0) {}
+
+    _BTreeIterator(_Node *__node, size_t __pos) noexcept
+        : _M_node(__node),
+          _M_pos(__pos) {}
+
+    template <class _Up,
+              class = std::enable_if_t<std::is_same_v<const _Up, _Vp> &&
+                                       !std::is_same_v<_Up, _Vp>>>
+    _BTreeIterator(const _BTreeIterator<_Tp, _Up> &__that) noexcept
+        : _M_node(__that._M_node),
+          _M_pos(__that._M_pos) {}
+
+    bool operator==(const _BTreeIterator &__that) const noexcept {
+        return _M_node == __that._M_node && _M_pos == __that._M_pos;
+    }
+
+    bool operator!=(const _BTreeIterator &__that) const noexcept {
+        return !(*this == __that);
+    }
+
+    _Vp &operator*() const noexcept {
+        assert(_M_pos < _M_node->_M_count);
+        return _M_node->_M_values[_M_pos];
+    }
+
+    _Vp *operator->() const noexcept {
+        return std::addressof(**this);
+    }
+
+    _BTreeIterator &operator++() noexcept { // ++__it
+        if (!_M_node->_M_leaf) {
+            // 后继是右子树中最左的叶子
+            _M_node = _BTreeChild(_M_node, _M_pos + 1);
+            while (!_M_node->_M_leaf) {
+                _M_node = _BTreeChild(_M_node, 0);
+            }
+            _M_pos = 0;
+            return *this;
+        }
+        if (++_M_pos < _M_node->_M_count) {
+            return *this;
+        }
+        // 叶子已经走完，回溯到第一个还有剩余值的祖先
+        _Node *__node = _M_node;
+        size_t __pos = _M_pos;
+        while (__node->_M_parent != nullptr && __pos == __node->_M_count) {
+            __pos = __node->_M_position;
+            __node = __node->_M_parent;
+        }
+        if (__pos != __node->_M_count) {
+            _M_node = __node;
+            _M_pos = __pos;
+        } // 否则停留在 (最右叶子, _M_count)，即 end()
+        return *this;
+    }
+
+    _BTreeIterator &operator--() noexcept { // --__it
+        if (!_M_node->_M_leaf) {
+            // 前驱是左子树中最右的叶子
+            _M_node = _BTreeChild(_M_node, _M_pos);
+            while (!_M_node->_M_leaf) {
+                _M_node = _BTreeChild(_M_node, _M_node->_M_count);
+            }
+            _M_pos = _M_node->_M_count - 1;
+            return *this;
+        }
+        if (_M_pos > 0) {
+            --_M_pos;
+            return *this;
+        }
+        _Node *__node = _M_node;
+        size_t __pos = 0;
+        while (__node->_M_parent != nullptr && __pos == 0) {
+            __pos = __node->_M_position;
+            __node = __node->_M_parent;
+        }
+        assert(__pos != 0); // --begin()
+        _M_node = __node;
+        _M_pos = __pos - 1;
+        return *this;
+    }
+
+    _BTreeIterator operator++(int) noexcept { // __it++
+        _BTreeIterator __tmp = *this;
+        ++*this;
+        return __tmp;
+    }
+
+    _BTreeIterator operator--(int) noexcept { // __it--
+        _BTreeIterator __tmp = *this;
+        --*this;
+        return __tmp;
+    }
+};
+
+// 搬移 pair<const K, V> 时按 pair<K, V> 取出源值，键被移动而不是复制
+template <class _Tp>
+struct _BTreeMovable {
+    using type = _Tp;
+};
+
+template <class _Key, class _Mapped>
+struct _BTreeMovable<std::pair<const _Key, _Mapped>> {
+    using type = std::pair<_Key, _Mapped>;
+};
+
+// 以 B 树实现的有序容器，每个节点容纳 _S_slots 个值
+// 插入和删除会在节点之间搬移值，因此会使所有迭代器失效
+template <class _Tp, class _Compare, class _Alloc>
+struct _BTreeImpl {
+protected:
+    using _Node = _BTreeNode<_Tp>;
+    using _Internal = _BTreeInternalNode<_Tp>;
+    using _Value = std::remove_const_t<_Tp>;
+    using _Movable = typename _BTreeMovable<_Value>::type;
+
+    static constexpr size_t _S_slots = _Node::_S_slots;
+    static constexpr size_t _S_min_count = _S_slots / 2;
+
+    // 可以直接 memmove 的值类型，省去逐个移动构造和析构
+    static constexpr bool _S_trivially_relocatable =
+        std::is_trivially_copy_constructible_v<_Value> &&
+        std::is_trivially_destructible_v<_Value>;
+
+    _Node *_M_root;
+    _Node *_M_leftmost;
+    _Node *_M_rightmost;
+    size_t _M_size;
+    [[no_unique_address]] _Compare _M_comp;
+    [[no_unique_address]] _Alloc _M_alloc;
+
+    template <class... _Ts>
+    static void _S_construct(_Tp *__ptr, _Ts &&...__value) noexcept(
+        std::is_nothrow_constructible_v<_Tp, _Ts...>) {
+        ::new (const_cast<_Value *>(__ptr)) _Tp(std::forward<_Ts>(__value)...);
+    }
+
+    static void _S_destroy(_Tp *__ptr) noexcept {
+        __ptr->~_Tp();
+    }
+
+    static _Movable &&_S_movable(_Tp *__ptr) noexcept {
+        return std::move(*std::launder(
+            reinterpret_cast<_Movable *>(const_cast<_Value *>(__ptr))));
+    }
+
+    // 把 [__src, __src + __n) 搬到 __dst，两段区间可以重叠；搬走后源位置视为已析构。
+    // 分裂和合并节点时搬到一半无法回滚，所以搬移本身不能抛异常
+    static void _S_relocate(_Tp *__dst, _Tp *__src, size_t __n) noexcept {
+        static_assert(_S_trivially_relocatable ||
+                          std::is_nothrow_constructible_v<_Tp, _Movable &&>,
+                      "B-tree values must be nothrow move constructible "
+                      "(keys of a map are moved as if not const)");
+        if (__n == 0 || __dst == __src) {
+            return;
+        }
+        if constexpr (_S_trivially_relocatable) {
+            std::memmove(static_cast<void *>(const_cast<_Value *>(__dst)),
+                         static_cast<const void *>(__src), __n * sizeof(_Tp));
+        } else if (__dst < __src) {
+            for (size_t __i = 0; __i != __n; ++__i) {
+                _BTreeImpl::_S_construct(__dst + __i,
+                                         _BTreeImpl::_S_movable(__src + __i));
+                _BTreeImpl::_S_destroy(__src + __i);
+            }
+        } else {
+            for (size_t __i = __n; __i != 0; --__i) {
+                _BTreeImpl::_S_construct(
+                    __dst + __i - 1, _BTreeImpl::_S_movable(__src + __i - 1));
+                _BTreeImpl::_S_destroy(__src + __i - 1);
+            }
+        }
+    }
+
+    template <class _NodeType>
+    _NodeType *_M_allocate_node(bool __leaf) {
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<_NodeType>
+            __node_alloc(_M_alloc);
+        _NodeType *__node =
+            std::allocator_traits<decltype(__node_alloc)>::allocate(
+                __node_alloc, 1);
+        ::new (static_cast<void *>(__node)) _NodeType();
+        __node->_M_parent = nullptr;
+        __node->_M_position = 0;
+        __node->_M_count = 0;
+        __node->_M_leaf = __leaf;
+        return __node;
+    }
+
+    template <class _NodeType>
+    void _M_deallocate_node(_Node *__node) noexcept {
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<_NodeType>
+            __node_alloc(_M_alloc);
+        static_cast<_NodeType *>(__node)->~_NodeType();
+        std::allocator_traits<decltype(__node_alloc)>::deallocate(
+            __node_alloc, static_cast<_NodeType *>(__node), 1);
+    }
+
+    _Node *_M_new_node(bool __leaf) {
+        return __leaf ? this->_M_allocate_node<_Node>(true)
+                      : this->_M_allocate_node<_Internal>(false);
+    }
+
+    void _M_free_node(_Node *__node) noexcept {
+        if (__node->_M_leaf) {
+            this->_M_deallocate_node<_Node>(__node);
+        } else {
+            this->_M_deallocate_node<_Internal>(__node);
+        }
+    }
+
+    static void _S_set_child(_Node *__parent, size_t __i,
+                             _Node *__child) noexcept {
+        _BTreeChild(__parent, __i) = __child;
+        __child->_M_parent = __parent;
+        __child->_M_position = static_cast<unsigned short>(__i);
+    }
+
+    void _M_destroy_subtree(_Node *__node) noexcept {
+        if (!std::is_trivially_destructible_v<_Value>) {
+            for (size_t __i = 0; __i != __node->_M_count; ++__i) {
+                _BTreeImpl::_S_destroy(__node->_M_values + __i);
+            }
+        }
+        if (!__node->_M_leaf) {
+            for (size_t __i = 0; __i <= __node->_M_count; ++__i) {
+                this->_M_destroy_subtree(_BTreeChild(__node, __i));
+            }
+        }
+        this->_M_free_node(__node);
+    }
+
+    _Node *_M_clone_subtree(const _Node *__src, _Node *__parent,
+                            size_t __position) {
+        _Node *__node = this->_M_new_node(__src->_M_leaf);
+        __node->_M_parent = __parent;
+        __node->_M_position = static_cast<unsigned short>(__position);
+        if (__parent != nullptr) {
+            _BTreeChild(__parent, __position) = __node;
+        }
+        // 抛异常时本层只清理自己复制好的部分，更深的层已经各自清理过
+        size_t __cloned = 0;
+        try {
+            for (size_t __i = 0; __i != __src->_M_count; ++__i) {
+                _BTreeImpl::_S_construct(__node->_M_values + __i,
+                                         __src->_M_values[__i]);
+                ++__node->_M_count;
+            }
+            if (!__src->_M_leaf) {
+                for (; __cloned <= __src->_M_count; ++__cloned) {
+                    this->_M_clone_subtree(
+                        _BTreeChild(const_cast<_Node *>(__src), __cloned),
+                        __node, __cloned);
+                }
+            }
+        } catch (...) {
+            for (size_t __i = 0; __i != __cloned; ++__i) {
+                this->_M_destroy_subtree(_BTreeChild(__node, __i));
+            }
+            for (size_t __i = 0; __i != __node->_M_count; ++__i) {
+                _BTreeImpl::_S_destroy(__node->_M_values + __i);
+            }
+            this->_M_free_node(__node);
+            throw;
+        }
+        return __node;
+    }
+
+    void _M_update_extremes() noexcept {
+        _M_leftmost = _M_rightmost = _M_root;
+        if (_M_root == nullptr) {
+            return;
+        }
+        while (!_M_leftmost->_M_leaf) {
+            _M_leftmost = _BTreeChild(_M_leftmost, 0);
+        }
+        while (!_M_rightmost->_M_leaf) {
+            _M_rightmost = _BTreeChild(_M_rightmost, _M_rightmost->_M_count);
+        }
+    }
+
+public:
+    _BTreeImpl() noexcept
+        : _M_root(nullptr),
+          _M_leftmost(nullptr),
+          _M_rightmost(nullptr),
+          _M_size(0) {}
+
+    explicit _BTreeImpl(_Compare __comp) noexcept
+        : _M_root(nullptr),
+          _M_leftmost(nullptr),
+          _M_rightmost(nullptr),
+          _M_size(0),
+          _M_comp(__comp) {}
+
+    explicit _BTreeImpl(_Alloc __alloc, _Compare __comp = _Compare()) noexcept
+        : _M_root(nullptr),
+          _M_leftmost(nullptr),
+          _M_rightmost(nullptr),
+          _M_size(0),
+          _M_comp(__comp),
+          _M_alloc(__alloc) {}
+
+    _BTreeImpl(const _BTreeImpl &__that)
+        : _M_root(nullptr),
+          _M_size(__that._M_size),
+          _M_comp(__that._M_comp),
+          _M_alloc(__that._M_alloc) {
+        if (__that._M_root != nullptr) {
+            _M_root = this->_M_clone_subtree(__that._M_root, nullptr, 0);
+        }
+        this->_M_update_extremes();
+    }
+
+    _BTreeImpl(_BTreeImpl &&__that) noexcept
+        : _M_root(__that._M_root),
+          _M_leftmost(__that._M_leftmost),
+          _M_rightmost(__that._M_rightmost),
+          _M_size(__that._M_size),
+          _M_comp(__that._M_comp),
+          _M_alloc(__that._M_alloc) {
+        __that._M_root = __that._M_leftmost = __that._M_rightmost = nullptr;
+        __that._M_size = 0;
+    }
+
+    _BTreeImpl &operator=(_BTreeImpl &&__that) noexcept {
+        std::swap(_M_root, __that._M_root);
+        std::swap(_M_leftmost, __that._M_leftmost);
+        std::swap(_M_rightmost, __that._M_rightmost);
+        std::swap(_M_size, __that._M_size);
+        std::swap(_M_comp, __that._M_comp);
+        std::swap(_M_alloc, __that._M_alloc);
+        return *this;
+    }
+
+    _BTreeImpl &operator=(const _BTreeImpl &__that) {
+        if (&__that != this) {
+            _BTreeImpl __tmp(__that);
+            *this = std::move(__tmp);
+        }
+        return *this;
+    }
+
+    ~_BTreeImpl() noexcept {
+        this->clear();
+    }
+
+    using iterator = _BTreeIterator<_Tp, _Tp>;
+    using const_iterator = _BTreeIterator<_Tp, const _Tp>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+protected:
+    template <class _Tv>
+    size_t _M_node_lower_bound(const _Node *__node,
+                               const _Tv &__value) const noexcept {
+        size_t __lo = 0;
+        size_t __hi = __node->_M_count;
+        while (__lo < __hi) {
+            size_t __mid = (__lo + __hi) / 2;
+            if (_M_comp(__node->_M_values[__mid], __value)) {
+                __lo = __mid + 1;
+            } else {
+                __hi = __mid;
+            }
+        }
+        return __lo;
+    }
+
+    template <class _Tv>
+    size_t _M_node_upper_bound(const _Node *__node,
+                               const _Tv &__value) const noexcept {
+        size_t __lo = 0;
+        size_t __hi = __node->_M_count;
+        while (__lo < __hi) {
+            size_t __mid = (__lo + __hi) / 2;
+            if (_M_comp(__value, __node->_M_values[__mid])) {
+                __hi = __mid;
+            } else {
+                __lo = __mid + 1;
+            }
+        }
+        return __lo;
+    }
+
+    template <class _Tv>
+    iterator _M_find_it(const _Tv &__value) const noexcept {
+        _Node *__node = _M_root;
+        while (__node != nullptr) {
+            size_t __i = this->_M_node_lower_bound(__node, __value);
+            if (__i != __node->_M_count &&
+                !_M_comp(__value, __node->_M_values[__i])) {
+                return {__node, __i};
+            }
+            if (__node->_M_leaf) {
+                break;
+            }
+            __node = _BTreeChild(__node, __i);
+        }
+        return this->_M_end();
+    }
+
+    template <class _Tv>
+    iterator _M_lower_bound_it(const _Tv &__value) const noexcept {
+        _Node *__node = _M_root;
+        iterator __result = this->_M_end();
+        while (__node != nullptr) {
+            size_t __i = this->_M_node_lower_bound(__node, __value);
+            if (__i != __node->_M_count) {
+                __result = {__node, __i};
+            }
+            if (__node->_M_leaf) {
+                break;
+            }
+            __node = _BTreeChild(__node, __i);
+        }
+        return __result;
+    }
+
+    template <class _Tv>
+    iterator _M_upper_bound_it(const _Tv &__value) const noexcept {
+        _Node *__node = _M_root;
+        iterator __result = this->_M_end();
+        while (__node != nullptr) {
+            size_t __i = this->_M_node_upper_bound(__node, __value);
+            if (__i != __node->_M_count) {
+                __result = {__node, __i};
+            }
+            if (__node->_M_leaf) {
+                break;
+            }
+            __node = _BTreeChild(__node, __i);
+        }
+        return __result;
+    }
+
+    iterator _M_end() const noexcept {
+        return _M_rightmost == nullptr
+                   ? iterator()
+                   : iterator(_M_rightmost, _M_rightmost->_M_count);
+    }
+
+    // 把已满的 __node 一分为二，中间值上移到父节点，返回新的右兄弟
+    _Node *_M_split(_Node *__node) {
+        _Node *__parent = __node->_M_parent;
+        if (__parent == nullptr) {
+            __parent = this->_M_new_node(false);
+            _BTreeImpl::_S_set_child(__parent, 0, __node);
+            _M_root = __parent;
+        } else if (__parent->_M_count == _S_slots) {
+            this->_M_split(__parent);
+            __parent = __node->_M_parent;
+        }
+        _Node *__sibling = this->_M_new_node(__node->_M_leaf);
+        size_t __mid = _S_slots / 2;
+        size_t __moved = __node->_M_count - __mid - 1;
+        _BTreeImpl::_S_relocate(__sibling->_M_values,
+                                __node->_M_values + __mid + 1, __moved);
+        __sibling->_M_count = static_cast<unsigned short>(__moved);
+        if (!__node->_M_leaf) {
+            for (size_t __i = 0; __i <= __moved; ++__i) {
+                _BTreeImpl::_S_set_child(
+                    __sibling, __i, _BTreeChild(__node, __mid + 1 + __i));
+            }
+        }
+        size_t __at = __node->_M_position;
+        _BTreeImpl::_S_relocate(__parent->_M_values + __at + 1,
+                                __parent->_M_values + __at,
+                                __parent->_M_count - __at);
+        _BTreeImpl::_S_relocate(__parent->_M_values + __at,
+                                __node->_M_values + __mid, 1);
+        for (size_t __i = __parent->_M_count; __i != __at; --__i) {
+            _BTreeImpl::_S_set_child(__parent, __i + 1,
+                                     _BTreeChild(__parent, __i));
+        }
+        _BTreeImpl::_S_set_child(__parent, __at + 1, __sibling);
+        ++__parent->_M_count;
+        __node->_M_count = static_cast<unsigned short>(__mid);
+        if (_M_rightmost == __node) {
+            _M_rightmost = __sibling;
+        }
+        return __sibling;
+    }
+
+    // 把 *__value 搬到叶子 __leaf 的 __pos 处，必要时先分裂
+    iterator _M_insert_leaf(_Node *__leaf, size_t __pos, _Tp *__value) {
+        if (__leaf->_M_count == _S_slots) {
+            _Node *__sibling = this->_M_split(__leaf);
+            if (__pos > __leaf->_M_count) {
+                __pos -= __leaf->_M_count + 1;
+                __leaf = __sibling;
+            }
+        }
+        _BTreeImpl::_S_relocate(__leaf->_M_values + __pos + 1,
+                                __leaf->_M_values + __pos,
+                                __leaf->_M_count - __pos);
+        _BTreeImpl::_S_relocate(__leaf->_M_values + __pos, __value, 1);
+        ++__leaf->_M_count;
+        ++_M_size;
+        return {__leaf, __pos};
+    }
+
+    template <class... _Ts>
+    std::pair<iterator, bool> _M_single_emplace(_Ts &&...__value) {
+        alignas(_Tp) unsigned char __buffer[sizeof(_Tp)];
+        _Tp *__tmp = reinterpret_cast<_Tp *>(__buffer);
+        _BTreeImpl::_S_construct(__tmp, std::forward<_Ts>(__value)...);
+        if (_M_root == nullptr) {
+            try {
+                _M_root = _M_leftmost = _M_rightmost = this->_M_new_node(true);
+            } catch (...) {
+                _BTreeImpl::_S_destroy(__tmp);
+                throw;
+            }
+        }
+        _Node *__node = _M_root;
+        while (true) {
+            size_t __i = this->_M_node_lower_bound(__node, *__tmp);
+            if (__i != __node->_M_count &&
+                !_M_comp(*__tmp, __node->_M_values[__i])) {
+                _BTreeImpl::_S_destroy(__tmp);
+                return {iterator(__node, __i), false};
+            }
+            if (__node->_M_leaf) {
+                try {
+                    return {this->_M_insert_leaf(__node, __i, __tmp), true};
+                } catch (...) {
+                    _BTreeImpl::_S_destroy(__tmp);
+                    throw;
+                }
+            }
+            __node = _BTreeChild(__node, __i);
+        }
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    void _M_single_insert(_InputIt __first, _InputIt __last) {
+        while (__first != __last) {
+            this->_M_single_emplace(*__first);
+            ++__first;
+        }
+    }
+
+    // 从左兄弟借一个值：父节点的分隔值下移到 __node，左兄弟的最大值上移
+    void _M_borrow_left(_Node *__left, _Node *__node, size_t __sep,
+                        iterator &__track) noexcept {
+        _Node *__parent = __node->_M_parent;
+        size_t __last = __left->_M_count - 1;
+        _BTreeImpl::_S_relocate(__node->_M_values + 1, __node->_M_values,
+                                __node->_M_count);
+        _BTreeImpl::_S_relocate(__node->_M_values,
+                                __parent->_M_values + __sep, 1);
+        _BTreeImpl::_S_relocate(__parent->_M_values + __sep,
+                                __left->_M_values + __last, 1);
+        if (!__node->_M_leaf) {
+            for (size_t __i = __node->_M_count + 1; __i != 0; --__i) {
+                _BTreeImpl::_S_set_child(__node, __i,
+                                         _BTreeChild(__node, __i - 1));
+            }
+            _BTreeImpl::_S_set_child(__node, 0,
+                                     _BTreeChild(__left, __last + 1));
+        }
+        ++__node->_M_count;
+        --__left->_M_count;
+        if (__track._M_node == __node) {
+            ++__track._M_pos;
+        } else if (__track._M_node == __parent && __track._M_pos == __sep) {
+            __track = {__node, 0};
+        } else if (__track._M_node == __left && __track._M_pos == __last) {
+            __track = {__parent, __sep};
+        }
+    }
+
+    // 从右兄弟借一个值：父节点的分隔值下移到 __node，右兄弟的最小值上移
+    void _M_borrow_right(_Node *__node, _Node *__right, size_t __sep,
+                         iterator &__track) noexcept {
+        _Node *__parent = __node->_M_parent;
+        size_t __count = __node->_M_count;
+        _BTreeImpl::_S_relocate(__node->_M_values + __count,
+                                __parent->_M_values + __sep, 1);
+        _BTreeImpl::_S_relocate(__parent->_M_values + __sep,
+                                __right->_M_values, 1);
+        _BTreeImpl::_S_relocate(__right->_M_values, __right->_M_values + 1,
+                                __right->_M_count - 1);
+        if (!__node->_M_leaf) {
+            _BTreeImpl::_S_set_child(__node, __count + 1,
+                                     _BTreeChild(__right, 0));
+            for (size_t __i = 0; __i != __right->_M_count; ++__i) {
+                _BTreeImpl::_S_set_child(__right, __i,
+                                         _BTreeChild(__right, __i + 1));
+            }
+        }
+        ++__node->_M_count;
+        --__right->_M_count;
+        if (__track._M_node == __parent && __track._M_pos == __sep) {
+            __track = {__node, __count};
+        } else if (__track._M_node == __right) {
+            if (__track._M_pos == 0) {
+                __track = {__parent, __sep};
+            } else {
+                --__track._M_pos;
+            }
+        }
+    }
+
+    // 把 __right 和父节点中的分隔值合并进 __left，释放 __right
+    void _M_merge(_Node *__left, _Node *__right, size_t __sep,
+                  iterator &__track) noexcept {
+        _Node *__parent = __left->_M_parent;
+        size_t __count = __left->_M_count;
+        _BTreeImpl::_S_relocate(__left->_M_values + __count,
+                                __parent->_M_values + __sep, 1);
+        _BTreeImpl::_S_relocate(__left->_M_values + __count + 1,
+                                __right->_M_values, __right->_M_count);
+        if (!__left->_M_leaf) {
+            for (size_t __i = 0; __i <= __right->_M_count; ++__i) {
+                _BTreeImpl::_S_set_child(__left, __count + 1 + __i,
+                                         _BTreeChild(__right, __i));
+            }
+        }
+        __left->_M_count += __right->_M_count + 1;
+        _BTreeImpl::_S_relocate(__parent->_M_values + __sep,
+                                __parent->_M_values + __sep + 1,
+                                __parent->_M_count - __sep - 1);
+        for (size_t __i = __sep + 1; __i != __parent->_M_count; ++__i) {
+            _BTreeImpl::_S_set_child(__parent, __i,
+                                     _BTreeChild(__parent, __i + 1));
+        }
+        --__parent->_M_count;
+        if (__track._M_node == __right) {
+            __track = {__left, __count + 1 + __track._M_pos};
+        } else if (__track._M_node == __parent) {
+            if (__track._M_pos == __sep) {
+                __track = {__left, __count};
+            } else if (__track._M_pos > __sep) {
+                --__track._M_pos;
+            }
+        }
+        if (_M_rightmost == __right) {
+            _M_rightmost = __left;
+        }
+        __right->_M_count = 0;
+        this->_M_free_node(__right);
+    }
+
+    // 删除后 __node 可能少于半满，自底向上借值或合并；__track 跟踪被删值的后继
+    void _M_rebalance(_Node *__node, iterator &__track) noexcept {
+        while (__node != _M_root && __node->_M_count < _S_min_count) {
+            _Node *__parent = __node->_M_parent;
+            size_t __idx = __node->_M_position;
+            _Node *__left =
+                __idx > 0 ? _BTreeChild(__parent, __idx - 1) : nullptr;
+            _Node *__right = __idx < __parent->_M_count
+                                 ? _BTreeChild(__parent, __idx + 1)
+                                 : nullptr;
+            if (__left != nullptr && __left->_M_count > _S_min_count) {
+                this->_M_borrow_left(__left, __node, __idx - 1, __track);
+                return;
+            }
+            if (__right != nullptr && __right->_M_count > _S_min_count) {
+                this->_M_borrow_right(__node, __right, __idx, __track);
+                return;
+            }
+            if (__left != nullptr) {
+                this->_M_merge(__left, __node, __idx - 1, __track);
+            } else {
+                this->_M_merge(__node, __right, __idx, __track);
+            }
+            __node = __parent;
+        }
+        if (_M_root->_M_count != 0) {
+            return;
+        }
+        _Node *__old_root = _M_root;
+        if (__old_root->_M_leaf) {
+            _M_root = _M_leftmost = _M_rightmost = nullptr;
+            __track = iterator();
+        } else {
+            _M_root = _BTreeChild(__old_root, 0);
+            _M_root->_M_parent = nullptr;
+            _M_root->_M_position = 0;
+        }
+        this->_M_free_node(__old_root);
+    }
+
+    iterator _M_normalize(iterator __it) const noexcept {
+        if (__it._M_node == nullptr) {
+            return this->_M_end();
+        }
+        while (__it._M_pos == __it._M_node->_M_count &&
+               __it._M_node->_M_parent != nullptr) {
+            __it = {__it._M_node->_M_parent, __it._M_node->_M_position};
+        }
+        if (__it._M_pos == __it._M_node->_M_count) {
+            return this->_M_end();
+        }
+        return __it;
+    }
+
+    template <class _Tv>
+    size_t _M_single_erase(const _Tv &__value) noexcept {
+        iterator __it = this->_M_find_it(__value);
+        if (__it == this->_M_end()) {
+            return 0;
+        }
+        this->erase(__it);
+        return 1;
+    }
+
+    template <class _Tv>
+    bool _M_contains(const _Tv &__value) const noexcept {
+        return this->_M_find_it(__value) != this->_M_end();
+    }
+
+public:
+    iterator erase(const_iterator __it) noexcept {
+        _Node *__node = __it._M_node;
+        size_t __pos = __it._M_pos;
+        assert(__node != nullptr && __pos < __node->_M_count);
+        _BTreeImpl::_S_destroy(__node->_M_values + __pos);
+        iterator __track(__node, __pos);
+        if (!__node->_M_leaf) {
+            // 用后继（右子树最左叶子的第一个值）补位，转化为删除叶子上的值
+            _Node *__leaf = _BTreeChild(__node, __pos + 1);
+            while (!__leaf->_M_leaf) {
+                __leaf = _BTreeChild(__leaf, 0);
+            }
+            _BTreeImpl::_S_relocate(__node->_M_values + __pos,
+                                    __leaf->_M_values, 1);
+            __node = __leaf;
+            __pos = 0;
+        }
+        _BTreeImpl::_S_relocate(__node->_M_values + __pos,
+                                __node->_M_values + __pos + 1,
+                                __node->_M_count - __pos - 1);
+        --__node->_M_count;
+        --_M_size;
+        this->_M_rebalance(__node, __track);
+        return this->_M_normalize(__track);
+    }
+
+    iterator erase(const_iterator __first, const_iterator __last) noexcept {
+        // 每次删除都会使迭代器失效，所以先数出要删除的个数
+        size_t __n = static_cast<size_t>(std::distance(__first, __last));
+        iterator __it(__first._M_node, __first._M_pos);
+        while (__n-- != 0) {
+            __it = this->erase(__it);
+        }
+        return __it;
+    }
+
+    void clear() noexcept {
+        if (_M_root != nullptr) {
+            this->_M_destroy_subtree(_M_root);
+        }
+        _M_root = _M_leftmost = _M_rightmost = nullptr;
+        _M_size = 0;
+    }
+
+    template <class _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    iterator lower_bound(_Tv &&__value) noexcept {
+        return this->_M_lower_bound_it(__value);
+    }
+
+    template <class _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    const_iterator lower_bound(_Tv &&__value) const noexcept {
+        return this->_M_lower_bound_it(__value);
+    }
+
+    template <class _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    iterator upper_bound(_Tv &&__value) noexcept {
+        return this->_M_upper_bound_it(__value);
+    }
+
+    template <class _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    const_iterator upper_bound(_Tv &&__value) const noexcept {
+        return this->_M_upper_bound_it(__value);
+    }
+
+    template <class _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    std::pair<iterator, iterator> equal_range(_Tv &&__value) noexcept {
+        return {this->lower_bound(__value), this->upper_bound(__value)};
+    }
+
+    template <class _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    std::pair<const_iterator, const_iterator>
+    equal_range(_Tv &&__value) const noexcept {
+        return {this->lower_bound(__value), this->upper_bound(__value)};
+    }
+
+    iterator lower_bound(const _Tp &__value) noexcept {
+        return this->_M_lower_bound_it(__value);
+    }
+
+    const_iterator lower_bound(const _Tp &__value) const noexcept {
+        return this->_M_lower_bound_it(__value);
+    }
+
+    iterator upper_bound(const _Tp &__value) noexcept {
+        return this->_M_upper_bound_it(__value);
+    }
+
+    const_iterator upper_bound(const _Tp &__value) const noexcept {
+        return this->_M_upper_bound_it(__value);
+    }
+
+    std::pair<iterator, iterator> equal_range(const _Tp &__value) noexcept {
+        return {this->lower_bound(__value), this->upper_bound(__value)};
+    }
+
+    std::pair<const_iterator, const_iterator>
+    equal_range(const _Tp &__value) const noexcept {
+        return {this->lower_bound(__value), this->upper_bound(__value)};
+    }
+
+    iterator begin() noexcept {
+        return _M_leftmost == nullptr ? iterator() : iterator(_M_leftmost, 0);
+    }
+
+    iterator end() noexcept {
+        return this->_M_end();
+    }
+
+    const_iterator begin() const noexcept {
+        return _M_leftmost == nullptr ? iterator() : iterator(_M_leftmost, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return this->_M_end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(this->end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(this->begin());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(this->end());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(this->begin());
+    }
+
+    bool empty() const noexcept {
+        return _M_size == 0;
+    }
+
+    size_t size() const noexcept {
+        return _M_size;
+    }
+
+    // 每个节点能容纳的值的个数
+    static constexpr size_t node_slots() noexcept {
+        return _S_slots;
+    }
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <common/_common.hpp>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace Marcus {
+
+// 标记输入已经按比较器排好序且没有重复，构造和插入时跳过排序
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+
+inline constexpr sorted_unique_t sorted_unique{};
+
+// flat_map 的迭代器：键和值分别存放在两个连续数组中，解引用得到一对引用
+template <typename _Key, typename _Vp>
+struct _FlatMapIterator {
+    const _Key *_M_key;
+    _Vp *_M_value;
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::pair<_Key, std::remove_const_t<_Vp>>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const _Key &, _Vp &>;
+
+    struct pointer {
+        reference _M_ref;
+
+        reference *operator->() noexcept {
+            return std::addressof(_M_ref);
+        }
+    };
+
+    _FlatMapIterator() noexcept : _M_key(nullptr), _M_value(nullptr) {}
+
+    _FlatMapIterator(const _Key *__key, _Vp *__value) noexcept
+        : _M_key(__key),
+          _M_value(__value) {}
+
+    template <typename _Up,
+              typename = std::enable_if_t<std::is_same_v<const _Up, _Vp> &&
+                                          !std::is_same_v<_Up, _Vp>>>
+    _FlatMapIterator(const _FlatMapIterator<_Key, _Up> &__that) noexcept
+        : _M_key(__that._M_key),
+          _M_value(__that._M_value) {}
+
+    reference operator*() const noexcept {
+        return {*_M_key, *_M_value};
+    }
+
+    pointer operator->() const noexcept {
+        return {**this};
+    }
+
+    reference operator[](difference_type __n) const noexcept {
+        return {_M_key[__n], _M_value[__n]};
+    }
+
+    _FlatMapIterator &operator++() noexcept {
+        ++_M_key;
+        ++_M_value;
+        return *this;
+    }
+
+    _FlatMapIterator &operator--() noexcept {
+        --_M_key;
+        --_M_value;
+        return *this;
+    }
+
+    _FlatMapIterator operator++(int) noexcept {
+        _FlatMapIterator __tmp = *this;
+        ++*this;
+        return __tmp;
+    }
+
+    _FlatMapIterator operator--(int) noexcept {
+        _FlatMapIterator __tmp = *this;
+        --*this;
+        return __tmp;
+    }
+
+    _FlatMapIterator &operator+=(difference_type __n) noexcept {
+        _M_key += __n;
+        _M_value += __n;
+        return *this;
+    }
+
+    _FlatMapIterator &operator-=(difference_type __n) noexcept {
+        _M_key -= __n;
+        _M_value -= __n;
+        return *this;
+    }
+
+    _FlatMapIterator operator+(difference_type __n) const noexcept {
+        return {_M_key + __n, _M_value + __n};
+    }
+
+    _FlatMapIterator operator-(difference_type __n) const noexcept {
+        return {_M_key - __n, _M_value - __n};
+    }
+
+    friend _FlatMapIterator operator+(difference_type __n,
+                                      const _FlatMapIterator &__it) noexcept {
+        return __it + __n;
+    }
+
+    difference_type operator-(const _FlatMapIterator &__that) const noexcept {
+        return _M_key - __that._M_key;
+    }
+
+    bool operator==(const _FlatMapIterator &__that) const noexcept {
+        return _M_key == __that._M_key;
+    }
+
+    bool operator!=(const _FlatMapIterator &__that) const noexcept {
+        return _M_key != __that._M_key;
+    }
+
+    bool operator<(const _FlatMapIterator &__that) const noexcept {
+        return _M_key < __that._M_key;
+    }
+
+    bool operator>(const _FlatMapIterator &__that) const noexcept {
+        return _M_key > __that._M_key;
+    }
+
+    bool operator<=(const _FlatMapIterator &__that) const noexcept {
+        return _M_key <= __that._M_key;
+    }
+
+    bool operator>=(const _FlatMapIterator &__that) const noexcept {
+        return _M_key >= __that._M_key;
+    }
+};
+
+} // namespace Marcus
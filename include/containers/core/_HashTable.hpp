@@ -0,0 +1,818 @@
+#pragma once
+
+#include <bit>
+#include <common/_common.hpp>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define _LIBPENGCXX_HASH_SSE2 1
+#endif
+
+// 开放寻址哈希表，布局参考 Swiss table：
+// 每个槽位对应一个控制字节，空槽为 _HashCtrlEmpty，满槽保存哈希值的低 7 位
+// 查找时一次比较一组（SSE2 下 16 个）控制字节，只对命中的槽位比较键
+//
+// 探测顺序是从起始位置开始的线性顺序，并且不回绕：表尾留有一段溢出区，
+// 溢出区也放不下时直接扩容。这样删除可以用向后移位（backward shift）
+// 代替墓碑，元素只会向前移动，边遍历边删除也不会漏掉或重复访问元素
+using _HashCtrl = std::int8_t;
+
+inline constexpr _HashCtrl _HashCtrlEmpty = -128;
+
+// 一组控制字节的匹配结果，每个槽位占 1 << _Shift 位
+template <int _Shift>
+struct _HashBitMask {
+    std::uint64_t _M_mask;
+
+    explicit operator bool() const noexcept {
+        return _M_mask != 0;
+    }
+
+    size_t _M_lowest() const noexcept {
+        return static_cast<size_t>(std::countr_zero(_M_mask)) >> _Shift;
+    }
+
+    void _M_drop_lowest() noexcept {
+        _M_mask &= _M_mask - 1;
+    }
+};
+
+#if _LIBPENGCXX_HASH_SSE2
+struct _HashGroup {
+    static constexpr size_t _S_width = 16;
+
+    using _BitMask = _HashBitMask<0>;
+
+    __m128i _M_ctrl;
+
+    explicit _HashGroup(const _HashCtrl *__ctrl) noexcept
+        : _M_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(__ctrl))) {
+    }
+
+    _BitMask _M_match(_HashCtrl __h2) const noexcept {
+        return {static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_set1_epi8(__h2), _M_ctrl)))};
+    }
+
+    // 空槽的最高位为 1，满槽为 0
+    _BitMask _M_match_empty() const noexcept {
+        return {static_cast<std::uint32_t>(_mm_movemask_epi8(_M_ctrl))};
+    }
+
+    _BitMask _M_match_full() const noexcept {
+        return {~static_cast<std::uint32_t>(_mm_movemask_epi8(_M_ctrl)) &
+                0xffffu};
+    }
+};
+#else
+// 没有 SSE2 时把 8 个控制字节装进一个 64 位整数，用位运算并行比较
+struct _HashGroup {
+    static constexpr size_t _S_width = 8;
+
+    using _BitMask = _HashBitMask<3>;
+
+    static constexpr std::uint64_t _S_lsbs = 0x0101010101010101ull;
+    static constexpr std::uint64_t _S_msbs = 0x8080808080808080ull;
+
+    std::uint64_t _M_ctrl;
+
+    explicit _HashGroup(const _HashCtrl *__ctrl) noexcept : _M_ctrl(0) {
+        for (size_t __i = 0; __i != _S_width; ++__i) {
+            _M_ctrl |= std::uint64_t(static_cast<std::uint8_t>(__ctrl[__i]))
+                       << (8 * __i);
+        }
+    }
+
+    // 可能有假阳性（紧跟在真正命中之后的字节），调用者总会再比较键
+    _BitMask _M_match(_HashCtrl __h2) const noexcept {
+        std::uint64_t __x =
+            _M_ctrl ^ (_S_lsbs * static_cast<std::uint8_t>(__h2));
+        return {(__x - _S_lsbs) & ~__x & _S_msbs};
+    }
+
+    _BitMask _M_match_empty() const noexcept {
+        return {_M_ctrl & _S_msbs};
+    }
+
+    _BitMask _M_match_full() const noexcept {
+        return {~_M_ctrl & _S_msbs};
+    }
+};
+#endif
+
+struct _HashKeyIdentity {
+    template <class _Tp>
+    const _Tp &operator()(const _Tp &__value) const noexcept {
+        return __value;
+    }
+};
+
+struct _HashKeyFirst {
+    template <class _Tp>
+    const auto &operator()(const _Tp &__value) const noexcept {
+        return __value.first;
+    }
+};
+
+template <class _Tp>
+struct _HashSlotIsMapPair : std::false_type {};
+
+template <class _Key, class _Mapped>
+struct _HashSlotIsMapPair<std::pair<const _Key, _Mapped>> : std::true_type {
+    using _First = _Key;
+};
+
+template <class _Tp, class _Vp>
+struct _HashTableIterator {
+protected:
+    const _HashCtrl *_M_ctrl;
+    _Tp *_M_slot;
+    const _HashCtrl *_M_end;
+
+    template <class, class, class, class, class, class>
+    friend struct _HashTableImpl;
+
+    template <class, class>
+    friend struct _HashTableIterator;
+
+    _HashTableIterator(const _HashCtrl *__ctrl, _Tp *__slot,
+                       const _HashCtrl *__end) noexcept
+        : _M_ctrl(__ctrl),
+          _M_slot(__slot),
+          _M_end(__end) {}
+
+    // 按组跳过空槽，停在下一个满槽或 end
+    void _M_skip_empty() noexcept {
+        while (_M_ctrl != _M_end) {
+            auto __m = _HashGroup(_M_ctrl)._M_match_full();
+            size_t __n = __m ? __m._M_lowest() : _HashGroup::_S_width;
+            size_t __left = static_cast<size_t>(_M_end - _M_ctrl);
+            if (__n > __left) {
+                __n = __left;
+            }
+            _M_ctrl += __n;
+            _M_slot += __n;
+            if (__m) {
+                return;
+            }
+        }
+    }
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::remove_const_t<_Vp>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = _Vp *;
+    using reference = _Vp &;
+
+    _HashTableIterator() noexcept
+        : _M_ctrl(nullptr),
+          _M_slot(nullptr),
+          _M_end(nullptr) {}
+
+    template <class _Up,
+              class = std::enable_if_t<std::is_same_v<const _Up, _Vp> &&
+                                       !std::is_same_v<_Up, _Vp>>>
+    _HashTableIterator(const _HashTableIterator<_Tp, _Up> &__that) noexcept
+        : _M_ctrl(__that._M_ctrl),
+          _M_slot(__that._M_slot),
+          _M_end(__that._M_end) {}
+
+    _Vp &operator*() const noexcept {
+        return *_M_slot;
+    }
+
+    _Vp *operator->() const noexcept {
+        return _M_slot;
+    }
+
+    _HashTableIterator &operator++() noexcept {
+        ++_M_ctrl;
+        ++_M_slot;
+        _M_skip_empty();
+        return *this;
+    }
+
+    _HashTableIterator operator++(int) noexcept {
+        _HashTableIterator __tmp = *this;
+        ++*this;
+        return __tmp;
+    }
+
+    bool operator==(const _HashTableIterator &__that) const noexcept {
+        return _M_slot == __that._M_slot;
+    }
+
+    bool operator!=(const _HashTableIterator &__that) const noexcept {
+        return _M_slot != __that._M_slot;
+    }
+};
+
+template <class _Key, class _Tp, class _KeyOf, class _Hash, class _KeyEqual,
+          class _Alloc>
+struct _HashTableImpl {
+public:
+    using key_type = _Key;
+    using hasher = _Hash;
+    using key_equal = _KeyEqual;
+    using allocator_type = _Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator = _HashTableIterator<_Tp, _Tp>;
+    using const_iterator = _HashTableIterator<_Tp, const _Tp>;
+
+protected:
+    using _SlotAlloc =
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<_Tp>;
+    using _CtrlAlloc = typename std::allocator_traits<
+        _Alloc>::template rebind_alloc<_HashCtrl>;
+
+    static constexpr size_t _S_width = _HashGroup::_S_width;
+    static constexpr size_t _S_min_capacity = 16;
+    static constexpr bool _S_trivially_relocatable =
+        std::is_trivially_copy_constructible_v<_Tp> &&
+        std::is_trivially_destructible_v<_Tp>;
+
+    _HashCtrl *_M_ctrl;
+    _Tp *_M_slots;
+    size_t _M_capacity; // 起始位置的取值范围，总是 2 的幂（或 0）
+    size_t _M_total;    // 槽位总数，等于 _M_capacity 加上溢出区
+    size_t _M_size;
+    [[no_unique_address]] _Hash _M_hash;
+    [[no_unique_address]] _KeyEqual _M_eq;
+    [[no_unique_address]] _Alloc _M_alloc;
+
+    template <class... _Ts>
+    static void _S_construct(_Tp *__ptr, _Ts &&...__value) {
+        ::new (static_cast<void *>(__ptr)) _Tp(std::forward<_Ts>(__value)...);
+    }
+
+    static void _S_destroy(_Tp *__ptr) noexcept {
+        __ptr->~_Tp();
+    }
+
+    // 把 *__src 搬到 __dst；搬走后源位置视为已析构
+    static void _S_relocate(_Tp *__dst, _Tp *__src) noexcept {
+        if constexpr (_S_trivially_relocatable) {
+            std::memcpy(static_cast<void *>(__dst),
+                        static_cast<const void *>(__src), sizeof(_Tp));
+        } else if constexpr (_HashSlotIsMapPair<_Tp>::value) {
+            // pair<const K, V> 的键马上就要析构，直接移动它而不是拷贝
+            using _First = typename _HashSlotIsMapPair<_Tp>::_First;
+            _HashTableImpl::_S_construct(
+                __dst, std::move(const_cast<_First &>(__src->first)),
+                std::move(__src->second));
+            _HashTableImpl::_S_destroy(__src);
+        } else {
+            _HashTableImpl::_S_construct(__dst, std::move(*__src));
+            _HashTableImpl::_S_destroy(__src);
+        }
+    }
+
+    static size_t _S_overflow(size_t __capacity) noexcept {
+        return std::max(_S_width, __capacity / 8);
+    }
+
+    // 最大装载因子 7/8
+    static size_t _S_growth_limit(size_t __capacity) noexcept {
+        return __capacity - __capacity / 8;
+    }
+
+    static size_t _S_capacity_for(size_t __n) noexcept {
+        size_t __capacity = _S_min_capacity;
+        while (_S_growth_limit(__capacity) < __n) {
+            __capacity *= 2;
+        }
+        return __capacity;
+    }
+
+    // std::hash 对整数往往是恒等映射，线性探测需要把高位也搅进低位
+    static size_t _S_mix(size_t __h) noexcept {
+        std::uint64_t __x = __h;
+        __x ^= __x >> 33;
+        __x *= 0xff51afd7ed558ccdull;
+        __x ^= __x >> 33;
+        return static_cast<size_t>(__x);
+    }
+
+    static _HashCtrl _S_h2(size_t __h) noexcept {
+        return static_cast<_HashCtrl>(__h & 0x7f);
+    }
+
+    template <class _Kv>
+    size_t _M_hash_of(const _Kv &__key) const {
+        return _HashTableImpl::_S_mix(_M_hash(__key));
+    }
+
+    size_t _M_home(size_t __h) const noexcept {
+        return (__h >> 7) & (_M_capacity - 1);
+    }
+
+    static const _Key &_S_key(const _Tp &__value) noexcept {
+        return _KeyOf()(__value);
+    }
+
+    iterator _M_iter(size_t __i) noexcept {
+        return {_M_ctrl + __i, _M_slots + __i, _M_ctrl + _M_total};
+    }
+
+    const_iterator _M_iter(size_t __i) const noexcept {
+        return {_M_ctrl + __i, _M_slots + __i, _M_ctrl + _M_total};
+    }
+
+    void _M_allocate(size_t __capacity) {
+        size_t __total = __capacity + _HashTableImpl::_S_overflow(__capacity);
+        _CtrlAlloc __ctrl_alloc(_M_alloc);
+        _SlotAlloc __slot_alloc(_M_alloc);
+        // 控制字节多分配一组，末尾一组永远是空槽，探测到这里一定会停下
+        _HashCtrl *__ctrl = std::allocator_traits<_CtrlAlloc>::allocate(
+            __ctrl_alloc, __total + _S_width);
+        _Tp *__slots;
+        try {
+            __slots =
+                std::allocator_traits<_SlotAlloc>::allocate(__slot_alloc, __total);
+        } catch (...) {
+            std::allocator_traits<_CtrlAlloc>::deallocate(__ctrl_alloc, __ctrl,
+                                                          __total + _S_width);
+            throw;
+        }
+        std::memset(__ctrl, static_cast<unsigned char>(_HashCtrlEmpty),
+                    __total + _S_width);
+        _M_ctrl = __ctrl;
+        _M_slots = __slots;
+        _M_capacity = __capacity;
+        _M_total = __total;
+    }
+
+    void _M_deallocate(_HashCtrl *__ctrl, _Tp *__slots,
+                       size_t __total) noexcept {
+        if (__ctrl == nullptr) {
+            return;
+        }
+        _CtrlAlloc __ctrl_alloc(_M_alloc);
+        _SlotAlloc __slot_alloc(_M_alloc);
+        std::allocator_traits<_CtrlAlloc>::deallocate(__ctrl_alloc, __ctrl,
+                                                      __total + _S_width);
+        std::allocator_traits<_SlotAlloc>::deallocate(__slot_alloc, __slots,
+                                                      __total);
+    }
+
+    void _M_destroy_all() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<_Tp>) {
+            for (size_t __i = 0; __i != _M_total; ++__i) {
+                if (_M_ctrl[__i] >= 0) {
+                    _HashTableImpl::_S_destroy(_M_slots + __i);
+                }
+            }
+        }
+    }
+
+    // 从 __h 的起始位置往后找第一个空槽；超出溢出区时返回 _M_total
+    size_t _M_find_empty(size_t __h) const noexcept {
+        for (size_t __pos = _M_home(__h);; __pos += _S_width) {
+            auto __m = _HashGroup(_M_ctrl + __pos)._M_match_empty();
+            if (__m) {
+                size_t __i = __pos + __m._M_lowest();
+                return __i < _M_total ? __i : _M_total;
+            }
+        }
+    }
+
+    template <class _Kv>
+    size_t _M_find_index(const _Kv &__key) const {
+        if (_M_size == 0) {
+            return _M_total;
+        }
+        return _M_find_index(__key, _M_hash_of(__key));
+    }
+
+    template <class _Kv>
+    size_t _M_find_index(const _Kv &__key, size_t __h) const {
+        if (_M_size == 0) {
+            return _M_total;
+        }
+        _HashCtrl __h2 = _HashTableImpl::_S_h2(__h);
+        for (size_t __pos = _M_home(__h);; __pos += _S_width) {
+            _HashGroup __group(_M_ctrl + __pos);
+            for (auto __m = __group._M_match(__h2); __m; __m._M_drop_lowest()) {
+                size_t __i = __pos + __m._M_lowest();
+                if (_M_eq(_HashTableImpl::_S_key(_M_slots[__i]), __key))
+                    [[likely]] {
+                    return __i;
+                }
+            }
+            if (__group._M_match_empty()) {
+                return _M_total;
+            }
+        }
+    }
+
+    // 元素的位置只取决于哈希值，所以重新分配时逐个放进新表即可
+    void _M_resize(size_t __capacity) {
+        _HashCtrl *__old_ctrl = _M_ctrl;
+        _Tp *__old_slots = _M_slots;
+        size_t __old_total = _M_total;
+        _M_allocate(__capacity);
+        for (size_t __i = 0; __i != __old_total; ++__i) {
+            if (__old_ctrl[__i] < 0) {
+                continue;
+            }
+            size_t __h = _M_hash_of(_HashTableImpl::_S_key(__old_slots[__i]));
+            size_t __j;
+            while ((__j = _M_find_empty(__h)) == _M_total) [[unlikely]] {
+                // 溢出区放不下，继续扩容，已经搬进来的元素随之再搬一次
+                _M_resize(_M_capacity * 2);
+            }
+            _HashTableImpl::_S_relocate(_M_slots + __j, __old_slots + __i);
+            _M_ctrl[__j] = __old_ctrl[__i];
+        }
+        _M_deallocate(__old_ctrl, __old_slots, __old_total);
+    }
+
+    // 插入一个确定不在表中的新元素，返回它的下标
+    template <class... _Ts>
+    size_t _M_insert_new(size_t __h, _Ts &&...__value) {
+        size_t __i = _M_total;
+        if (_M_size < _HashTableImpl::_S_growth_limit(_M_capacity)) [[likely]] {
+            __i = _M_find_empty(__h);
+        }
+        if (__i == _M_total) [[unlikely]] {
+            // 需要扩容；参数可能引用表内的元素，先在临时缓冲区里构造好
+            alignas(_Tp) unsigned char __buf[sizeof(_Tp)];
+            _Tp *__tmp = reinterpret_cast<_Tp *>(__buf);
+            _HashTableImpl::_S_construct(__tmp, std::forward<_Ts>(__value)...);
+            try {
+                do {
+                    _M_resize(_M_capacity ? _M_capacity * 2 : _S_min_capacity);
+                } while ((__i = _M_find_empty(__h)) == _M_total);
+            } catch (...) {
+                _HashTableImpl::_S_destroy(__tmp);
+                throw;
+            }
+            _HashTableImpl::_S_relocate(_M_slots + __i, __tmp);
+        } else {
+            _HashTableImpl::_S_construct(_M_slots + __i,
+                                         std::forward<_Ts>(__value)...);
+        }
+        _M_ctrl[__i] = _HashTableImpl::_S_h2(__h);
+        ++_M_size;
+        return __i;
+    }
+
+    template <class _Kv, class... _Ts>
+    std::pair<iterator, bool> _M_try_emplace(const _Kv &__key,
+                                             _Ts &&...__value) {
+        size_t __h = _M_hash_of(__key);
+        size_t __i = _M_find_index(__key, __h);
+        if (__i != _M_total) {
+            return {_M_iter(__i), false};
+        }
+        return {_M_iter(_M_insert_new(__h, std::forward<_Ts>(__value)...)),
+                true};
+    }
+
+    // 键要从构造好的值里取出来，所以先构造在临时缓冲区里
+    template <class... _Ts>
+    std::pair<iterator, bool> _M_emplace(_Ts &&...__value) {
+        alignas(_Tp) unsigned char __buf[sizeof(_Tp)];
+        _Tp *__tmp = reinterpret_cast<_Tp *>(__buf);
+        _HashTableImpl::_S_construct(__tmp, std::forward<_Ts>(__value)...);
+        struct _Guard {
+            _Tp *_M_ptr;
+
+            ~_Guard() {
+                _HashTableImpl::_S_destroy(_M_ptr);
+            }
+        } __guard{__tmp};
+        return _M_try_emplace(_HashTableImpl::_S_key(*__tmp), std::move(*__tmp));
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    void _M_insert_range(_InputIt __first, _InputIt __last) {
+        if constexpr (std::forward_iterator<_InputIt>) {
+            reserve(_M_size + static_cast<size_t>(std::distance(__first, __last)));
+        }
+        for (; __first != __last; ++__first) {
+            _M_emplace(*__first);
+        }
+    }
+
+    // 向后移位删除：把后面那些起始位置不晚于空洞的元素依次前移，不留墓碑
+    void _M_erase_index(size_t __i) {
+        _HashTableImpl::_S_destroy(_M_slots + __i);
+        --_M_size;
+        for (size_t __j = __i + 1;
+             __j != _M_total && _M_ctrl[__j] != _HashCtrlEmpty; ++__j) {
+            size_t __home =
+                _M_home(_M_hash_of(_HashTableImpl::_S_key(_M_slots[__j])));
+            if (__home <= __i) {
+                _HashTableImpl::_S_relocate(_M_slots + __i, _M_slots + __j);
+                _M_ctrl[__i] = _M_ctrl[__j];
+                __i = __j;
+            }
+        }
+        _M_ctrl[__i] = _HashCtrlEmpty;
+    }
+
+    void _M_copy_from(const _HashTableImpl &__that) {
+        if (__that._M_size == 0) {
+            return;
+        }
+        // 哈希函数相同，元素原样放在相同的下标上，不需要重新计算哈希
+        _M_allocate(__that._M_capacity);
+        size_t __i = 0;
+        try {
+            for (; __i != _M_total; ++__i) {
+                if (__that._M_ctrl[__i] >= 0) {
+                    _HashTableImpl::_S_construct(_M_slots + __i,
+                                                 __that._M_slots[__i]);
+                    _M_ctrl[__i] = __that._M_ctrl[__i];
+                }
+            }
+        } catch (...) {
+            _M_destroy_all();
+            _M_deallocate(_M_ctrl, _M_slots, _M_total);
+            _M_ctrl = nullptr;
+            _M_slots = nullptr;
+            _M_capacity = _M_total = 0;
+            throw;
+        }
+        _M_size = __that._M_size;
+    }
+
+    // 与顺序无关的相等比较，__eq 比较两个值
+    template <class _Eq>
+    bool _M_equal(const _HashTableImpl &__that, _Eq __eq) const {
+        if (_M_size != __that._M_size) {
+            return false;
+        }
+        for (const _Tp &__value: *this) {
+            size_t __j = __that._M_find_index(_HashTableImpl::_S_key(__value));
+            if (__j == __that._M_total || !__eq(__value, __that._M_slots[__j])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    _HashTableImpl() noexcept
+        : _M_ctrl(nullptr),
+          _M_slots(nullptr),
+          _M_capacity(0),
+          _M_total(0),
+          _M_size(0) {}
+
+    explicit _HashTableImpl(size_t __bucket_count, const _Hash &__hash = _Hash(),
+                            const _KeyEqual &__eq = _KeyEqual(),
+                            const _Alloc &__alloc = _Alloc())
+        : _M_ctrl(nullptr),
+          _M_slots(nullptr),
+          _M_capacity(0),
+          _M_total(0),
+          _M_size(0),
+          _M_hash(__hash),
+          _M_eq(__eq),
+          _M_alloc(__alloc) {
+        if (__bucket_count != 0) {
+            reserve(__bucket_count);
+        }
+    }
+
+    _HashTableImpl(const _HashTableImpl &__that)
+        : _M_ctrl(nullptr),
+          _M_slots(nullptr),
+          _M_capacity(0),
+          _M_total(0),
+          _M_size(0),
+          _M_hash(__that._M_hash),
+          _M_eq(__that._M_eq),
+          _M_alloc(std::allocator_traits<_Alloc>::
+                       select_on_container_copy_construction(__that._M_alloc)) {
+        _M_copy_from(__that);
+    }
+
+    _HashTableImpl(_HashTableImpl &&__that) noexcept
+        : _M_ctrl(std::exchange(__that._M_ctrl, nullptr)),
+          _M_slots(std::exchange(__that._M_slots, nullptr)),
+          _M_capacity(std::exchange(__that._M_capacity, 0)),
+          _M_total(std::exchange(__that._M_total, 0)),
+          _M_size(std::exchange(__that._M_size, 0)),
+          _M_hash(std::move(__that._M_hash)),
+          _M_eq(std::move(__that._M_eq)),
+          _M_alloc(std::move(__that._M_alloc)) {}
+
+    _HashTableImpl &operator=(const _HashTableImpl &__that) {
+        if (&__that != this) {
+            _HashTableImpl __tmp(__that);
+            swap(__tmp);
+        }
+        return *this;
+    }
+
+    _HashTableImpl &operator=(_HashTableImpl &&__that) noexcept {
+        if (&__that != this) {
+            _HashTableImpl __tmp(std::move(__that));
+            swap(__tmp);
+        }
+        return *this;
+    }
+
+    ~_HashTableImpl() noexcept {
+        _M_destroy_all();
+        _M_deallocate(_M_ctrl, _M_slots, _M_total);
+    }
+
+    void swap(_HashTableImpl &__that) noexcept {
+        std::swap(_M_ctrl, __that._M_ctrl);
+        std::swap(_M_slots, __that._M_slots);
+        std::swap(_M_capacity, __that._M_capacity);
+        std::swap(_M_total, __that._M_total);
+        std::swap(_M_size, __that._M_size);
+        std::swap(_M_hash, __that._M_hash);
+        std::swap(_M_eq, __that._M_eq);
+        std::swap(_M_alloc, __that._M_alloc);
+    }
+
+    iterator begin() noexcept {
+        iterator __it = _M_iter(0);
+        __it._M_skip_empty();
+        return __it;
+    }
+
+    iterator end() noexcept {
+        return _M_iter(_M_total);
+    }
+
+    const_iterator begin() const noexcept {
+        const_iterator __it = _M_iter(0);
+        __it._M_skip_empty();
+        return __it;
+    }
+
+    const_iterator end() const noexcept {
+        return _M_iter(_M_total);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    bool empty() const noexcept {
+        return _M_size == 0;
+    }
+
+    size_t size() const noexcept {
+        return _M_size;
+    }
+
+    size_t bucket_count() const noexcept {
+        return _M_total;
+    }
+
+    float load_factor() const noexcept {
+        return _M_total ? static_cast<float>(_M_size) /
+                              static_cast<float>(_M_total)
+                        : 0.0f;
+    }
+
+    static constexpr float max_load_factor() noexcept {
+        return 0.875f;
+    }
+
+    // 保证再插入到 __n 个元素之前不会重新分配
+    void reserve(size_t __n) {
+        size_t __capacity = _HashTableImpl::_S_capacity_for(__n);
+        if (__capacity > _M_capacity) {
+            _M_resize(__capacity);
+        }
+    }
+
+    // 按 __n 个起始位置重建（也可以缩小），但至少能容纳当前的元素
+    void rehash(size_t __n) {
+        size_t __capacity = std::max(std::bit_ceil(std::max(__n, _S_min_capacity)),
+                                     _HashTableImpl::_S_capacity_for(_M_size));
+        if (__capacity != _M_capacity) {
+            _M_resize(__capacity);
+        }
+    }
+
+    void clear() noexcept {
+        if (_M_size == 0) {
+            return;
+        }
+        _M_destroy_all();
+        std::memset(_M_ctrl, static_cast<unsigned char>(_HashCtrlEmpty),
+                    _M_total);
+        _M_size = 0;
+    }
+
+    hasher hash_function() const {
+        return _M_hash;
+    }
+
+    key_equal key_eq() const {
+        return _M_eq;
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return _M_alloc;
+    }
+
+    iterator find(const _Key &__key) {
+        return _M_iter(_M_find_index(__key));
+    }
+
+    const_iterator find(const _Key &__key) const {
+        return _M_iter(_M_find_index(__key));
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_HASH(_Hash, _KeyEqual)>
+    iterator find(const _Kv &__key) {
+        return _M_iter(_M_find_index(__key));
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_HASH(_Hash, _KeyEqual)>
+    const_iterator find(const _Kv &__key) const {
+        return _M_iter(_M_find_index(__key));
+    }
+
+    bool contains(const _Key &__key) const {
+        return _M_find_index(__key) != _M_total;
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_HASH(_Hash, _KeyEqual)>
+    bool contains(const _Kv &__key) const {
+        return _M_find_index(__key) != _M_total;
+    }
+
+    size_t count(const _Key &__key) const {
+        return _M_find_index(__key) != _M_total ? 1 : 0;
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_HASH(_Hash, _KeyEqual)>
+    size_t count(const _Kv &__key) const {
+        return _M_find_index(__key) != _M_total ? 1 : 0;
+    }
+
+    // 返回下一个元素；被移位填进当前位置的元素还没有被访问过
+    iterator erase(const_iterator __it) {
+        size_t __i = static_cast<size_t>(__it._M_slot - _M_slots);
+        _M_erase_index(__i);
+        iterator __next = _M_iter(__i);
+        __next._M_skip_empty();
+        return __next;
+    }
+
+    iterator erase(iterator __it) {
+        return erase(const_iterator(__it));
+    }
+
+    iterator erase(const_iterator __first, const_iterator __last) {
+        // 从后往前删：移位只影响删除位置及其之后的槽位，
+        // 区间前部还没删的元素不会被挪动
+        size_t __lo = static_cast<size_t>(__first._M_slot - _M_slots);
+        size_t __i = static_cast<size_t>(__last._M_slot - _M_slots);
+        while (__i != __lo) {
+            --__i;
+            if (_M_ctrl[__i] >= 0) {
+                _M_erase_index(__i);
+            }
+        }
+        iterator __next = _M_iter(__lo);
+        __next._M_skip_empty();
+        return __next;
+    }
+
+    size_t erase(const _Key &__key) {
+        size_t __i = _M_find_index(__key);
+        if (__i == _M_total) {
+            return 0;
+        }
+        _M_erase_index(__i);
+        return 1;
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_HASH(_Hash, _KeyEqual)>
+    size_t erase(const _Kv &__key) {
+        size_t __i = _M_find_index(__key);
+        if (__i == _M_total) {
+            return 0;
+        }
+        _M_erase_index(__i);
+        return 1;
+    }
+};
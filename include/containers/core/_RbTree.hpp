@@ -1,9 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <bit>
 #include <cassert>
 #include <common/_common.hpp>
+#include <cstdint>
 #include <iterator>
 #include <memory>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
@@ -23,6 +27,8 @@ struct _RbTreeNode {
     _RbTreeNode *_M_parent;
     _RbTreeNode **_M_pparent; // 父节点中指向本节点指针的指针
     _RbTreeColor _M_color;
+    // 子树的节点数，用于顺序统计；放在颜色后面的填充里，不增加节点大小
+    std::uint32_t _M_size;
 };
 
 template <class _Tp>
@@ -75,6 +81,9 @@ protected:
     friend struct _RbTreeIterator;
 
 public:
+    // 默认构造的迭代器是奇异的，只能被赋值；有了它才满足 std::forward_iterator
+    _RbTreeIteratorBase() noexcept : _M_node(nullptr), _M_off_by_one(false) {}
+
     bool operator==(const _RbTreeIteratorBase &__that) const noexcept {
         return (!_M_off_by_one && !__that._M_off_by_one &&
                 _M_node == __that._M_node) ||
@@ -158,6 +167,8 @@ protected:
     using _RbTreeIteratorBase<false>::_RbTreeIteratorBase;
 
 public:
+    _RbTreeIteratorBase() noexcept = default;
+
     void operator++() noexcept { // ++__it
         _RbTreeIteratorBase<false>::operator--();
     }
@@ -174,6 +185,8 @@ protected:
     using _RbTreeIteratorBase<_Reverse>::_RbTreeIteratorBase;
 
 public:
+    _RbTreeIterator() noexcept = default;
+
     // 类型转换
     template <class T0 = _Tp>
     explicit operator std::enable_if_t<
@@ -245,29 +258,434 @@ public:
 
 struct _RbTreeRoot {
     _RbTreeNode *_M_root;
+    _RbTreeNode *_M_rightmost; // 最大节点，在 end() 处带提示插入时不必沿右链下降
 };
 
+// 节点池的内存统计
+struct _RbTreeMemoryStats {
+    size_t node_size;      // 单个节点占用的字节数
+    size_t nodes_in_use;   // 树中的节点数（extract 出去的节点不算在内）
+    size_t nodes_free;     // 空闲链表中等待复用的节点数
+    size_t nodes_reserved; // 所有大块中可切分的节点总数
+    size_t chunks;         // 向分配器申请的大块数量
+    size_t bytes_reserved; // 向分配器申请的总字节数
+};
+
+// 节点池：从大块内存中切分节点，释放的节点挂入空闲链表等待复用
+template <class _NodeImpl, class _Alloc>
+struct _RbTreeNodePool {
+protected:
+    using _NodeAlloc = typename std::allocator_traits<
+        _Alloc>::template rebind_alloc<_NodeImpl>;
+    using _NodeTraits = std::allocator_traits<_NodeAlloc>;
+
+    // 每个大块的第一个槽位用来记录大块链表
+    struct _Chunk {
+        _Chunk *_M_next;
+        size_t _M_slots;
+    };
+
+    struct _FreeSlot {
+        _FreeSlot *_M_next;
+    };
+
+    // 大块的所有者，每个节点池有自己的一个，只有它会往里添加大块。
+    // 最后一个引用者负责把大块还给分配器
+    struct _Arena {
+        _Chunk *_M_chunks;
+        std::atomic<size_t> _M_refs; // 引用它的共享链节点数
+    };
+
+    // 共享链：本池的节点可能来自的所有共享区。树之间搬移节点时接收方
+    // 把对方的共享区插到自己的链头；链节点创建后不再修改，只有引用计数会变，
+    // 所以搬移之后两棵树可以在不同线程上各自分配和释放
+    struct _Share {
+        _Arena *_M_arena;
+        _Share *_M_next;
+        std::atomic<size_t> _M_refs; // 链头的持有者加上指向它的链节点数
+        // 节点句柄在任意线程上交还的槽位，由本池在申请新大块前收回
+        std::atomic<_FreeSlot *> _M_returned;
+    };
+
+    using _ArenaAlloc = typename std::allocator_traits<
+        _Alloc>::template rebind_alloc<_Arena>;
+    using _ArenaTraits = std::allocator_traits<_ArenaAlloc>;
+    using _ShareAlloc = typename std::allocator_traits<
+        _Alloc>::template rebind_alloc<_Share>;
+    using _ShareTraits = std::allocator_traits<_ShareAlloc>;
+
+    static_assert(sizeof(_Chunk) <= sizeof(_NodeImpl));
+    static_assert(sizeof(_FreeSlot) <= sizeof(_NodeImpl));
+
+    static constexpr size_t _S_min_slots = 8;
+    static constexpr size_t _S_max_chunk_bytes = 64 * 1024;
+    static constexpr size_t _S_max_slots =
+        std::max(_S_min_slots, _S_max_chunk_bytes / sizeof(_NodeImpl));
+
+    _Arena *_M_arena = nullptr; // 本池自己的共享区，第一次申请大块时创建
+    _Share *_M_shares = nullptr;
+    _FreeSlot *_M_free = nullptr;
+    _NodeImpl *_M_cursor = nullptr;     // 最新大块中尚未切分的起始位置
+    _NodeImpl *_M_cursor_end = nullptr; // 最新大块的末尾
+    size_t _M_next_slots = _S_min_slots; // 下一个大块的槽位数，按两倍增长
+    size_t _M_in_use = 0;
+    size_t _M_free_count = 0;
+
+    void _M_grow(const _Alloc &__alloc) {
+        this->_M_add_chunk(__alloc, _M_next_slots);
+        _M_next_slots = std::min(_M_next_slots * 2, _S_max_slots);
+    }
+
+    static bool _S_shares(const _Share *__share,
+                          const _Arena *__arena) noexcept {
+        for (; __share != nullptr; __share = __share->_M_next) {
+            if (__share->_M_arena == __arena) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void _S_unref(_Arena *__arena, const _Alloc &__alloc) noexcept {
+        if (__arena->_M_refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        _NodeAlloc __node_alloc(__alloc);
+        while (__arena->_M_chunks != nullptr) {
+            _Chunk *__chunk = __arena->_M_chunks;
+            __arena->_M_chunks = __chunk->_M_next;
+            _NodeTraits::deallocate(__node_alloc,
+                                    reinterpret_cast<_NodeImpl *>(__chunk),
+                                    __chunk->_M_slots);
+        }
+        _ArenaAlloc __arena_alloc(__alloc);
+        __arena->~_Arena();
+        _ArenaTraits::deallocate(__arena_alloc, __arena, 1);
+    }
+
+    template <class, class, class, class, class>
+    friend struct _RbTreeNodeHandle;
+
+    static void _S_unshare(_Share *__share, const _Alloc &__alloc) noexcept {
+        _ShareAlloc __share_alloc(__alloc);
+        while (__share != nullptr &&
+               __share->_M_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            _Share *__next = __share->_M_next;
+            _RbTreeNodePool::_S_unref(__share->_M_arena, __alloc);
+            __share->~_Share();
+            _ShareTraits::deallocate(__share_alloc, __share, 1);
+            __share = __next;
+        }
+    }
+
+    // 在链头插入对 __arena 的引用，新链节点接过本池对原链头的引用
+    void _M_push_share(_Arena *__arena, const _Alloc &__alloc) {
+        _ShareAlloc __share_alloc(__alloc);
+        _Share *__share = _ShareTraits::allocate(__share_alloc, 1);
+        ::new (static_cast<void *>(__share))
+            _Share{__arena, _M_shares, 1, nullptr};
+        __arena->_M_refs.fetch_add(1, std::memory_order_relaxed);
+        _M_shares = __share;
+    }
+
+    // 撤销 _M_push_share，原链头的引用还给本池
+    void _M_pop_share(const _Alloc &__alloc) noexcept {
+        _ShareAlloc __share_alloc(__alloc);
+        _Share *__share = _M_shares;
+        _M_shares = __share->_M_next;
+        _RbTreeNodePool::_S_unref(__share->_M_arena, __alloc);
+        __share->~_Share();
+        _ShareTraits::deallocate(__share_alloc, __share, 1);
+    }
+
+    // 节点句柄销毁时把槽位压入取出它时的链头，不碰本池的其他状态
+    static void _S_give_back(_Share *__share, _RbTreeNode *__node) noexcept {
+        _FreeSlot *__slot = ::new (static_cast<void *>(__node))
+            _FreeSlot{__share->_M_returned.load(std::memory_order_relaxed)};
+        while (!__share->_M_returned.compare_exchange_weak(
+            __slot->_M_next, __slot, std::memory_order_release,
+            std::memory_order_relaxed)) {
+        }
+    }
+
+    // 把句柄交还的槽位全部挂入空闲链表
+    void _M_reclaim() noexcept {
+        for (_Share *__share = _M_shares; __share != nullptr;
+             __share = __share->_M_next) {
+            _FreeSlot *__slot = __share->_M_returned.exchange(
+                nullptr, std::memory_order_acquire);
+            while (__slot != nullptr) {
+                _FreeSlot *__next = __slot->_M_next;
+                __slot->_M_next = _M_free;
+                _M_free = __slot;
+                ++_M_free_count;
+                __slot = __next;
+            }
+        }
+    }
+
+    void _M_add_chunk(const _Alloc &__alloc, size_t __slots) {
+        if (_M_arena == nullptr) {
+            _ArenaAlloc __arena_alloc(__alloc);
+            _Arena *__arena = _ArenaTraits::allocate(__arena_alloc, 1);
+            ::new (static_cast<void *>(__arena)) _Arena{nullptr, 0};
+            try {
+                this->_M_push_share(__arena, __alloc);
+            } catch (...) {
+                __arena->~_Arena();
+                _ArenaTraits::deallocate(__arena_alloc, __arena, 1);
+                throw;
+            }
+            _M_arena = __arena;
+        }
+        _NodeAlloc __node_alloc(__alloc);
+        _NodeImpl *__mem = _NodeTraits::allocate(__node_alloc, __slots);
+        _M_arena->_M_chunks = ::new (static_cast<void *>(__mem))
+            _Chunk{_M_arena->_M_chunks, __slots};
+        _M_cursor = __mem + 1;
+        _M_cursor_end = __mem + __slots;
+    }
+
+public:
+    _RbTreeNodePool() noexcept = default;
+
+    _RbTreeNodePool(_RbTreeNodePool &&) = delete;
+
+    void _M_swap(_RbTreeNodePool &__that) noexcept {
+        std::swap(_M_arena, __that._M_arena);
+        std::swap(_M_shares, __that._M_shares);
+        std::swap(_M_free, __that._M_free);
+        std::swap(_M_cursor, __that._M_cursor);
+        std::swap(_M_cursor_end, __that._M_cursor_end);
+        std::swap(_M_next_slots, __that._M_next_slots);
+        std::swap(_M_in_use, __that._M_in_use);
+        std::swap(_M_free_count, __that._M_free_count);
+    }
+
+    _NodeImpl *_M_allocate(const _Alloc &__alloc) {
+        ++_M_in_use;
+        if (_M_free == nullptr && _M_cursor == _M_cursor_end) [[unlikely]] {
+            this->_M_reclaim();
+        }
+        if (_M_free != nullptr) {
+            _FreeSlot *__slot = _M_free;
+            _M_free = __slot->_M_next;
+            --_M_free_count;
+            return reinterpret_cast<_NodeImpl *>(__slot);
+        }
+        if (_M_cursor == _M_cursor_end) [[unlikely]] {
+            try {
+                this->_M_grow(__alloc);
+            } catch (...) {
+                --_M_in_use;
+                throw;
+            }
+        }
+        return _M_cursor++;
+    }
+
+    // 一次切出 __n 个连续的槽位；当前大块剩余不够时，把剩余部分挂入空闲链表，
+    // 再单独申请一个恰好够用的大块
+    _NodeImpl *_M_allocate_run(size_t __n, const _Alloc &__alloc) {
+        if (static_cast<size_t>(_M_cursor_end - _M_cursor) < __n) {
+            _NodeImpl *__rest = _M_cursor;
+            _NodeImpl *__rest_end = _M_cursor_end;
+            this->_M_add_chunk(__alloc, __n + 1);
+            for (; __rest != __rest_end; ++__rest) {
+                _M_free = ::new (static_cast<void *>(__rest)) _FreeSlot{_M_free};
+                ++_M_free_count;
+            }
+        }
+        _NodeImpl *__run = _M_cursor;
+        _M_cursor += __n;
+        _M_in_use += __n;
+        return __run;
+    }
+
+    void _M_deallocate(_RbTreeNode *__node) noexcept {
+        _M_free = ::new (static_cast<void *>(__node)) _FreeSlot{_M_free};
+        ++_M_free_count;
+        --_M_in_use;
+    }
+
+    // 节点被 extract 出树：本池不再统计它，句柄拿到当前链头的一个引用，
+    // 足以让节点所在的大块存活到句柄销毁
+    _Share *_M_lend() noexcept {
+        --_M_in_use;
+        _M_shares->_M_refs.fetch_add(1, std::memory_order_relaxed);
+        return _M_shares;
+    }
+
+    // 节点原本出自本池时收回它并返回 true。链只会在头部增长，
+    // 所以本池借出的链头一定还在本池的链上
+    bool _M_take_back(_Share *__share, const _Alloc &__alloc) noexcept {
+        for (_Share *__mine = _M_shares; __mine != nullptr;
+             __mine = __mine->_M_next) {
+            if (__mine == __share) {
+                ++_M_in_use;
+                _RbTreeNodePool::_S_unshare(__share, __alloc);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 引用 __that 的全部共享区，之后才能接收 __that 的节点。
+    // 申请失败时本池保持原样
+    void _M_share(const _RbTreeNodePool &__that, const _Alloc &__alloc) {
+        _Share *__old = _M_shares;
+        try {
+            for (_Share *__share = __that._M_shares; __share != nullptr;
+                 __share = __share->_M_next) {
+                if (!_RbTreeNodePool::_S_shares(_M_shares, __share->_M_arena)) {
+                    this->_M_push_share(__share->_M_arena, __alloc);
+                }
+            }
+        } catch (...) {
+            while (_M_shares != __old) {
+                this->_M_pop_share(__alloc);
+            }
+            throw;
+        }
+    }
+
+    // 接收 __that 中的 __nodes 个节点，调用前必须已经 _M_share 过。
+    // 这些节点以后释放到本池的空闲链表
+    void _M_adopt(_RbTreeNodePool &__that, size_t __nodes) noexcept {
+        __that._M_in_use -= __nodes;
+        _M_in_use += __nodes;
+    }
+
+    // 放弃对大块的引用，最后一个引用者把大块交还给分配器；
+    // 调用前本池分配出去的节点都必须已经析构
+    void _M_release(const _Alloc &__alloc) noexcept {
+        _RbTreeNodePool::_S_unshare(_M_shares, __alloc);
+        _M_shares = nullptr;
+        _M_arena = nullptr;
+        _M_free = nullptr;
+        _M_cursor = _M_cursor_end = nullptr;
+        _M_next_slots = _S_min_slots;
+        _M_free_count = 0;
+    }
+
+    // 只统计本池自己申请的大块，从别的树接收的节点所在的大块归对方统计
+    _RbTreeMemoryStats _M_stats() const noexcept {
+        size_t __chunks = 0, __slots = 0;
+        if (_M_arena != nullptr) {
+            _Chunk *__chunk = _M_arena->_M_chunks;
+            for (; __chunk != nullptr; __chunk = __chunk->_M_next) {
+                ++__chunks;
+                __slots += __chunk->_M_slots;
+            }
+        }
+        return {
+            sizeof(_NodeImpl),
+            _M_in_use,
+            _M_free_count,
+            __slots - __chunks,
+            __chunks,
+            __slots * sizeof(_NodeImpl),
+        };
+    }
+};
+
+// 集合运算中收集节点的单链表，借用节点的 _Link 指针域串起来
+template <_RbTreeNode *_RbTreeNode::*_Link>
+struct _RbTreeNodeChain {
+    _RbTreeNode *_M_head = nullptr;
+    _RbTreeNode **_M_tail = &_M_head;
+    size_t _M_count = 0;
+
+    _RbTreeNodeChain() noexcept = default;
+
+    _RbTreeNodeChain(_RbTreeNodeChain &&) = delete;
+
+    void _M_push(_RbTreeNode *__node) noexcept {
+        __node->*_Link = nullptr;
+        *_M_tail = __node;
+        _M_tail = &(__node->*_Link);
+        ++_M_count;
+    }
+
+    void _M_splice(_RbTreeNodeChain &__that) noexcept {
+        if (__that._M_head == nullptr) {
+            return;
+        }
+        *_M_tail = __that._M_head;
+        _M_tail = __that._M_tail;
+        _M_count += __that._M_count;
+        __that._M_head = nullptr;
+        __that._M_tail = &__that._M_head;
+        __that._M_count = 0;
+    }
+};
+
+// 按中序串起来的节点（并集中被挤掉的重复节点）
+using _RbTreeNodeList = _RbTreeNodeChain<&_RbTreeNode::_M_right>;
+// 待销毁的子树，各子树的根经由 _M_parent 串起来
+using _RbTreeDropList = _RbTreeNodeChain<&_RbTreeNode::_M_parent>;
+
 struct _RbTreeBase {
 protected:
-    _RbTreeRoot *_M_block;
+    _RbTreeRoot _M_block;
+
+    _RbTreeBase() noexcept : _M_block{nullptr, nullptr} {}
+
+    // 根节点的 _M_pparent 指向所在树的 _M_block，交换后要改指过来
+    void _M_swap_root(_RbTreeBase &__that) noexcept {
+        std::swap(_M_block, __that._M_block);
+        if (_M_block._M_root != nullptr) {
+            _M_block._M_root->_M_pparent = &_M_block._M_root;
+        }
+        if (__that._M_block._M_root != nullptr) {
+            __that._M_block._M_root->_M_pparent = &__that._M_block._M_root;
+        }
+    }
+
+    static size_t _S_size(const _RbTreeNode *__node) noexcept {
+        return __node != nullptr ? __node->_M_size : 0;
+    }
 
-    explicit _RbTreeBase(_RbTreeRoot *__block) : _M_block(__block) {}
+    static void _S_update_size(_RbTreeNode *__node) noexcept {
+        __node->_M_size = static_cast<std::uint32_t>(
+            _RbTreeBase::_S_size(__node->_M_left) +
+            _RbTreeBase::_S_size(__node->_M_right) + 1);
+    }
 
-    template <class _Type, class _Alloc>
-    static _Type *_M_allocate(_Alloc __alloc) {
-        typename std::allocator_traits<_Alloc>::template rebind_alloc<_Type>
-            __rebind_alloc(__alloc);
-        return std::allocator_traits<_Alloc>::template rebind_traits<
-            _Type>::allocate(__rebind_alloc, sizeof(_Type));
+    // 从 __node 到根的路径上每个节点的子树大小都加上 __delta
+    static void _S_add_size(_RbTreeNode *__node,
+                            std::uint32_t __delta) noexcept {
+        for (; __node != nullptr; __node = __node->_M_parent) {
+            __node->_M_size += __delta;
+        }
     }
 
-    template <class _Type, class _Alloc>
-    static void _M_deallocate(_Alloc __alloc, void *__ptr) noexcept {
-        typename std::allocator_traits<_Alloc>::template rebind_alloc<_Type>
-            __rebind_alloc(__alloc);
-        std::allocator_traits<_Alloc>::template rebind_traits<
-            _Type>::deallocate(__rebind_alloc, static_cast<_Type *>(__ptr),
-                               sizeof(_Type));
+    // 中序第 __index 个节点（从 0 开始），越界时返回空指针
+    static _RbTreeNode *_S_select(_RbTreeNode *__node, size_t __index) noexcept {
+        while (__node != nullptr) {
+            size_t __left = _RbTreeBase::_S_size(__node->_M_left);
+            if (__index == __left) {
+                break;
+            }
+            if (__index < __left) {
+                __node = __node->_M_left;
+            } else {
+                __index -= __left + 1;
+                __node = __node->_M_right;
+            }
+        }
+        return __node;
+    }
+
+    // __node 在整棵树中的中序下标：沿父链向上，累加左侧兄弟子树的大小
+    static size_t _S_index(const _RbTreeNode *__node) noexcept {
+        size_t __index = _RbTreeBase::_S_size(__node->_M_left);
+        for (; __node->_M_parent != nullptr; __node = __node->_M_parent) {
+            if (__node->_M_pparent == &__node->_M_parent->_M_right) {
+                __index += _RbTreeBase::_S_size(__node->_M_parent->_M_left) + 1;
+            }
+        }
+        return __index;
     }
 
     static void _M_rotate_left(_RbTreeNode *__node) noexcept {
@@ -283,6 +701,8 @@ protected:
         __right->_M_left = __node;
         __node->_M_parent = __right;
         __node->_M_pparent = &__right->_M_left;
+        __right->_M_size = __node->_M_size;
+        _RbTreeBase::_S_update_size(__node);
     }
 
     static void _M_rotate_right(_RbTreeNode *__node) noexcept {
@@ -298,6 +718,8 @@ protected:
         __left->_M_right = __node;
         __node->_M_parent = __left;
         __node->_M_pparent = &__left->_M_right;
+        __left->_M_size = __node->_M_size;
+        _RbTreeBase::_S_update_size(__node);
     }
 
     static void _M_fix_violation(_RbTreeNode *__node) noexcept {
@@ -357,8 +779,291 @@ protected:
         }
     }
 
+    // ---- 基于 join 的集合运算 ----
+    // 以下函数都作用于从树上拆下来的子树：子树的根可能是红色，
+    // 其 _M_parent、_M_pparent 不可信，由接收它的一方重新设置
+
+    static void _S_attach(_RbTreeNode *__parent, _RbTreeNode **__pparent,
+                          _RbTreeNode *__child) noexcept {
+        *__pparent = __child;
+        if (__child != nullptr) {
+            __child->_M_parent = __parent;
+            __child->_M_pparent = __pparent;
+        }
+    }
+
+    // 黑高：沿最左链走到空指针经过的黑色节点数
+    static size_t _S_black_height(const _RbTreeNode *__node) noexcept {
+        size_t __height = 0;
+        for (; __node != nullptr; __node = __node->_M_left) {
+            __height += __node->_M_color == _S_black;
+        }
+        return __height;
+    }
+
+    // 把 __left、__mid、__right 连成一棵树，要求 __left < __mid < __right
+    // 黑高相等时 __mid 直接作根；否则沿较高一侧的边缘链下降到黑高相等的
+    // 黑色节点处，用红色的 __mid 顶替它，再按插入的方式向上修复
+    static _RbTreeNode *_S_join(_RbTreeNode *__left, _RbTreeNode *__mid,
+                                _RbTreeNode *__right) noexcept {
+        if (__left != nullptr) {
+            __left->_M_color = _S_black;
+        }
+        if (__right != nullptr) {
+            __right->_M_color = _S_black;
+        }
+        size_t __left_height = _RbTreeBase::_S_black_height(__left);
+        size_t __right_height = _RbTreeBase::_S_black_height(__right);
+        __mid->_M_parent = nullptr;
+        if (__left_height == __right_height) {
+            __mid->_M_color = _S_black;
+            _RbTreeBase::_S_attach(__mid, &__mid->_M_left, __left);
+            _RbTreeBase::_S_attach(__mid, &__mid->_M_right, __right);
+            _RbTreeBase::_S_update_size(__mid);
+            return __mid;
+        }
+        bool __descend_right = __left_height > __right_height;
+        _RbTreeNode *__root = __descend_right ? __left : __right;
+        size_t __height = __descend_right ? __left_height : __right_height;
+        size_t __target = __descend_right ? __right_height : __left_height;
+        __root->_M_parent = nullptr;
+        __root->_M_pparent = &__root; // 旋转到根时经由它更新 __root
+        _RbTreeNode *__parent = nullptr;
+        _RbTreeNode **__pparent = &__root;
+        _RbTreeNode *__current = __root;
+        while (__height > __target || __current->_M_color == _S_red) {
+            __height -= __current->_M_color == _S_black;
+            __parent = __current;
+            __pparent = __descend_right ? &__current->_M_right
+                                        : &__current->_M_left;
+            __current = *__pparent;
+            if (__current == nullptr) {
+                break;
+            }
+        }
+        __mid->_M_color = _S_red;
+        if (__descend_right) {
+            _RbTreeBase::_S_attach(__mid, &__mid->_M_left, __current);
+            _RbTreeBase::_S_attach(__mid, &__mid->_M_right, __right);
+        } else {
+            _RbTreeBase::_S_attach(__mid, &__mid->_M_left, __left);
+            _RbTreeBase::_S_attach(__mid, &__mid->_M_right, __current);
+        }
+        _RbTreeBase::_S_update_size(__mid);
+        _RbTreeBase::_S_add_size(__parent,
+                                 static_cast<std::uint32_t>(
+                                     _RbTreeBase::_S_size(__mid) -
+                                     _RbTreeBase::_S_size(__current)));
+        _RbTreeBase::_S_attach(__parent, __pparent, __mid);
+        _RbTreeBase::_M_fix_violation(__mid);
+        return __root;
+    }
+
+    // 拆下子树中最大的节点放进 __last，返回其余部分
+    static _RbTreeNode *_S_split_last(_RbTreeNode *__node,
+                                      _RbTreeNode *&__last) noexcept {
+        if (__node->_M_right == nullptr) {
+            __last = __node;
+            return __node->_M_left;
+        }
+        _RbTreeNode *__rest =
+            _RbTreeBase::_S_split_last(__node->_M_right, __last);
+        return _RbTreeBase::_S_join(__node->_M_left, __node, __rest);
+    }
+
+    // 没有中间节点的 join，要求 __left < __right
+    static _RbTreeNode *_S_join2(_RbTreeNode *__left,
+                                 _RbTreeNode *__right) noexcept {
+        if (__left == nullptr) {
+            return __right;
+        }
+        if (__right == nullptr) {
+            return __left;
+        }
+        _RbTreeNode *__last;
+        __left = _RbTreeBase::_S_split_last(__left, __last);
+        return _RbTreeBase::_S_join(__left, __last, __right);
+    }
+
+    // 按 __value 把子树拆成 __less 和 __greater 两部分。与 __value 等价的节点：
+    // _Multi 时归入 __greater，否则单独拆下来作为返回值（左右指针不再有效）
+    template <bool _Multi, class _NodeImpl, class _Tv, class _Compare>
+    static _RbTreeNode *_S_split(_RbTreeNode *__node, const _Tv &__value,
+                                 _Compare &__comp, _RbTreeNode *&__less,
+                                 _RbTreeNode *&__greater) noexcept {
+        if (__node == nullptr) {
+            __less = __greater = nullptr;
+            return nullptr;
+        }
+        _RbTreeNode *__left = __node->_M_left;
+        _RbTreeNode *__right = __node->_M_right;
+        _RbTreeNode *__part;
+        _RbTreeNode *__found;
+        if (__comp(static_cast<_NodeImpl *>(__node)->_M_value, __value)) {
+            __found = _RbTreeBase::_S_split<_Multi, _NodeImpl>(
+                __right, __value, __comp, __part, __greater);
+            __less = _RbTreeBase::_S_join(__left, __node, __part);
+            return __found;
+        }
+        if (_Multi ||
+            __comp(__value, static_cast<_NodeImpl *>(__node)->_M_value)) {
+            __found = _RbTreeBase::_S_split<_Multi, _NodeImpl>(
+                __left, __value, __comp, __less, __part);
+            __greater = _RbTreeBase::_S_join(__part, __node, __right);
+            return __found;
+        }
+        __less = __left;
+        __greater = __right;
+        return __node;
+    }
+
+    // 两棵子树都至少有 2^_S_fork_height - 1 个节点时才值得开新线程
+    static constexpr size_t _S_fork_height = 12;
+
+    static int _S_fork_budget() noexcept {
+        unsigned __threads = std::thread::hardware_concurrency();
+        return __threads > 1 ? std::bit_width(__threads - 1) : 0;
+    }
+
+    static bool _S_should_fork(int __budget, const _RbTreeNode *__lhs,
+                               const _RbTreeNode *__rhs) noexcept {
+        return __budget > 0 &&
+               _RbTreeBase::_S_black_height(__lhs) >= _S_fork_height &&
+               _RbTreeBase::_S_black_height(__rhs) >= _S_fork_height;
+    }
+
+    // 执行两个互不相干的子任务，__parallel 时把第一个交给新线程
+    template <class _Fn1, class _Fn2>
+    static void _S_fork(bool __parallel, _Fn1 &&__first,
+                        _Fn2 &&__second) noexcept {
+        std::thread __worker;
+        if (__parallel) {
+            try {
+                __worker = std::thread(std::ref(__first));
+            } catch (...) { // 开不出线程就在当前线程做
+                __parallel = false;
+            }
+        }
+        if (!__parallel) {
+            __first();
+        }
+        __second();
+        if (__parallel) {
+            __worker.join();
+        }
+    }
+
+    // 并集：__rhs 中与 __lhs 重复的节点（_Multi 时没有）按顺序收进 __dups
+    template <bool _Multi, class _NodeImpl, class _Compare>
+    static _RbTreeNode *_S_union(_RbTreeNode *__lhs, _RbTreeNode *__rhs,
+                                 _Compare &__comp, _RbTreeNodeList &__dups,
+                                 int __budget) noexcept {
+        if (__lhs == nullptr) {
+            return __rhs;
+        }
+        if (__rhs == nullptr) {
+            return __lhs;
+        }
+        bool __parallel = _RbTreeBase::_S_should_fork(__budget, __lhs, __rhs);
+        __budget -= __parallel;
+        _RbTreeNode *__rhs_less, *__rhs_greater;
+        _RbTreeNode *__dup = _RbTreeBase::_S_split<_Multi, _NodeImpl>(
+            __rhs, static_cast<_NodeImpl *>(__lhs)->_M_value, __comp,
+            __rhs_less, __rhs_greater);
+        _RbTreeNode *__left = __lhs->_M_left;
+        _RbTreeNode *__right = __lhs->_M_right;
+        _RbTreeNodeList __right_dups;
+        _RbTreeBase::_S_fork(
+            __parallel,
+            [&] {
+                __left = _RbTreeBase::_S_union<_Multi, _NodeImpl>(
+                    __left, __rhs_less, __comp, __dups, __budget);
+            },
+            [&] {
+                __right = _RbTreeBase::_S_union<_Multi, _NodeImpl>(
+                    __right, __rhs_greater, __comp, __right_dups, __budget);
+            });
+        if (__dup != nullptr) {
+            __dups._M_push(__dup);
+        }
+        __dups._M_splice(__right_dups);
+        return _RbTreeBase::_S_join(__left, __lhs, __right);
+    }
+
+    // 交集与差集：只读地沿 __rhs 的结构拆分 __lhs，丢弃的子树收进 __drops
+    template <bool _Intersect, class _NodeImpl, class _Compare>
+    static _RbTreeNode *_S_filter(_RbTreeNode *__lhs, const _RbTreeNode *__rhs,
+                                  _Compare &__comp, _RbTreeDropList &__drops,
+                                  int __budget) noexcept {
+        if (__lhs == nullptr) {
+            return nullptr;
+        }
+        if (__rhs == nullptr) {
+            if (!_Intersect) {
+                return __lhs;
+            }
+            __drops._M_push(__lhs);
+            return nullptr;
+        }
+        bool __parallel = _RbTreeBase::_S_should_fork(__budget, __lhs, __rhs);
+        __budget -= __parallel;
+        _RbTreeNode *__less, *__greater;
+        _RbTreeNode *__found = _RbTreeBase::_S_split<false, _NodeImpl>(
+            __lhs, static_cast<const _NodeImpl *>(__rhs)->_M_value, __comp,
+            __less, __greater);
+        _RbTreeDropList __right_drops;
+        _RbTreeBase::_S_fork(
+            __parallel,
+            [&] {
+                __less = _RbTreeBase::_S_filter<_Intersect, _NodeImpl>(
+                    __less, __rhs->_M_left, __comp, __drops, __budget);
+            },
+            [&] {
+                __greater = _RbTreeBase::_S_filter<_Intersect, _NodeImpl>(
+                    __greater, __rhs->_M_right, __comp, __right_drops,
+                    __budget);
+            });
+        __drops._M_splice(__right_drops);
+        if (__found == nullptr) {
+            return _RbTreeBase::_S_join2(__less, __greater);
+        }
+        if (_Intersect) {
+            return _RbTreeBase::_S_join(__less, __found, __greater);
+        }
+        __found->_M_left = __found->_M_right = nullptr;
+        __drops._M_push(__found);
+        return _RbTreeBase::_S_join2(__less, __greater);
+    }
+
+    // 把链表中按中序排好的 __count 个节点连成完全平衡的子树，
+    // 与 _S_link_balanced 一样把不满的最底一层染红
+    static _RbTreeNode *_S_link_list(_RbTreeNode *&__cursor, size_t __count,
+                                     size_t __depth,
+                                     size_t __red_depth) noexcept {
+        if (__count == 0) {
+            return nullptr;
+        }
+        _RbTreeNode *__left = _RbTreeBase::_S_link_list(
+            __cursor, __count / 2, __depth + 1, __red_depth);
+        _RbTreeNode *__node = __cursor;
+        __cursor = __cursor->_M_right;
+        __node->_M_color = __depth == __red_depth ? _S_red : _S_black;
+        _RbTreeBase::_S_attach(__node, &__node->_M_left, __left);
+        _RbTreeNode *__right = _RbTreeBase::_S_link_list(
+            __cursor, __count - __count / 2 - 1, __depth + 1, __red_depth);
+        _RbTreeBase::_S_attach(__node, &__node->_M_right, __right);
+        __node->_M_size = static_cast<std::uint32_t>(__count);
+        return __node;
+    }
+
+    static size_t _S_red_depth(size_t __count) noexcept {
+        // 只有一个节点时根保持黑色
+        return __count > 1 ? static_cast<size_t>(std::bit_width(__count)) - 1
+                           : static_cast<size_t>(-1);
+    }
+
     _RbTreeNode *_M_min_node() const noexcept {
-        _RbTreeNode *__current = _M_block->_M_root;
+        _RbTreeNode *__current = _M_block._M_root;
         if (__current != nullptr) {
             while (__current->_M_left != nullptr) {
                 __current = __current->_M_left;
@@ -368,7 +1073,7 @@ protected:
     }
 
     _RbTreeNode *_M_max_node() const noexcept {
-        _RbTreeNode *__current = _M_block->_M_root;
+        _RbTreeNode *__current = _M_block._M_root;
         if (__current != nullptr) {
             while (__current->_M_right != nullptr) {
                 __current = __current->_M_right;
@@ -379,7 +1084,7 @@ protected:
 
     template <class _NodeImpl, class _Tv, class _Compare>
     _RbTreeNode *_M_find_node(_Tv &&__value, _Compare __comp) const noexcept {
-        _RbTreeNode *__current = _M_block->_M_root;
+        _RbTreeNode *__current = _M_block._M_root;
         while (__current != nullptr) {
             if (__comp(__value,
                        static_cast<_NodeImpl *>(__current)->_M_value)) {
@@ -399,7 +1104,7 @@ protected:
 
     template <class _NodeImpl, class _Tv, class _Compare>
     _RbTreeNode *_M_lower_bound(_Tv &&__value, _Compare __comp) const noexcept {
-        _RbTreeNode *__current = _M_block->_M_root;
+        _RbTreeNode *__current = _M_block._M_root;
         _RbTreeNode *__result = nullptr;
         while (__current != nullptr) {
             if (!(__comp(static_cast<_NodeImpl *>(__current)->_M_value,
@@ -415,7 +1120,7 @@ protected:
 
     template <class _NodeImpl, class _Tv, class _Compare>
     _RbTreeNode *_M_upper_bound(_Tv &&__value, _Compare __comp) const noexcept {
-        _RbTreeNode *__current = _M_block->_M_root;
+        _RbTreeNode *__current = _M_block._M_root;
         _RbTreeNode *__result = nullptr;
         while (__current != nullptr) {
             if (__comp(__value,
@@ -446,94 +1151,102 @@ protected:
         }
     }
 
-    static void _M_delete_fixup(_RbTreeNode *__node) noexcept {
-        if (__node == nullptr) {
-            return;
-        }
-        while (__node->_M_parent != nullptr && __node->_M_color == _S_black) {
+    static bool _M_is_black(_RbTreeNode *__node) noexcept {
+        return __node == nullptr || __node->_M_color == _S_black;
+    }
+
+    // __node 可能为空（被删除节点没有子节点），所以需要额外传入 __parent
+    static void _M_delete_fixup(_RbTreeNode *__node,
+                                _RbTreeNode *__parent) noexcept {
+        while (__parent != nullptr && _RbTreeBase::_M_is_black(__node)) {
+            // 红黑树性质保证兄弟节点一定存在，所以 __node 为空时也能判断方向
             _RbTreeChildDir __dir =
-                __node->_M_pparent == &__node->_M_parent->_M_left ? _S_left
-                                                                  : _S_right;
-            _RbTreeNode *__sibling = __dir == _S_left
-                                         ? __node->_M_parent->_M_right
-                                         : __node->_M_parent->_M_left;
+                __parent->_M_left == __node ? _S_left : _S_right;
+            _RbTreeNode *__sibling =
+                __dir == _S_left ? __parent->_M_right : __parent->_M_left;
             if (__sibling->_M_color == _S_red) {
                 __sibling->_M_color = _S_black;
-                __node->_M_parent->_M_color = _S_red;
+                __parent->_M_color = _S_red;
                 if (__dir == _S_left) {
-                    _RbTreeBase::_M_rotate_left(__node->_M_parent);
+                    _RbTreeBase::_M_rotate_left(__parent);
                 } else {
-                    _RbTreeBase::_M_rotate_right(__node->_M_parent);
+                    _RbTreeBase::_M_rotate_right(__parent);
                 }
-                __sibling = __dir == _S_left ? __node->_M_parent->_M_right
-                                             : __node->_M_parent->_M_left;
+                __sibling =
+                    __dir == _S_left ? __parent->_M_right : __parent->_M_left;
+            }
+            if (_RbTreeBase::_M_is_black(__sibling->_M_left) &&
+                _RbTreeBase::_M_is_black(__sibling->_M_right)) {
+                __sibling->_M_color = _S_red;
+                __node = __parent;
+                __parent = __node->_M_parent;
+                continue;
             }
-            if (__sibling->_M_left->_M_color == _S_black &&
-                __sibling->_M_right->_M_color == _S_black) {
+            if (__dir == _S_left &&
+                _RbTreeBase::_M_is_black(__sibling->_M_right)) {
+                __sibling->_M_left->_M_color = _S_black;
+                __sibling->_M_color = _S_red;
+                _RbTreeBase::_M_rotate_right(__sibling);
+                __sibling = __parent->_M_right;
+            } else if (__dir == _S_right &&
+                       _RbTreeBase::_M_is_black(__sibling->_M_left)) {
+                __sibling->_M_right->_M_color = _S_black;
                 __sibling->_M_color = _S_red;
-                __node = __node->_M_parent;
+                _RbTreeBase::_M_rotate_left(__sibling);
+                __sibling = __parent->_M_left;
+            }
+            __sibling->_M_color = __parent->_M_color;
+            __parent->_M_color = _S_black;
+            if (__dir == _S_left) {
+                __sibling->_M_right->_M_color = _S_black;
+                _RbTreeBase::_M_rotate_left(__parent);
             } else {
-                if (__dir == _S_left &&
-                    __sibling->_M_right->_M_color == _S_black) {
-                    __sibling->_M_left->_M_color = _S_black;
-                    __sibling->_M_color = _S_red;
-                    _RbTreeBase::_M_rotate_right(__sibling);
-                    __sibling = __node->_M_parent->_M_right;
-                } else if (__dir == _S_right &&
-                           __sibling->_M_left->_M_color == _S_black) {
-                    __sibling->_M_right->_M_color = _S_black;
-                    __sibling->_M_color = _S_red;
-                    _RbTreeBase::_M_rotate_left(__sibling);
-                    __sibling = __node->_M_parent->_M_left;
-                }
-                __sibling->_M_color = __node->_M_parent->_M_color;
-                __node->_M_parent->_M_color = _S_black;
-                if (__dir == _S_left) {
-                    __sibling->_M_right->_M_color = _S_black;
-                    _RbTreeBase::_M_rotate_left(__node->_M_parent);
-                } else {
-                    __sibling->_M_left->_M_color = _S_black;
-                    _RbTreeBase::_M_rotate_right(__node->_M_parent);
-                }
-                // while (__node->_M_parent != nullptr) {
-                //     __node = __node->_M_parent;
-                // }
-                break;
+                __sibling->_M_left->_M_color = _S_black;
+                _RbTreeBase::_M_rotate_right(__parent);
             }
+            return;
+        }
+        if (__node != nullptr) {
+            __node->_M_color = _S_black;
         }
-        __node->_M_color = _S_black;
     }
 
-    // 如果树中已存在相同值的节点，则不插入（用于set、map）
-    static void _M_erase_node(_RbTreeNode *__node) noexcept {
-        if (__node->_M_left == nullptr) {
-            _RbTreeNode *__right = __node->_M_right;
-            _RbTreeColor __color = __node->_M_color;
-            _RbTreeBase::_M_transplant(__node, __right);
-            if (__color == _S_black) {
-                _RbTreeBase::_M_delete_fixup(__right);
+    void _M_erase_node(_RbTreeNode *__node) noexcept {
+        if (__node == _M_block._M_rightmost) {
+            _M_block._M_rightmost = _RbTreeBase::_S_prev_node(__node);
+        }
+        _RbTreeNode *__child;
+        _RbTreeNode *__parent;
+        _RbTreeColor __color = __node->_M_color;
+        // 真正从结构中摘掉的位置：有两个子节点时是后继所在的位置
+        _RbTreeNode *__removed = __node;
+        if (__node->_M_left != nullptr && __node->_M_right != nullptr) {
+            __removed = __node->_M_right;
+            while (__removed->_M_left != nullptr) {
+                __removed = __removed->_M_left;
             }
+        }
+        _RbTreeBase::_S_add_size(__removed->_M_parent, std::uint32_t(-1));
+        if (__node->_M_left == nullptr) {
+            __child = __node->_M_right;
+            __parent = __node->_M_parent;
+            _RbTreeBase::_M_transplant(__node, __child);
         } else if (__node->_M_right == nullptr) {
-            _RbTreeNode *__left = __node->_M_left;
-            _RbTreeColor __color = __node->_M_color;
-            _RbTreeBase::_M_transplant(__node, __left);
-            if (__color == _S_black) {
-                _RbTreeBase::_M_delete_fixup(__left);
-            }
+            __child = __node->_M_left;
+            __parent = __node->_M_parent;
+            _RbTreeBase::_M_transplant(__node, __child);
         } else {
             _RbTreeNode *__replace = __node->_M_right;
             while (__replace->_M_left != nullptr) {
                 __replace = __replace->_M_left;
             }
-            _RbTreeNode *__right = __replace->_M_right;
-            _RbTreeColor __color = __replace->_M_color;
+            __color = __replace->_M_color;
+            __child = __replace->_M_right;
             if (__replace->_M_parent == __node) {
-                if (__right != nullptr) {
-                    __right->_M_parent = __replace;
-                    __right->_M_pparent = &__replace->_M_right;
-                }
+                __parent = __replace;
             } else {
-                _RbTreeBase::_M_transplant(__replace, __right);
+                __parent = __replace->_M_parent;
+                _RbTreeBase::_M_transplant(__replace, __child);
                 __replace->_M_right = __node->_M_right;
                 __replace->_M_right->_M_parent = __replace;
                 __replace->_M_right->_M_pparent = &__replace->_M_right;
@@ -542,16 +1255,143 @@ protected:
             __replace->_M_left = __node->_M_left;
             __replace->_M_left->_M_parent = __replace;
             __replace->_M_left->_M_pparent = &__replace->_M_left;
-            if (__color == _S_black) {
-                _RbTreeBase::_M_delete_fixup(__right);
+            __replace->_M_color = __node->_M_color;
+            __replace->_M_size = __node->_M_size;
+        }
+        if (__color == _S_black) {
+            _RbTreeBase::_M_delete_fixup(__child, __parent);
+        }
+    }
+
+    // 把新节点作为红色叶子挂到 __parent 的空位 *__pparent 上，再恢复平衡
+    void _M_link_node(_RbTreeNode *__node, _RbTreeNode *__parent,
+                      _RbTreeNode **__pparent) noexcept {
+        if (__parent == _M_block._M_rightmost &&
+            (__parent == nullptr || __pparent == &__parent->_M_right)) {
+            _M_block._M_rightmost = __node;
+        }
+        __node->_M_left = nullptr;
+        __node->_M_right = nullptr;
+        __node->_M_color = _S_red;
+        __node->_M_size = 1;
+
+        __node->_M_parent = __parent;
+        __node->_M_pparent = __pparent;
+        *__pparent = __node;
+        _RbTreeBase::_S_add_size(__parent, 1);
+        _RbTreeBase::_M_fix_violation(__node);
+    }
+
+    static _RbTreeNode *_S_prev_node(_RbTreeNode *__node) noexcept {
+        if (__node->_M_left != nullptr) {
+            __node = __node->_M_left;
+            while (__node->_M_right != nullptr) {
+                __node = __node->_M_right;
             }
+            return __node;
+        }
+        while (__node->_M_parent != nullptr &&
+               __node->_M_pparent == &__node->_M_parent->_M_left) {
+            __node = __node->_M_parent;
         }
+        return __node->_M_parent;
     }
 
-    // 允许插入重复值节点（multiset、multimap）
+    static _RbTreeNode *_S_next_node(_RbTreeNode *__node) noexcept {
+        if (__node->_M_right != nullptr) {
+            __node = __node->_M_right;
+            while (__node->_M_left != nullptr) {
+                __node = __node->_M_left;
+            }
+            return __node;
+        }
+        while (__node->_M_parent != nullptr &&
+               __node->_M_pparent == &__node->_M_parent->_M_right) {
+            __node = __node->_M_parent;
+        }
+        return __node->_M_parent;
+    }
+
+    // 把 __node 挂到相邻的 __prev 与 __next 之间（任一可为空，表示在两端）
+    // 中序相邻的两个节点里必有一个在对应一侧是空位
+    void _M_link_between(_RbTreeNode *__node, _RbTreeNode *__prev,
+                         _RbTreeNode *__next) noexcept {
+        if (__prev != nullptr && __prev->_M_right == nullptr) {
+            _RbTreeBase::_M_link_node(__node, __prev, &__prev->_M_right);
+        } else if (__next != nullptr) {
+            _RbTreeBase::_M_link_node(__node, __next, &__next->_M_left);
+        } else {
+            _RbTreeBase::_M_link_node(__node, nullptr, &_M_block._M_root);
+        }
+    }
+
+    // 带提示位置的插入（用于set、map），__hint 为空表示 end()
+    // 新值恰好落在 __hint 与其前驱（或后继）之间时只需两次比较就能直接挂上，
+    // 提示不对时退回从根开始查找
+    template <class _NodeImpl, class _Compare>
+    _RbTreeNode *_M_single_insert_node_hint(_RbTreeNode *__hint,
+                                            _RbTreeNode *__node,
+                                            _Compare __comp) {
+        auto &__value = static_cast<_NodeImpl *>(__node)->_M_value;
+        if (__hint == nullptr) {
+            _RbTreeNode *__last = _M_block._M_rightmost;
+            if (__last != nullptr &&
+                __comp(static_cast<_NodeImpl *>(__last)->_M_value, __value)) {
+                _RbTreeBase::_M_link_node(__node, __last, &__last->_M_right);
+                return nullptr;
+            }
+        } else if (__comp(__value,
+                          static_cast<_NodeImpl *>(__hint)->_M_value)) {
+            _RbTreeNode *__prev = _RbTreeBase::_S_prev_node(__hint);
+            if (__prev == nullptr ||
+                __comp(static_cast<_NodeImpl *>(__prev)->_M_value, __value)) {
+                this->_M_link_between(__node, __prev, __hint);
+                return nullptr;
+            }
+        } else if (__comp(static_cast<_NodeImpl *>(__hint)->_M_value,
+                          __value)) {
+            _RbTreeNode *__next = __hint == _M_block._M_rightmost
+                                      ? nullptr
+                                      : _RbTreeBase::_S_next_node(__hint);
+            if (__next == nullptr ||
+                __comp(__value, static_cast<_NodeImpl *>(__next)->_M_value)) {
+                this->_M_link_between(__node, __hint, __next);
+                return nullptr;
+            }
+        } else {
+            return __hint;
+        }
+        return this->_M_single_insert_node<_NodeImpl>(__node, __comp);
+    }
+
+    // 带提示位置的插入（multiset、multimap），尽量插在 __hint 之前
+    template <class _NodeImpl, class _Compare>
+    void _M_multi_insert_node_hint(_RbTreeNode *__hint, _RbTreeNode *__node,
+                                   _Compare __comp) {
+        auto &__value = static_cast<_NodeImpl *>(__node)->_M_value;
+        if (__hint == nullptr) {
+            _RbTreeNode *__last = _M_block._M_rightmost;
+            if (__last != nullptr &&
+                !__comp(__value, static_cast<_NodeImpl *>(__last)->_M_value)) {
+                _RbTreeBase::_M_link_node(__node, __last, &__last->_M_right);
+                return;
+            }
+        } else if (!__comp(static_cast<_NodeImpl *>(__hint)->_M_value,
+                           __value)) {
+            _RbTreeNode *__prev = _RbTreeBase::_S_prev_node(__hint);
+            if (__prev == nullptr ||
+                !__comp(__value, static_cast<_NodeImpl *>(__prev)->_M_value)) {
+                this->_M_link_between(__node, __prev, __hint);
+                return;
+            }
+        }
+        this->_M_multi_insert_node<_NodeImpl>(__node, __comp);
+    }
+
+    // 如果树中已存在相同值的节点，则不插入（用于set、map）
     template <class _NodeImpl, class _Compare>
     _RbTreeNode *_M_single_insert_node(_RbTreeNode *__node, _Compare __comp) {
-        _RbTreeNode **__pparent = &_M_block->_M_root;
+        _RbTreeNode **__pparent = &_M_block._M_root;
         _RbTreeNode *__parent = nullptr;
         while (*__pparent != nullptr) {
             __parent = *__pparent;
@@ -568,20 +1408,14 @@ protected:
             return __parent;
         }
 
-        __node->_M_left = nullptr;
-        __node->_M_right = nullptr;
-        __node->_M_color = _S_red;
-
-        __node->_M_parent = __parent;
-        __node->_M_pparent = __pparent;
-        *__pparent = __node;
-        _RbTreeBase::_M_fix_violation(__node);
+        _RbTreeBase::_M_link_node(__node, __parent, __pparent);
         return nullptr;
     }
 
+    // 允许插入重复值节点（multiset、multimap）
     template <class _NodeImpl, class _Compare>
     void _M_multi_insert_node(_RbTreeNode *__node, _Compare __comp) {
-        _RbTreeNode **__pparent = &_M_block->_M_root;
+        _RbTreeNode **__pparent = &_M_block._M_root;
         _RbTreeNode *__parent = nullptr;
         while (*__pparent != nullptr) {
             __parent = *__pparent;
@@ -598,14 +1432,7 @@ protected:
             __pparent = &__parent->_M_right;
         }
 
-        __node->_M_left = nullptr;
-        __node->_M_right = nullptr;
-        __node->_M_color = _S_red;
-
-        __node->_M_parent = __parent;
-        __node->_M_pparent = __pparent;
-        *__pparent = __node;
-        _RbTreeBase::_M_fix_violation(__node);
+        _RbTreeBase::_M_link_node(__node, __parent, __pparent);
     }
 };
 
@@ -613,36 +1440,59 @@ template <class _Tp, class _Compare, class _Alloc, class _NodeImpl,
           class = void>
 struct _RbTreeNodeHandle {
 protected:
+    using _Pool = _RbTreeNodePool<_NodeImpl, _Alloc>;
+    using _Share = typename _Pool::_Share;
+
     _NodeImpl *_M_node;
+    // 取出节点时所在节点池的链头，句柄存活期间节点所在的大块不会被释放。
+    // 句柄只通过原子操作使用它，可以交给别的线程销毁
+    _Share *_M_share;
     [[no_unique_address]] _Alloc _M_alloc;
 
-    _RbTreeNodeHandle(_NodeImpl *__node, _Alloc __alloc) noexcept
+    _RbTreeNodeHandle(_NodeImpl *__node, _Share *__share,
+                      _Alloc __alloc) noexcept
         : _M_node(__node),
+          _M_share(__share),
           _M_alloc(__alloc) {}
 
     template <class, class, class, class>
     friend struct _RbTreeImpl;
 
 public:
-    _RbTreeNodeHandle() noexcept : _M_node(nullptr) {}
+    _RbTreeNodeHandle() noexcept : _M_node(nullptr), _M_share(nullptr) {}
 
     _RbTreeNodeHandle(_RbTreeNodeHandle &&__that) noexcept
-        : _M_node(__that._M_node) {
+        : _M_node(__that._M_node),
+          _M_share(__that._M_share),
+          _M_alloc(__that._M_alloc) {
         __that._M_node = nullptr;
+        __that._M_share = nullptr;
     }
 
     _RbTreeNodeHandle &operator=(_RbTreeNodeHandle &&__that) noexcept {
         std::swap(_M_node, __that._M_node);
+        std::swap(_M_share, __that._M_share);
+        std::swap(_M_alloc, __that._M_alloc);
         return *this;
     }
 
+    bool empty() const noexcept {
+        return _M_node == nullptr;
+    }
+
+    explicit operator bool() const noexcept {
+        return _M_node != nullptr;
+    }
+
     _Tp &value() const noexcept {
         return static_cast<_NodeImpl *>(_M_node)->_M_value;
     }
 
     ~_RbTreeNodeHandle() noexcept {
         if (_M_node) {
-            _RbTreeBase::_M_deallocate<_NodeImpl>(_M_alloc, _M_node);
+            _M_node->_M_destruct();
+            _Pool::_S_give_back(_M_share, _M_node);
+            _Pool::_S_unshare(_M_share, _M_alloc);
         }
     }
 };
@@ -652,6 +1502,16 @@ struct _RbTreeNodeHandle<
     _Tp, _Compare, _Alloc, _NodeImpl,
     decltype((void)static_cast<typename _Compare::_RbTreeIsMap *>(nullptr))>
     : _RbTreeNodeHandle<_Tp, _Compare, _Alloc, _NodeImpl, void *> {
+protected:
+    using _RbTreeNodeHandle<_Tp, _Compare, _Alloc, _NodeImpl,
+                            void *>::_RbTreeNodeHandle;
+
+    template <class, class, class, class>
+    friend struct _RbTreeImpl;
+
+public:
+    _RbTreeNodeHandle() noexcept = default;
+
     typename _Tp::first_type &key() const noexcept {
         return this->value().first;
     }
@@ -667,47 +1527,175 @@ struct _RbTreeImpl : protected _RbTreeBase {
 protected:
     [[no_unique_address]] _Compare _M_comp;
     [[no_unique_address]] _Alloc _M_alloc;
+    _RbTreeNodePool<_NodeImpl, _Alloc> _M_pool;
 
-public:
-    _RbTreeImpl() noexcept
-        : _RbTreeBase(_RbTreeBase::_M_allocate<_RbTreeRoot>(_M_alloc)) {
-        _M_block->_M_root = nullptr;
+    template <class... _Ts>
+    _NodeImpl *_M_create_node(_Ts &&...__value) {
+        _NodeImpl *__node = _M_pool._M_allocate(_M_alloc);
+        __node->_M_construct(std::forward<_Ts>(__value)...);
+        return __node;
     }
 
-    ~_RbTreeImpl() noexcept {
-        this->clear();
-        _RbTreeBase::_M_deallocate<_RbTreeRoot>(_M_alloc, _M_block);
+    void _M_drop_node(_RbTreeNode *__node) noexcept {
+        static_cast<_NodeImpl *>(__node)->_M_destruct();
+        _M_pool._M_deallocate(__node);
     }
 
-    explicit _RbTreeImpl(_Compare __comp) noexcept
-        : _RbTreeBase(_RbTreeBase::_M_allocate<_RbTreeRoot>(_M_alloc)),
-          _M_comp(__comp) {
-        _M_block->_M_root = nullptr;
+    // 后序遍历析构整棵子树，不需要逐个删除时的旋转和重新着色
+    void _M_drop_subtree(_RbTreeNode *__node) noexcept {
+        while (__node != nullptr) {
+            this->_M_drop_subtree(__node->_M_right);
+            _RbTreeNode *__left = __node->_M_left;
+            this->_M_drop_node(__node);
+            __node = __left;
+        }
     }
 
-    explicit _RbTreeImpl(_Alloc alloc, _Compare __comp = _Compare()) noexcept
-        : _RbTreeBase(_RbTreeBase::_M_allocate<_RbTreeRoot>(_M_alloc)),
-          _M_alloc(alloc),
-          _M_comp(__comp) {
-        _M_block->_M_root = nullptr;
+public:
+    _RbTreeImpl() noexcept = default;
+
+    // 值不需要析构时不必逐个遍历节点，大块随节点池整块归还
+    ~_RbTreeImpl() noexcept {
+        if (!std::is_trivially_destructible_v<_Tp>) {
+            this->clear();
+        }
+        _M_pool._M_release(_M_alloc);
     }
 
-    _RbTreeImpl(_RbTreeImpl &&__that) noexcept : _RbTreeBase(__that._M_block) {
-        __that._M_block = _RbTreeBase::_M_allocate<_RbTreeRoot>(_M_alloc);
-        __that._M_block->_M_root = nullptr;
+    explicit _RbTreeImpl(_Compare __comp) noexcept : _M_comp(__comp) {}
+
+    explicit _RbTreeImpl(_Alloc alloc, _Compare __comp = _Compare()) noexcept
+        : _M_comp(__comp),
+          _M_alloc(alloc) {}
+
+    _RbTreeImpl(_RbTreeImpl &&__that) noexcept
+        : _M_comp(__that._M_comp),
+          _M_alloc(__that._M_alloc) {
+        this->_M_swap_root(__that);
+        _M_pool._M_swap(__that._M_pool);
     }
 
+    // 节点池跟着分配器走，两者一起交换
     _RbTreeImpl &operator=(_RbTreeImpl &&__that) noexcept {
-        std::swap(_M_block, __that._M_block);
+        this->_M_swap_root(__that);
+        _M_pool._M_swap(__that._M_pool);
+        std::swap(_M_alloc, __that._M_alloc);
         return *this;
     }
 
+    _Alloc get_allocator() const noexcept {
+        return _M_alloc;
+    }
+
+    // 节点池的内存使用情况
+    _RbTreeMemoryStats memory_stats() const noexcept {
+        return _M_pool._M_stats();
+    }
+
 protected:
+    // 把中序下标为 [__lo, __hi) 的节点连成完全平衡的子树，取中点作根
+    // 这样除最底一层外每层都是满的，把最底一层染红即满足红黑树的性质
+    static _RbTreeNode *_S_link_balanced(_NodeImpl *__run, size_t __lo,
+                                         size_t __hi, _RbTreeNode *__parent,
+                                         _RbTreeNode **__pparent,
+                                         size_t __depth,
+                                         size_t __red_depth) noexcept {
+        if (__lo == __hi) {
+            return nullptr;
+        }
+        size_t __mid = __lo + (__hi - __lo) / 2;
+        _RbTreeNode *__node = __run + __mid;
+        __node->_M_parent = __parent;
+        __node->_M_pparent = __pparent;
+        __node->_M_color = __depth == __red_depth ? _S_red : _S_black;
+        __node->_M_left =
+            _RbTreeImpl::_S_link_balanced(__run, __lo, __mid, __node,
+                                          &__node->_M_left, __depth + 1,
+                                          __red_depth);
+        __node->_M_right =
+            _RbTreeImpl::_S_link_balanced(__run, __mid + 1, __hi, __node,
+                                          &__node->_M_right, __depth + 1,
+                                          __red_depth);
+        __node->_M_size = static_cast<std::uint32_t>(__hi - __lo);
+        return __node;
+    }
+
+    // 空树从有序区间线性建树：节点从池中一次性连续切出，按顺序构造后直接连接，
+    // 不需要逐个下降查找和旋转。遇到逆序的元素就停下，已构造的部分先建成树，
+    // 返回尚未处理的位置，由调用者逐个插入剩下的元素
+    template <class _ForwardIt>
+    _ForwardIt _M_build_sorted(_ForwardIt __first, _ForwardIt __last,
+                               bool __unique) {
+        size_t __n = static_cast<size_t>(std::distance(__first, __last));
+        if (__n == 0) {
+            return __first;
+        }
+        auto &__pool = _M_pool;
+        _NodeImpl *__run = __pool._M_allocate_run(__n, _M_alloc);
+        size_t __built = 0;
+        bool __pending = false; // __run[__built] 已构造但还没比较完
+        _NodeImpl *__stray = nullptr;
+        try {
+            for (; __first != __last; ++__first) {
+                _NodeImpl *__node = __run + __built;
+                __node->_M_construct(*__first);
+                __pending = true;
+                if (__built != 0) {
+                    const _Tp &__prev = __run[__built - 1]._M_value;
+                    if (_M_comp(__node->_M_value, __prev)) {
+                        __stray = __node;
+                        ++__first;
+                        break;
+                    }
+                    if (__unique && !_M_comp(__prev, __node->_M_value)) {
+                        __pending = false;
+                        __node->_M_destruct();
+                        continue;
+                    }
+                }
+                __pending = false;
+                ++__built;
+            }
+        } catch (...) {
+            if (__pending) {
+                __run[__built]._M_destruct();
+            }
+            for (size_t __i = 0; __i != __built; ++__i) {
+                __run[__i]._M_destruct();
+            }
+            for (size_t __i = 0; __i != __n; ++__i) {
+                __pool._M_deallocate(__run + __i);
+            }
+            throw;
+        }
+        for (size_t __i = __built + (__stray ? 1 : 0); __i != __n; ++__i) {
+            __pool._M_deallocate(__run + __i);
+        }
+        _M_block._M_root = _RbTreeImpl::_S_link_balanced(
+            __run, 0, __built, nullptr, &_M_block._M_root, 0,
+            _RbTreeBase::_S_red_depth(__built));
+        _M_block._M_rightmost = __run + (__built - 1);
+        if (__stray) {
+            if (!__unique) {
+                this->_M_multi_insert_node<_NodeImpl>(__stray, _M_comp);
+            } else if (this->_M_single_insert_node<_NodeImpl>(__stray,
+                                                              _M_comp)) {
+                this->_M_drop_node(__stray);
+            }
+        }
+        return __first;
+    }
+
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
     void _M_single_insert(_InputIt __first, _InputIt __last) {
+        if constexpr (std::forward_iterator<_InputIt>) {
+            if (this->empty()) {
+                __first = this->_M_build_sorted(__first, __last, true);
+            }
+        }
         while (__first != __last) {
-            this->_M_single_insert(*__first);
+            this->_M_single_emplace(*__first);
             ++__first;
         }
     }
@@ -715,8 +1703,13 @@ protected:
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
     void _M_multi_insert(_InputIt __first, _InputIt __last) {
+        if constexpr (std::forward_iterator<_InputIt>) {
+            if (this->empty()) {
+                __first = this->_M_build_sorted(__first, __last, false);
+            }
+        }
         while (__first != __last) {
-            this->_M_multi_insert(*__first);
+            this->_M_multi_emplace(*__first);
             ++__first;
         }
     }
@@ -749,34 +1742,131 @@ protected:
 
     template <class... _Ts>
     iterator _M_multi_emplace(_Ts &&...__value) {
-        _NodeImpl *__node = _RbTreeBase::_M_allocate<_NodeImpl>(_M_alloc);
-        __node->_M_construct(std::forward<_Ts>(__value)...);
+        _NodeImpl *__node = this->_M_create_node(std::forward<_Ts>(__value)...);
         this->_M_multi_insert_node<_NodeImpl>(__node, _M_comp);
         return __node;
     }
 
     template <class... _Ts>
     std::pair<iterator, bool> _M_single_emplace(_Ts &&...__value) {
-        _RbTreeNode *__node = _RbTreeBase::_M_allocate<_NodeImpl>(_M_alloc);
-        static_cast<_NodeImpl *>(__node)->_M_construct(
-            std::forward<_Ts>(__value)...);
+        _RbTreeNode *__node = this->_M_create_node(std::forward<_Ts>(__value)...);
         _RbTreeNode *__conflict =
             this->_M_single_insert_node<_NodeImpl>(__node, _M_comp);
         if (__conflict) {
-            static_cast<_NodeImpl *>(__node)->_M_destruct();
-            _RbTreeBase::_M_deallocate<_NodeImpl>(_M_alloc, __node);
+            this->_M_drop_node(__node);
             return {__conflict, false};
         } else {
             return {__node, true};
         }
     }
 
+    static _RbTreeNode *_S_hint_node(const_iterator __hint) noexcept {
+        return __hint._M_off_by_one ? nullptr : __hint._M_node;
+    }
+
+    template <class... _Ts>
+    iterator _M_multi_emplace_hint(const_iterator __hint, _Ts &&...__value) {
+        _NodeImpl *__node = this->_M_create_node(std::forward<_Ts>(__value)...);
+        this->_M_multi_insert_node_hint<_NodeImpl>(
+            _RbTreeImpl::_S_hint_node(__hint), __node, _M_comp);
+        return __node;
+    }
+
+    template <class... _Ts>
+    iterator _M_single_emplace_hint(const_iterator __hint, _Ts &&...__value) {
+        _RbTreeNode *__node = this->_M_create_node(std::forward<_Ts>(__value)...);
+        _RbTreeNode *__conflict = this->_M_single_insert_node_hint<_NodeImpl>(
+            _RbTreeImpl::_S_hint_node(__hint), __node, _M_comp);
+        if (__conflict) {
+            this->_M_drop_node(__node);
+            return __conflict;
+        }
+        return __node;
+    }
+
+    // 让 __root 成为整棵树的根，并重新确定最大节点
+    void _M_reset_root(_RbTreeNode *__root) noexcept {
+        if (__root != nullptr) {
+            __root->_M_parent = nullptr;
+            __root->_M_pparent = &_M_block._M_root;
+            __root->_M_color = _S_black;
+        }
+        _M_block._M_root = __root;
+        _M_block._M_rightmost = this->_M_max_node();
+    }
+
+    // 分配器不相等时节点不能换树，只能把值逐个搬进本树的新节点
+    template <bool _Multi>
+    void _M_merge_values(_RbTreeImpl &__that) {
+        iterator __it = __that.begin();
+        while (__it != __that.end()) {
+            if (!_Multi &&
+                this->_M_find_node<_NodeImpl>(*__it, _M_comp) != nullptr) {
+                ++__it;
+                continue;
+            }
+            this->_M_multi_emplace(std::move(*__it));
+            __it = __that.erase(__it);
+        }
+    }
+
+    // 把 __that 的节点整体拼进本树，节点不重新分配：两棵树拆分后再用 join 拼起，
+    // 规模大时左右两半在不同线程上进行。_Multi 为假时与本树重复的节点留在
+    // __that 中。比较器不允许抛出异常
+    template <bool _Multi>
+    void _M_merge(_RbTreeImpl &__that) {
+        if (&__that == this || __that.empty()) {
+            return;
+        }
+        if constexpr (!std::allocator_traits<_Alloc>::is_always_equal::value) {
+            if (!(_M_alloc == __that._M_alloc)) {
+                this->template _M_merge_values<_Multi>(__that);
+                return;
+            }
+        }
+        // 先引用对方的共享区，申请失败时两棵树都还没有改动
+        _M_pool._M_share(__that._M_pool,
+                                               _M_alloc);
+        size_t __count = __that.size();
+        _RbTreeNodeList __dups;
+        _RbTreeNode *__root = _RbTreeBase::_S_union<_Multi, _NodeImpl>(
+            _M_block._M_root, __that._M_block._M_root, _M_comp, __dups,
+            _RbTreeBase::_S_fork_budget());
+        this->_M_reset_root(__root);
+        _RbTreeNode *__cursor = __dups._M_head;
+        __that._M_reset_root(_RbTreeBase::_S_link_list(
+            __cursor, __dups._M_count, 0,
+            _RbTreeBase::_S_red_depth(__dups._M_count)));
+        _M_pool._M_adopt(
+            __that._M_pool, __count - __dups._M_count);
+    }
+
+    // 只保留（_Intersect）或只去掉在 __that 中出现的元素，__that 保持不变
+    template <bool _Intersect>
+    void _M_filter(const _RbTreeImpl &__that) noexcept {
+        if (&__that == this) {
+            if (!_Intersect) {
+                this->clear();
+            }
+            return;
+        }
+        _RbTreeDropList __drops;
+        _RbTreeNode *__root = _RbTreeBase::_S_filter<_Intersect, _NodeImpl>(
+            _M_block._M_root, __that._M_block._M_root, _M_comp, __drops,
+            _RbTreeBase::_S_fork_budget());
+        this->_M_reset_root(__root);
+        while (__drops._M_head != nullptr) {
+            _RbTreeNode *__subtree = __drops._M_head;
+            __drops._M_head = __subtree->_M_parent;
+            this->_M_drop_subtree(__subtree);
+        }
+    }
+
 public:
     void clear() noexcept {
-        iterator __it = this->begin();
-        while (__it != this->end()) {
-            __it = this->erase(__it);
-        }
+        this->_M_drop_subtree(_M_block._M_root);
+        _M_block._M_root = nullptr;
+        _M_block._M_rightmost = nullptr;
     }
 
     iterator erase(const_iterator __it) noexcept {
@@ -784,21 +1874,30 @@ public:
         iterator __tmp(__it);
         ++__tmp;
         _RbTreeNode *__node = __it._M_node;
-        _RbTreeImpl::_M_erase_node(__node);
-        static_cast<_NodeImpl *>(__node)->_M_destruct();
-        _RbTreeBase::_M_deallocate<_NodeImpl>(_M_alloc, __node);
+        this->_M_erase_node(__node);
+        this->_M_drop_node(__node);
         return __tmp;
     }
 
     using node_type = _RbTreeNodeHandle<_Tp, _Compare, _Alloc, _NodeImpl>;
 
-    template <class... _Ts>
     std::pair<iterator, bool> insert(node_type __nh) {
+        if (__nh.empty()) {
+            return {this->end(), false};
+        }
         _NodeImpl *__node = __nh._M_node;
+        if (_M_pool._M_take_back(__nh._M_share, _M_alloc)) {
+            __nh._M_node = nullptr;
+            __nh._M_share = nullptr;
+        } else {
+            // 节点来自别的树的节点池：为一个节点引用对方的全部大块会让它们
+            // 一直留在本树里，所以把值搬进本池的新节点，原节点随句柄还回去
+            __node = this->_M_create_node(std::move(__nh.value()));
+        }
         _RbTreeNode *__conflict =
             this->_M_single_insert_node<_NodeImpl>(__node, _M_comp);
         if (__conflict) {
-            static_cast<_NodeImpl *>(__node)->_M_destruct();
+            this->_M_drop_node(__node);
             return {__conflict, false};
         } else {
             return {__node, true};
@@ -807,8 +1906,8 @@ public:
 
     node_type extract(const_iterator __it) noexcept {
         _RbTreeNode *__node = __it._M_node;
-        _RbTreeImpl::_M_erase_node(__node);
-        return {__node, _M_alloc};
+        this->_M_erase_node(__node);
+        return {static_cast<_NodeImpl *>(__node), _M_pool._M_lend(), _M_alloc};
     }
 
 protected:
@@ -817,8 +1916,7 @@ protected:
         _RbTreeNode *__node = this->_M_find_node<_NodeImpl>(__value, _M_comp);
         if (__node != nullptr) {
             this->_M_erase_node(__node);
-            static_cast<_NodeImpl *>(__node)->_M_destruct();
-            _RbTreeBase::_M_deallocate<_NodeImpl>(_M_alloc, __node);
+            this->_M_drop_node(__node);
             return 1;
         } else {
             return 0;
@@ -913,11 +2011,60 @@ public:
         return {this->lower_bound(__value), this->upper_bound(__value)};
     }
 
+    // 顺序统计：每个节点记录子树大小，以下操作都是 O(log n)
+    iterator nth(size_t __index) noexcept {
+        return this->_M_prevent_end(
+            _RbTreeBase::_S_select(_M_block._M_root, __index));
+    }
+
+    const_iterator nth(size_t __index) const noexcept {
+        return this->_M_prevent_end(
+            _RbTreeBase::_S_select(_M_block._M_root, __index));
+    }
+
+    // 迭代器在中序中的下标，end() 的下标为 size()
+    size_t index_of(const_iterator __it) const noexcept {
+        return __it._M_off_by_one ? this->size()
+                                  : _RbTreeBase::_S_index(__it._M_node);
+    }
+
+    // 严格小于 __value 的元素个数
+    template <class _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    size_t rank(_Tv &&__value) const noexcept {
+        return this->_M_rank<false>(__value);
+    }
+
+    size_t rank(const _Tp &__value) const noexcept {
+        return this->_M_rank<false>(__value);
+    }
+
+    size_t distance(const_iterator __first,
+                    const_iterator __last) const noexcept {
+        return this->index_of(__last) - this->index_of(__first);
+    }
+
 protected:
+    // _Upper 为假时统计小于 __value 的元素个数，为真时统计不大于的
+    template <bool _Upper, class _Tv>
+    size_t _M_rank(_Tv &&__value) const noexcept {
+        size_t __rank = 0;
+        const _RbTreeNode *__node = _M_block._M_root;
+        while (__node != nullptr) {
+            const _Tp &__key = static_cast<const _NodeImpl *>(__node)->_M_value;
+            if (_Upper ? !_M_comp(__value, __key) : _M_comp(__key, __value)) {
+                __rank += _RbTreeBase::_S_size(__node->_M_left) + 1;
+                __node = __node->_M_right;
+            } else {
+                __node = __node->_M_left;
+            }
+        }
+        return __rank;
+    }
+
     template <class _Tv>
     size_t _M_multi_count(_Tv &&__value) const noexcept {
-        const_iterator __it = this->lower_bound(__value);
-        return __it != end() ? std::distance(__it, this->upper_bound()) : 0;
+        return this->_M_rank<true>(__value) - this->_M_rank<false>(__value);
     }
 
     template <class _Tv>
@@ -952,11 +2099,11 @@ public:
     }
 
     iterator end() noexcept {
-        return &_M_block->_M_root;
+        return &_M_block._M_root;
     }
 
     reverse_iterator rend() noexcept {
-        return &_M_block->_M_root;
+        return &_M_block._M_root;
     }
 
     const_iterator begin() const noexcept {
@@ -968,11 +2115,11 @@ public:
     }
 
     const_iterator end() const noexcept {
-        return &_M_block->_M_root;
+        return const_cast<_RbTreeNode **>(&_M_block._M_root);
     }
 
     const_reverse_iterator rend() const noexcept {
-        return &_M_block->_M_root;
+        return const_cast<_RbTreeNode **>(&_M_block._M_root);
     }
 
 #ifndef NDEBUG
@@ -1017,16 +2164,16 @@ public:
 
     template <class _Ostream>
     void _M_print(_Ostream &__os) {
-        _M_print(__os, this->_M_block->_M_root);
+        _M_print(__os, this->_M_block._M_root);
         __os << '\n';
     }
 #endif
 
     bool empty() const noexcept {
-        return this->_M_block->_M_root == nullptr;
+        return this->_M_block._M_root == nullptr;
     }
 
     size_t size() const noexcept {
-        return std::distance(this->begin(), this->end());
+        return _RbTreeBase::_S_size(this->_M_block._M_root);
     }
 };
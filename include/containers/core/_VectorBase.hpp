@@ -0,0 +1,513 @@
+#pragma once
+
+#include <algorithm>
+#include <common/_common.hpp>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+
+namespace Marcus {
+
+// vector 的增长策略：容量不够时扩到当前容量的 _Num / _Den 倍，且不小于所需的
+// 容量。自定义策略只需提供同样的静态函数 next_capacity
+template <std::size_t _Num = 2, std::size_t _Den = 1>
+struct geometric_growth {
+    static_assert(_Num > _Den, "geometric_growth: factor must exceed one");
+
+    static constexpr std::size_t
+    next_capacity(std::size_t __cap, std::size_t __required) noexcept {
+        return std::max(__cap * _Num / _Den, __required);
+    }
+};
+
+// vector 和 small_vector 共用的连续缓冲区逻辑。缓冲区归谁释放由派生类的
+// _replace_buffer 决定，at 的异常信息取自派生类的 _S_at_what
+template <typename _Derived, typename _Tp, typename _Alloc, typename _Growth>
+struct _VectorBase {
+public:
+    using value_type = _Tp;
+    using allocator_type = _Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = _Tp *;
+    using const_pointer = const _Tp *;
+    using reference = _Tp &;
+    using const_reference = const _Tp &;
+    using iterator = _Tp *;
+    using const_iterator = const _Tp *;
+    using reverse_iterator = std::reverse_iterator<_Tp *>;
+    using const_reverse_iterator = std::reverse_iterator<const _Tp *>;
+
+protected:
+    _Tp *_data;
+    std::size_t _size;
+    std::size_t _cap;
+    [[no_unique_address]] _Alloc _alloc;
+
+    static constexpr bool _relocatable = is_trivially_relocatable_v<_Tp>;
+
+    _VectorBase() noexcept : _data(nullptr), _size(0), _cap(0) {}
+
+    explicit _VectorBase(const _Alloc &alloc) noexcept
+        : _data(nullptr), _size(0), _cap(0), _alloc(alloc) {}
+
+    explicit _VectorBase(_Alloc &&alloc) noexcept
+        : _data(nullptr), _size(0), _cap(0), _alloc(std::move(alloc)) {}
+
+    _VectorBase(const _VectorBase &) = delete;
+    _VectorBase &operator=(const _VectorBase &) = delete;
+
+    ~_VectorBase() = default;
+
+    void _replace_buffer(_Tp *_new_data, std::size_t _new_cap) noexcept {
+        static_cast<_Derived *>(this)->_replace_buffer(_new_data, _new_cap);
+    }
+
+    // 在 _dst 上按 move_if_noexcept 逐个构造 [_src, _src + _n) 的副本，
+    // 抛异常时析构已构造的部分，源不受影响
+    static void _construct_from(_Tp *_dst, _Tp *_src, std::size_t _n) {
+        std::size_t _i = 0;
+        try {
+            for (; _i != _n; _i++) {
+                std::construct_at(&_dst[_i], std::move_if_noexcept(_src[_i]));
+            }
+        } catch (...) {
+            std::destroy_n(_dst, _i);
+            throw;
+        }
+    }
+
+    // 把 [_src, _src + _n) 的对象搬到不重叠的 _dst，之后 _src 处不再有对象。
+    // 先全部构造好再析构源，抛异常时源原样保留
+    static void _relocate(_Tp *_dst, _Tp *_src, std::size_t _n) {
+        if constexpr (_relocatable) {
+            if (_n != 0) {
+                std::memcpy(static_cast<void *>(_dst),
+                            static_cast<const void *>(_src), _n * sizeof(_Tp));
+            }
+        } else {
+            _construct_from(_dst, _src, _n);
+            std::destroy_n(_src, _n);
+        }
+    }
+
+    // 把现有元素搬进新缓冲区 _new_data，下标 _j 起留出 _n 个位置。
+    // 抛异常时新缓冲区里什么都不留，旧元素原样保留，由调用者释放新缓冲区
+    void _move_into(_Tp *_new_data, std::size_t _j, std::size_t _n) {
+        if constexpr (_relocatable) {
+            _relocate(_new_data, _data, _j);
+            _relocate(_new_data + _j + _n, _data + _j, _size - _j);
+        } else {
+            _construct_from(_new_data, _data, _j);
+            try {
+                _construct_from(_new_data + _j + _n, _data + _j, _size - _j);
+            } catch (...) {
+                std::destroy_n(_new_data, _j);
+                throw;
+            }
+            std::destroy_n(_data, _size);
+        }
+    }
+
+    // 换到容量恰好为 _n 的新缓冲区
+    void _reallocate(std::size_t _n) {
+        if (_n == 0) {
+            _replace_buffer(nullptr, 0);
+            return;
+        }
+        _Tp *_new_data = _alloc.allocate(_n);
+        try {
+            _move_into(_new_data, _size, 0);
+        } catch (...) {
+            _alloc.deallocate(_new_data, _n);
+            throw;
+        }
+        _replace_buffer(_new_data, _n);
+    }
+
+    // 放不下 _n 个元素时按增长策略扩容
+    void _grow_to(std::size_t _n) {
+        if (_n > _cap) {
+            _reallocate(_Growth::next_capacity(_cap, _n));
+        }
+    }
+
+    // 在下标 _j 处腾出 _n 个未构造的位置，_size 由调用者在构造后更新。
+    // 需要扩容时前后两段直接搬进新缓冲区，不必搬完再整体后移
+    _Tp *_make_gap(std::size_t _j, std::size_t _n) {
+        if (_size + _n > _cap) {
+            std::size_t _new_cap = _Growth::next_capacity(_cap, _size + _n);
+            _Tp *_new_data = _alloc.allocate(_new_cap);
+            try {
+                _move_into(_new_data, _j, _n);
+            } catch (...) {
+                _alloc.deallocate(_new_data, _new_cap);
+                throw;
+            }
+            _replace_buffer(_new_data, _new_cap);
+        } else if constexpr (_relocatable) {
+            if (_j != _size) {
+                std::memmove(static_cast<void *>(_data + _j + _n),
+                             static_cast<const void *>(_data + _j),
+                             (_size - _j) * sizeof(_Tp));
+            }
+        } else {
+            for (std::size_t _i = _size; _i != _j; _i--) {
+                std::construct_at(&_data[_i + _n - 1],
+                                  std::move(_data[_i - 1]));
+                std::destroy_at(&_data[_i - 1]);
+            }
+        }
+        return _data + _j;
+    }
+
+    // 满了再追加：先在新缓冲区里构造新元素，参数引用旧元素时也安全
+    template <typename... Args>
+    _Tp &_realloc_emplace_back(Args &&..._args) {
+        std::size_t _new_cap = _Growth::next_capacity(_cap, _size + 1);
+        _Tp *_new_data = _alloc.allocate(_new_cap);
+        _Tp *_p = &_new_data[_size];
+        try {
+            std::construct_at(_p, std::forward<Args>(_args)...);
+        } catch (...) {
+            _alloc.deallocate(_new_data, _new_cap);
+            throw;
+        }
+        try {
+            _move_into(_new_data, _size, 1);
+        } catch (...) {
+            std::destroy_at(_p);
+            _alloc.deallocate(_new_data, _new_cap);
+            throw;
+        }
+        _replace_buffer(_new_data, _new_cap);
+        _size = _size + 1;
+        return *_p;
+    }
+
+public:
+    void clear() noexcept {
+        std::destroy(_data, _data + _size);
+        _size = 0;
+    }
+
+    void resize(std::size_t _n) {
+        if (_n < _size) {
+            std::destroy(_data + _n, _data + _size);
+        } else if (_n > _size) {
+            _grow_to(_n);
+            std::uninitialized_value_construct(_data + _size, _data + _n);
+        }
+        _size = _n;
+    }
+
+    void resize(std::size_t _n, const _Tp &val) {
+        if (_n < _size) {
+            std::destroy(_data + _n, _data + _size);
+        } else if (_n > _size) {
+            _grow_to(_n);
+            std::uninitialized_fill(_data + _size, _data + _n, val);
+        }
+        _size = _n;
+    }
+
+    // 新元素只做默认初始化：平凡类型不清零，适合随后整块覆盖写入的缓冲区
+    void resize_for_overwrite(std::size_t _n) {
+        if (_n < _size) {
+            std::destroy(_data + _n, _data + _size);
+        } else if (_n > _size) {
+            _grow_to(_n);
+            std::uninitialized_default_construct(_data + _size, _data + _n);
+        }
+        _size = _n;
+    }
+
+    // 在末尾预留 _n 个未初始化的位置交给 _fill(pointer, _n)，它返回实际
+    // 写入的个数 (不超过 _n)，只有这些元素计入 size。_fill 抛异常时 size 不变
+    template <typename _Fill>
+    std::size_t append_with(std::size_t _n, _Fill &&_fill) {
+        static_assert(std::is_trivially_default_constructible_v<_Tp> &&
+                          std::is_trivially_destructible_v<_Tp>,
+                      "append_with: element type must be trivial");
+        _grow_to(_size + _n);
+        std::size_t _written = std::forward<_Fill>(_fill)(_data + _size, _n);
+        _written = std::min(_written, _n);
+        _size += _written;
+        return _written;
+    }
+
+    // 容量恰好扩到 _n，增长策略只用于插入时的自动扩容
+    void reserve(std::size_t _n) {
+        if (_n > _cap) {
+            _reallocate(_n);
+        }
+    }
+
+    std::size_t capacity() const noexcept {
+        return _cap;
+    }
+
+    std::size_t size() const noexcept {
+        return _size;
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    static constexpr std::size_t max_size() noexcept {
+        return std::numeric_limits<std::size_t>::max() / sizeof(_Tp);
+    }
+
+    const _Tp &operator[](std::size_t _i) const noexcept {
+        return _data[_i];
+    }
+
+    _Tp &operator[](std::size_t _i) noexcept {
+        return _data[_i];
+    }
+
+    const _Tp &at(std::size_t _i) const {
+        if (_i >= _size) [[unlikely]] {
+            throw std::out_of_range(_Derived::_S_at_what);
+        }
+        return _data[_i];
+    }
+
+    _Tp &at(std::size_t _i) {
+        if (_i >= _size) [[unlikely]] {
+            throw std::out_of_range(_Derived::_S_at_what);
+        }
+        return _data[_i];
+    }
+
+    const _Tp &front() const noexcept {
+        return *_data;
+    }
+
+    _Tp &front() noexcept {
+        return *_data;
+    }
+
+    const _Tp &back() const noexcept {
+        return _data[_size - 1];
+    }
+
+    _Tp &back() noexcept {
+        return _data[_size - 1];
+    }
+
+    void push_back(const _Tp &val) {
+        emplace_back(val);
+    }
+
+    void push_back(_Tp &&val) {
+        emplace_back(std::move(val));
+    }
+
+    template <typename... Args>
+    _Tp &emplace_back(Args &&..._args) {
+        if (_size == _cap) [[unlikely]] {
+            return _realloc_emplace_back(std::forward<Args>(_args)...);
+        }
+        _Tp *_p = &_data[_size];
+        std::construct_at(_p, std::forward<Args>(_args)...);
+        _size = _size + 1;
+        return *_p;
+    }
+
+    _Tp *data() noexcept {
+        return _data;
+    }
+
+    const _Tp *data() const noexcept {
+        return _data;
+    }
+
+    const _Tp *cdata() const noexcept {
+        return _data;
+    }
+
+    _Tp *begin() noexcept {
+        return _data;
+    }
+
+    _Tp *end() noexcept {
+        return _data + _size;
+    }
+
+    const _Tp *begin() const noexcept {
+        return _data;
+    }
+
+    const _Tp *end() const noexcept {
+        return _data + _size;
+    }
+
+    const _Tp *cbegin() const noexcept {
+        return _data;
+    }
+
+    const _Tp *cend() const noexcept {
+        return _data + _size;
+    }
+
+    std::reverse_iterator<_Tp *> rbegin() noexcept {
+        return std::make_reverse_iterator(_data + _size);
+    }
+
+    std::reverse_iterator<_Tp *> rend() noexcept {
+        return std::make_reverse_iterator(_data);
+    }
+
+    std::reverse_iterator<const _Tp *> rbegin() const noexcept {
+        return std::make_reverse_iterator(_data + _size);
+    }
+
+    std::reverse_iterator<const _Tp *> rend() const noexcept {
+        return std::make_reverse_iterator(_data);
+    }
+
+    std::reverse_iterator<const _Tp *> crbegin() const noexcept {
+        return std::make_reverse_iterator(_data + _size);
+    }
+
+    std::reverse_iterator<const _Tp *> crend() const noexcept {
+        return std::make_reverse_iterator(_data);
+    }
+
+    void pop_back() noexcept {
+        _size -= 1;
+        std::destroy_at(&_data[_size]);
+    }
+
+    _Tp *
+    erase(const _Tp *_it) noexcept(std::is_nothrow_move_assignable_v<_Tp>) {
+        return erase(_it, _it + 1);
+    }
+
+    // [_first, _last)
+    _Tp *
+    erase(const _Tp *_first,
+          const _Tp *_last) noexcept(std::is_nothrow_move_assignable_v<_Tp>) {
+        std::size_t _j = _first - _data;
+        std::size_t diff = _last - _first;
+        if (diff == 0) {
+            // 空区间：否则下面会把尾部元素逐个移动赋值给自己
+            return _data + _j;
+        }
+        if constexpr (_relocatable) {
+            std::destroy(_data + _j, _data + _j + diff);
+            std::memmove(static_cast<void *>(_data + _j),
+                         static_cast<const void *>(_data + _j + diff),
+                         (_size - _j - diff) * sizeof(_Tp));
+        } else {
+            std::move(_data + _j + diff, _data + _size, _data + _j);
+            std::destroy(_data + _size - diff, _data + _size);
+        }
+        _size -= diff;
+        return _data + _j;
+    }
+
+    void assign(std::size_t _n, const _Tp &val) {
+        clear();
+        reserve(_n);
+        std::uninitialized_fill_n(_data, _n, val);
+        _size = _n;
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                    _InputIt)>
+    void assign(_InputIt _first, _InputIt _last) {
+        assign_range(std::ranges::subrange(_first, _last));
+    }
+
+    void assign(std::initializer_list<_Tp> _list) {
+        assign(_list.begin(), _list.end());
+    }
+
+    // 参数可能引用本容器的元素，先构造出新值再腾位置
+    template <typename... Args>
+    _Tp *emplace(const _Tp *_it, Args &&...args) {
+        std::size_t _j = _it - _data; // _j : insert index
+        if (_j == _size) {
+            return &emplace_back(std::forward<Args>(args)...);
+        }
+        _Tp _tmp(std::forward<Args>(args)...);
+        std::construct_at(_make_gap(_j, 1), std::move(_tmp));
+        _size += 1;
+        return _data + _j;
+    }
+
+    _Tp *insert(const _Tp *_it, _Tp &&val) {
+        return emplace(_it, std::move(val));
+    }
+
+    _Tp *insert(const _Tp *_it, const _Tp &val) {
+        return emplace(_it, val);
+    }
+
+    _Tp *insert(const _Tp *_it, std::size_t _n, const _Tp &val) {
+        std::size_t _j = _it - _data;
+        if (_n == 0) [[unlikely]] {
+            return const_cast<_Tp *>(_it);
+        }
+        _Tp _tmp(val);
+        std::uninitialized_fill_n(_make_gap(_j, _n), _n, _tmp);
+        _size += _n;
+        return _data + _j;
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                    _InputIt)>
+    _Tp *insert(const _Tp *_it, _InputIt _first, _InputIt _last) {
+        return insert_range(_it, std::ranges::subrange(_first, _last));
+    }
+
+    _Tp *insert(const _Tp *_it, std::initializer_list<_Tp> _list) {
+        return insert(_it, _list.begin(), _list.end());
+    }
+
+    // 能预先算出长度的区间一次腾好位置再整体复制构造；只能单遍读的区间
+    // 逐个追加到末尾，再旋转到插入位置
+    template <std::ranges::input_range _Rg>
+    _Tp *insert_range(const _Tp *_it, _Rg &&_rg) {
+        std::size_t _j = _it - _data;
+        if constexpr (std::ranges::forward_range<_Rg> ||
+                      std::ranges::sized_range<_Rg>) {
+            std::size_t _n = std::ranges::distance(_rg);
+            if (_n != 0) {
+                _uninitialized_copy_n(std::ranges::begin(_rg), _n,
+                                      _make_gap(_j, _n));
+                _size += _n;
+            }
+        } else {
+            std::size_t _old_size = _size;
+            for (auto &&_x: _rg) {
+                emplace_back(std::forward<decltype(_x)>(_x));
+            }
+            std::rotate(_data + _j, _data + _old_size, _data + _size);
+        }
+        return _data + _j;
+    }
+
+    template <std::ranges::input_range _Rg>
+    void append_range(_Rg &&_rg) {
+        insert_range(_data + _size, std::forward<_Rg>(_rg));
+    }
+
+    template <std::ranges::input_range _Rg>
+    void assign_range(_Rg &&_rg) {
+        clear();
+        append_range(std::forward<_Rg>(_rg));
+    }
+
+    _Alloc get_allocator() const noexcept {
+        return _alloc;
+    }
+};
+
+} // namespace Marcus
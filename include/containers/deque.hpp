@@ -1,10 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <common/_common.hpp>
 #include <cstddef>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <ranges>
 #include <stdexcept>
 #if __cpp_lib_three_way_comparison
 # include <compare>
@@ -12,9 +14,10 @@
 
 namespace Marcus {
 
-template <typename _Tp, typename _Alloc>
+template <typename _Tp, typename _Alloc, std::size_t _BlockSize>
 class deque;
 
+// 默认每块 512 字节，大元素至少 16 个一块
 template <typename _Tp>
 static constexpr std::size_t _deque_get_block_size() noexcept {
     if (sizeof(_Tp) < 32) {
@@ -23,7 +26,7 @@ static constexpr std::size_t _deque_get_block_size() noexcept {
     return 16;
 }
 
-template <typename _Tp, typename _Ref, typename _Ptr>
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
 struct deque_iterator {
     using iterator_category = std::random_access_iterator_tag;
     using value_type = _Tp;
@@ -37,7 +40,7 @@ struct deque_iterator {
     pointer _last;
     map_pointer _node;
 
-    static constexpr std::size_t _block_size = _deque_get_block_size<_Tp>();
+    static constexpr std::size_t _block_size = _BlockSize;
 
     deque_iterator() noexcept
         : _current(nullptr),
@@ -53,7 +56,8 @@ struct deque_iterator {
 
     template <typename _OtherRef, typename _OtherPtr>
     deque_iterator(
-        const deque_iterator<_Tp, _OtherRef, _OtherPtr> &__other) noexcept
+        const deque_iterator<_Tp, _OtherRef, _OtherPtr, _BlockSize>
+            &__other) noexcept
         : _current(__other._current),
           _first(__other._first),
           _last(__other._last),
@@ -138,67 +142,73 @@ private:
         _last = _first + _block_size;
     }
 
-    template <typename _T, typename _R, typename _P>
+    template <typename _T, typename _R, typename _P, std::size_t _Bs>
     friend struct deque_iterator;
 
-    template <typename _T, typename _A>
+    template <typename _T, typename _A, std::size_t _Bs>
     friend class deque;
 };
 
-template <typename _Tp, typename _Ref, typename _Ptr>
-inline bool operator==(const deque_iterator<_Tp, _Ref, _Ptr> &__x,
-                       const deque_iterator<_Tp, _Ref, _Ptr> &__y) noexcept {
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
+inline bool
+operator==(const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__x,
+           const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__y) noexcept {
     return __x._current == __y._current;
 }
 
 #if __cpp_lib_three_way_comparison
-template <typename _Tp, typename _Ref, typename _Ptr>
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
 inline std::strong_ordering
-operator<=>(const deque_iterator<_Tp, _Ref, _Ptr> &__x,
-            const deque_iterator<_Tp, _Ref, _Ptr> &__y) noexcept {
+operator<=>(const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__x,
+            const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__y) noexcept {
     if (__x._node != __y._node) {
         return __x._node <=> __y._node;
     }
     return __x._current <=> __y._current;
 }
 #else
-template <typename _Tp, typename _Ref, typename _Ptr>
-inline bool operator!=(const deque_iterator<_Tp, _Ref, _Ptr> &__x,
-                       const deque_iterator<_Tp, _Ref, _Ptr> &__y) noexcept {
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
+inline bool
+operator!=(const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__x,
+           const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__y) noexcept {
     return !(__x == __y);
 }
 
-template <typename _Tp, typename _Ref, typename _Ptr>
-inline bool operator<(const deque_iterator<_Tp, _Ref, _Ptr> &__x,
-                      const deque_iterator<_Tp, _Ref, _Ptr> &__y) noexcept {
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
+inline bool
+operator<(const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__x,
+          const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__y) noexcept {
     return (__x._node == __y._node) ? (__x._current < __y._current)
                                     : (__x._node < __y._node);
 }
 
-template <typename _Tp, typename _Ref, typename _Ptr>
-inline bool operator>(const deque_iterator<_Tp, _Ref, _Ptr> &__x,
-                      const deque_iterator<_Tp, _Ref, _Ptr> &__y) noexcept {
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
+inline bool
+operator>(const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__x,
+          const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__y) noexcept {
     return __y < __x;
 }
 
-template <typename _Tp, typename _Ref, typename _Ptr>
-inline bool operator<=(const deque_iterator<_Tp, _Ref, _Ptr> &__x,
-                       const deque_iterator<_Tp, _Ref, _Ptr> &__y) noexcept {
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
+inline bool
+operator<=(const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__x,
+           const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__y) noexcept {
     return !(__y < __x);
 }
 
-template <typename _Tp, typename _Ref, typename _Ptr>
-inline bool operator>=(const deque_iterator<_Tp, _Ref, _Ptr> &__x,
-                       const deque_iterator<_Tp, _Ref, _Ptr> &__y) noexcept {
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
+inline bool
+operator>=(const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__x,
+           const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__y) noexcept {
     return !(__x < __y);
 }
 #endif
 
-template <typename _Tp, typename _Ref, typename _Ptr>
-inline typename deque_iterator<_Tp, _Ref, _Ptr>::difference_type
-operator-(const deque_iterator<_Tp, _Ref, _Ptr> &__x,
-          const deque_iterator<_Tp, _Ref, _Ptr> &__y) noexcept {
-    using iter = deque_iterator<_Tp, _Ref, _Ptr>;
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
+inline typename deque_iterator<_Tp, _Ref, _Ptr, _BlockSize>::difference_type
+operator-(const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__x,
+          const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__y) noexcept {
+    using iter = deque_iterator<_Tp, _Ref, _Ptr, _BlockSize>;
     if (__x._node == __y._node) {
         return __x._current - __y._current;
     }
@@ -208,15 +218,169 @@ operator-(const deque_iterator<_Tp, _Ref, _Ptr> &__x,
 }
 
 // 閹绘劒绶电€靛湱袨閸旂姵纭?
-template <typename _Tp, typename _Ref, typename _Ptr>
-inline deque_iterator<_Tp, _Ref, _Ptr>
-operator+(typename deque_iterator<_Tp, _Ref, _Ptr>::difference_type __n,
-          const deque_iterator<_Tp, _Ref, _Ptr> &__x) noexcept {
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
+inline deque_iterator<_Tp, _Ref, _Ptr, _BlockSize>
+operator+(
+    typename deque_iterator<_Tp, _Ref, _Ptr, _BlockSize>::difference_type __n,
+    const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__x) noexcept {
     return __x + __n;
 }
 
-template <typename _Tp, typename _Alloc = std::allocator<_Tp>>
+template <typename _It>
+inline constexpr bool _is_deque_iterator_v = false;
+
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
+inline constexpr bool
+    _is_deque_iterator_v<deque_iterator<_Tp, _Ref, _Ptr, _BlockSize>> = true;
+
+// [__first, __last) 落在 __first 所在块里的那一段的末尾
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize>
+inline _Ptr _deque_segment_end(
+    const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__first,
+    const deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> &__last) noexcept {
+    return __first._node == __last._node ? __last._current : __first._last;
+}
+
+// 按块把 [__first, __last) 拆成若干连续段，依次调用 __f(段首指针, 段尾指针)。
+// 段内是普通指针循环，编译器可以向量化，不再每个元素都检查是否跨块
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize,
+          typename _Fn>
+_Fn for_each_segment(deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __first,
+                     deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __last,
+                     _Fn __f) {
+    while (__first != __last) {
+        _Ptr __end = _deque_segment_end(__first, __last);
+        __f(__first._current, __end);
+        __first += __end - __first._current;
+    }
+    return __f;
+}
+
+// 源是普通随机访问迭代器、目标是 deque：按目标的块分段复制
+template <std::random_access_iterator _InIt, typename _Tp, typename _Ref,
+          typename _Ptr, std::size_t _BlockSize>
+    requires(!_is_deque_iterator_v<_InIt>)
+deque_iterator<_Tp, _Ref, _Ptr, _BlockSize>
+copy(_InIt __first, _InIt __last,
+     deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __result) {
+    auto __n = static_cast<std::ptrdiff_t>(__last - __first);
+    while (__n > 0) {
+        std::ptrdiff_t __k =
+            std::min<std::ptrdiff_t>(__n, __result._last - __result._current);
+        std::copy(__first, __first + __k, __result._current);
+        __first += __k;
+        __result += __k;
+        __n -= __k;
+    }
+    return __result;
+}
+
+// 源是 deque：按源的块分段复制，目标也是 deque 时再按目标的块切分
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize,
+          typename _OutIt>
+_OutIt copy(deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __first,
+            deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __last,
+            _OutIt __result) {
+    for_each_segment(__first, __last, [&](_Ptr __begin, _Ptr __end) {
+        if constexpr (_is_deque_iterator_v<_OutIt>) {
+            __result = Marcus::copy(__begin, __end, __result);
+        } else {
+            __result = std::copy(__begin, __end, __result);
+        }
+    });
+    return __result;
+}
+
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize,
+          typename _Up>
+void fill(deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __first,
+          deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __last,
+          const _Up &__value) {
+    for_each_segment(__first, __last, [&](_Ptr __begin, _Ptr __end) {
+        std::fill(__begin, __end, __value);
+    });
+}
+
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize,
+          typename _Up>
+deque_iterator<_Tp, _Ref, _Ptr, _BlockSize>
+find(deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __first,
+     deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __last, const _Up &__value) {
+    while (__first != __last) {
+        _Ptr __end = _deque_segment_end(__first, __last);
+        _Ptr __pos = std::find(__first._current, __end, __value);
+        if (__pos != __end) {
+            __first._current = __pos;
+            return __first;
+        }
+        __first += __end - __first._current;
+    }
+    return __last;
+}
+
+// 第二个序列也是 deque 时同时按两边的块切分，每一小段都是两段连续内存比较
+template <typename _Tp, typename _Ref, typename _Ptr, std::size_t _BlockSize,
+          typename _It2>
+bool equal(deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __first1,
+           deque_iterator<_Tp, _Ref, _Ptr, _BlockSize> __last1,
+           _It2 __first2) {
+    while (__first1 != __last1) {
+        _Ptr __end = _deque_segment_end(__first1, __last1);
+        if constexpr (_is_deque_iterator_v<_It2>) {
+            std::ptrdiff_t __k = std::min<std::ptrdiff_t>(
+                __end - __first1._current, __first2._last - __first2._current);
+            if (!std::equal(__first1._current, __first1._current + __k,
+                            __first2._current)) {
+                return false;
+            }
+            __first1 += __k;
+            __first2 += __k;
+        } else {
+            auto __pos = std::mismatch(__first1._current, __end, __first2);
+            if (__pos.first != __end) {
+                return false;
+            }
+            __first2 = __pos.second;
+            __first1 += __end - __first1._current;
+        }
+    }
+    return true;
+}
+
+template <typename _Tp1, typename _Ref1, typename _Ptr1,
+          std::size_t _BlockSize1, typename _Tp2, typename _Ref2,
+          typename _Ptr2, std::size_t _BlockSize2>
+bool lexicographical_compare(
+    deque_iterator<_Tp1, _Ref1, _Ptr1, _BlockSize1> __first1,
+    deque_iterator<_Tp1, _Ref1, _Ptr1, _BlockSize1> __last1,
+    deque_iterator<_Tp2, _Ref2, _Ptr2, _BlockSize2> __first2,
+    deque_iterator<_Tp2, _Ref2, _Ptr2, _BlockSize2> __last2) {
+    while (__first1 != __last1 && __first2 != __last2) {
+        std::ptrdiff_t __k = std::min<std::ptrdiff_t>(
+            _deque_segment_end(__first1, __last1) - __first1._current,
+            _deque_segment_end(__first2, __last2) - __first2._current);
+        // 先找出第一对不等价的元素，再由它们决定大小
+        auto __pos = std::mismatch(
+            __first1._current, __first1._current + __k, __first2._current,
+            [](const auto &__x, const auto &__y) {
+                return !(__x < __y) && !(__y < __x);
+            });
+        if (__pos.first != __first1._current + __k) {
+            return *__pos.first < *__pos.second;
+        }
+        __first1 += __k;
+        __first2 += __k;
+    }
+    return __first1 == __last1 && __first2 != __last2;
+}
+
+// _BlockSize: 每块的元素个数。块越大，分配次数越少、遍历越连续，
+// 但首尾两块平均各浪费半块
+template <typename _Tp, typename _Alloc = std::allocator<_Tp>,
+          std::size_t _BlockSize = _deque_get_block_size<_Tp>()>
 class deque {
+    static_assert(_BlockSize != 0, "deque: block size must be positive");
+
 public:
     using value_type = _Tp;
     using allocator_type = _Alloc;
@@ -227,8 +391,9 @@ public:
     using pointer = typename std::allocator_traits<_Alloc>::pointer;
     using const_pointer = typename std::allocator_traits<_Alloc>::const_pointer;
 
-    using iterator = deque_iterator<_Tp, _Tp &, _Tp *>;
-    using const_iterator = deque_iterator<_Tp, const _Tp &, const _Tp *>;
+    using iterator = deque_iterator<_Tp, _Tp &, _Tp *, _BlockSize>;
+    using const_iterator =
+        deque_iterator<_Tp, const _Tp &, const _Tp *, _BlockSize>;
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
@@ -243,19 +408,39 @@ private:
     iterator _finish;
     [[no_unique_address]] allocator_type _alloc;
 
-    static constexpr size_type _block_size = _deque_get_block_size<_Tp>();
+    static constexpr size_type _block_size = _BlockSize;
+
+    // 最近空出来的块先留着不还给分配器，队列在块边界附近来回进出时
+    // 不必每次都分配、释放一块
+    static constexpr size_type _max_spare_blocks = 2;
+    pointer _spare_blocks[_max_spare_blocks] = {};
+    size_type _spare_count = 0;
 
 private:
     pointer _allocate_block() {
+        if (_spare_count != 0) {
+            return _spare_blocks[--_spare_count];
+        }
         return std::allocator_traits<allocator_type>::allocate(_alloc,
                                                                _block_size);
     }
 
     void _deallocate_block(pointer __p) {
+        if (_spare_count != _max_spare_blocks) {
+            _spare_blocks[_spare_count++] = __p;
+            return;
+        }
         std::allocator_traits<allocator_type>::deallocate(_alloc, __p,
                                                           _block_size);
     }
 
+    void _release_spare_blocks() noexcept {
+        while (_spare_count != 0) {
+            std::allocator_traits<allocator_type>::deallocate(
+                _alloc, _spare_blocks[--_spare_count], _block_size);
+        }
+    }
+
     pointer *_allocate_map(size_type __n) {
         _Map_alloc_type __map_alloc(get_allocator());
         return _Map_alloc_traits::allocate(__map_alloc, __n);
@@ -274,14 +459,17 @@ private:
         pointer *__nstart = _map + (_map_size - __num_nodes) / 2;
         pointer *__nfinish = __nstart + __num_nodes - 1;
 
+        pointer *__cur = __nstart;
         try {
-            for (pointer *__cur = __nstart; __cur <= __nfinish; ++__cur) {
+            for (; __cur <= __nfinish; ++__cur) {
                 *__cur = _allocate_block();
             }
         } catch (...) {
-            for (pointer *__cur = __nstart; *__cur != nullptr; ++__cur) {
-                _deallocate_block(*__cur);
+            for (pointer *__p = __nstart; __p != __cur; ++__p) {
+                _deallocate_block(*__p);
             }
+            // 构造函数里失败时析构函数不会运行，缓存的块要当场还掉
+            _release_spare_blocks();
             _deallocate_map(_map, _map_size);
             throw;
         }
@@ -325,6 +513,7 @@ private:
             }
             _deallocate_map(_map, _map_size);
         }
+        _release_spare_blocks();
     }
 
     void _reallocate_map(size_type __nodes_to_add, bool __add_at_front) {
@@ -363,15 +552,130 @@ private:
         }
     }
 
-    void _push_back_aux() {
+    // 在当前块的最后一个空位上构造，并换到新分配的下一块：
+    // _finish 永远不停在块尾，否则迭代器走到块尾时会跳进未分配的块
+    template <typename... _Args>
+    void _push_back_aux(_Args &&...__args) {
         if (_finish._node + 1 == _map + _map_size) {
             _reallocate_map(1, false);
         }
         *(_finish._node + 1) = _allocate_block();
+        try {
+            std::construct_at(_finish._current, std::forward<_Args>(__args)...);
+        } catch (...) {
+            _deallocate_block(*(_finish._node + 1));
+            throw;
+        }
         _finish._set_node(_finish._node + 1);
         _finish._current = _finish._first;
     }
 
+    // 一次分配好追加 __n 个元素后 _finish 要用到的所有块，返回新增的块数
+    size_type _reserve_back(size_type __n) {
+        const size_type __new_nodes =
+            (_finish._current - _finish._first + __n) / _block_size;
+        if (__new_nodes == 0) {
+            return 0;
+        }
+        if (static_cast<size_type>(_map + _map_size - _finish._node - 1) <
+            __new_nodes) {
+            _reallocate_map(__new_nodes, false);
+        }
+        size_type __i = 1;
+        try {
+            for (; __i <= __new_nodes; ++__i) {
+                *(_finish._node + __i) = _allocate_block();
+            }
+        } catch (...) {
+            while (--__i != 0) {
+                _deallocate_block(*(_finish._node + __i));
+            }
+            throw;
+        }
+        return __new_nodes;
+    }
+
+    // 从 __first 起追加 __n 个元素：块一次分配好，再逐块整段复制构造
+    template <typename _It>
+    void _append_n(_It __first, size_type __n) {
+        if (_map == nullptr) {
+            _create_map_and_nodes(0);
+        }
+        const size_type __new_nodes = _reserve_back(__n);
+        iterator __cur = _finish;
+        try {
+            while (__n != 0) {
+                const size_type __chunk = std::min(
+                    __n, static_cast<size_type>(__cur._last - __cur._current));
+                __first = _uninitialized_copy_n(std::move(__first), __chunk,
+                                                __cur._current);
+                __cur += __chunk;
+                __n -= __chunk;
+            }
+        } catch (...) {
+            _destroy_elements(_finish, __cur);
+            for (size_type __i = 1; __i <= __new_nodes; ++__i) {
+                _deallocate_block(*(_finish._node + __i));
+            }
+            throw;
+        }
+        _finish = __cur;
+    }
+
+    // 一次分配好在开头插入 __n 个元素后 _start 要用到的所有块，返回新增的块数
+    size_type _reserve_front(size_type __n) {
+        const size_type __room =
+            static_cast<size_type>(_start._current - _start._first);
+        if (__n <= __room) {
+            return 0;
+        }
+        const size_type __new_nodes =
+            (__n - __room + _block_size - 1) / _block_size;
+        if (static_cast<size_type>(_start._node - _map) < __new_nodes) {
+            _reallocate_map(__new_nodes, true);
+        }
+        size_type __i = 1;
+        try {
+            for (; __i <= __new_nodes; ++__i) {
+                *(_start._node - __i) = _allocate_block();
+            }
+        } catch (...) {
+            while (--__i != 0) {
+                _deallocate_block(*(_start._node - __i));
+            }
+            throw;
+        }
+        return __new_nodes;
+    }
+
+    // 与 _append_n 对称：在开头按原顺序放入从 __first 起的 __n 个元素
+    template <typename _It>
+    void _prepend_n(_It __first, size_type __n) {
+        if (_map == nullptr) {
+            _create_map_and_nodes(0);
+        }
+        const size_type __new_nodes = _reserve_front(__n);
+        const iterator __new_start = _start - static_cast<difference_type>(__n);
+        iterator __cur = __new_start;
+        try {
+            while (__n != 0) {
+                const size_type __chunk = std::min(
+                    __n, static_cast<size_type>(__cur._last - __cur._current));
+                __first = _uninitialized_copy_n(std::move(__first), __chunk,
+                                                __cur._current);
+                __cur += __chunk;
+                __n -= __chunk;
+            }
+        } catch (...) {
+            _destroy_elements(__new_start, __cur);
+            for (size_type __i = 1; __i <= __new_nodes; ++__i) {
+                _deallocate_block(*(_start._node - __i));
+            }
+            throw;
+        }
+        _start = __new_start;
+    }
+
     void _push_front_aux() {
         if (_start._node == _map) {
             _reallocate_map(1, true);
@@ -440,19 +744,10 @@ public:
                    const allocator_type &__alloc = allocator_type())
         : _alloc(__alloc) {
         _create_map_and_nodes(__n);
-        for (iterator __cur = _start; __cur != _finish; ++__cur) {
-            std::construct_at(__cur._current);
-        }
-    }
-
-    deque(size_type __n, const_reference __val,
-          const allocator_type &__alloc = allocator_type())
-        : _alloc(__alloc) {
-        _create_map_and_nodes(__n);
         iterator __cur = _start;
         try {
             for (; __cur != _finish; ++__cur) {
-                std::construct_at(__cur._current, __val);
+                std::construct_at(__cur._current);
             }
         } catch (...) {
             _destroy_elements(_start, __cur);
@@ -461,21 +756,14 @@ public:
         }
     }
 
-    // template <
-    //     typename _InputIt,
-    //     typename = std::enable_if_t<std::is_convertible_v<
-    //         typename std::iterator_traits<_InputIt>::iterator_category,
-    //         std::input_iterator_tag>>>
-    template <std::input_iterator _InputIt>
-    deque(_InputIt __first, _InputIt __last,
+    deque(size_type __n, const_reference __val,
           const allocator_type &__alloc = allocator_type())
         : _alloc(__alloc) {
-        const size_type __n = std::distance(__first, __last);
         _create_map_and_nodes(__n);
         iterator __cur = _start;
         try {
-            for (; __first != __last; ++__first, ++__cur) {
-                std::construct_at(__cur._current, *__first);
+            for (; __cur != _finish; ++__cur) {
+                std::construct_at(__cur._current, __val);
             }
         } catch (...) {
             _destroy_elements(_start, __cur);
@@ -484,6 +772,13 @@ public:
         }
     }
 
+    template <std::input_iterator _InputIt>
+    deque(_InputIt __first, _InputIt __last,
+          const allocator_type &__alloc = allocator_type())
+        : deque(__alloc) {
+        append_range(std::ranges::subrange(__first, __last));
+    }
+
     deque(const deque &__other)
         : _alloc(std::allocator_traits<allocator_type>::
                      select_on_container_copy_construction(
@@ -522,8 +817,8 @@ public:
     ~deque() noexcept {
         if (_map) {
             _destroy_elements(_start, _finish);
-            _deallocate_all();
         }
+        _deallocate_all();
     }
 
     deque &operator=(const deque &__other) {
@@ -616,10 +911,7 @@ public:
     //         std::input_iterator_tag>>>
     template <std::input_iterator _InputIt>
     void assign(_InputIt __first, _InputIt __last) {
-        clear();
-        for (; __first != __last; ++__first) {
-            emplace_back(*__first);
-        }
+        assign_range(std::ranges::subrange(__first, __last));
     }
 
     allocator_type get_allocator() const noexcept {
@@ -747,9 +1039,8 @@ public:
             _map_size < __blocks_in_use * 2) {
             return;
         }
-        deque<_Tp, _Alloc> __temp(std::make_move_iterator(begin()),
-                                  std::make_move_iterator(end()),
-                                  get_allocator());
+        deque __temp(std::make_move_iterator(begin()),
+                     std::make_move_iterator(end()), get_allocator());
         this->swap(__temp);
     }
 
@@ -810,13 +1101,11 @@ public:
         if (_map == nullptr) {
             _create_map_and_nodes(0);
         }
-        if (_finish._current != _finish._last) {
+        if (_finish._current != _finish._last - 1) {
             std::construct_at(_finish._current, std::forward<_Args>(__args)...);
             ++_finish._current;
         } else {
-            _push_back_aux();
-            std::construct_at(_finish._current, std::forward<_Args>(__args)...);
-            ++_finish._current;
+            _push_back_aux(std::forward<_Args>(__args)...);
         }
         return back();
     }
@@ -920,45 +1209,52 @@ public:
 
     template <std::input_iterator _InputIt>
     iterator insert(const_iterator __pos, _InputIt __first, _InputIt __last) {
-        if constexpr (!std::is_base_of_v<std::forward_iterator_tag,
-                                         typename std::iterator_traits<
-                                             _InputIt>::iterator_category>) {
-            iterator __p = _get_iterator(__pos);
-            const difference_type __offset = __p - begin();
-            for (; __first != __last; ++__first) {
-                __p = emplace(__p, *__first);
-                ++__p;
-            }
-            return begin() + __offset;
-        } else {
-            const size_type __count = std::distance(__first, __last);
-
-            if (__count == 0) {
-                return _get_iterator(__pos);
-            }
-
-            const difference_type __offset = __pos - cbegin();
-            const size_type __old_size = size();
-
-            deque __tmp(get_allocator());
-            __tmp._create_map_and_nodes(__old_size + __count);
+        return insert_range(__pos, std::ranges::subrange(__first, __last));
+    }
 
-            auto __dest = std::uninitialized_move(
-                std::make_move_iterator(begin()),
-                std::make_move_iterator(_get_iterator(__pos)), __tmp.begin());
-            std::uninitialized_copy(__first, __last, __dest);
-            std::uninitialized_move(
-                std::make_move_iterator(_get_iterator(__pos)),
-                std::make_move_iterator(end()),
-                __tmp.begin() + __offset + __count);
+    iterator insert(const_iterator __pos, std::initializer_list<_Tp> __ilist) {
+        return insert(__pos, __ilist.begin(), __ilist.end());
+    }
 
-            this->swap(__tmp);
-            return begin() + __offset;
+    // 能预先算出长度的区间走 _append_n，只能单遍读的区间逐个追加
+    template <std::ranges::input_range _Rg>
+    void append_range(_Rg &&__rg) {
+        if constexpr (std::ranges::forward_range<_Rg> ||
+                      std::ranges::sized_range<_Rg>) {
+            _append_n(std::ranges::begin(__rg),
+                      static_cast<size_type>(std::ranges::distance(__rg)));
+        } else {
+            for (auto &&__x: __rg) {
+                emplace_back(std::forward<decltype(__x)>(__x));
+            }
         }
     }
 
-    iterator insert(const_iterator __pos, std::initializer_list<_Tp> __ilist) {
-        return insert(__pos, __ilist.begin(), __ilist.end());
+    template <std::ranges::input_range _Rg>
+    void assign_range(_Rg &&__rg) {
+        clear();
+        append_range(std::forward<_Rg>(__rg));
+    }
+
+    // 新元素放到离插入位置较近的一端再旋转过去，只挪动较短的一侧；
+    // 只能单遍读的区间长度未知，总是追加到末尾
+    template <std::ranges::input_range _Rg>
+    iterator insert_range(const_iterator __pos, _Rg &&__rg) {
+        const difference_type __offset = __pos - cbegin();
+        const difference_type __old_size = size();
+        if constexpr (std::ranges::forward_range<_Rg> ||
+                      std::ranges::sized_range<_Rg>) {
+            if (__offset < __old_size / 2) {
+                const difference_type __n = std::ranges::distance(__rg);
+                _prepend_n(std::ranges::begin(__rg),
+                           static_cast<size_type>(__n));
+                std::rotate(begin(), begin() + __n, begin() + __n + __offset);
+                return begin() + __offset;
+            }
+        }
+        append_range(std::forward<_Rg>(__rg));
+        std::rotate(begin() + __offset, begin() + __old_size, end());
+        return begin() + __offset;
     }
 
     void pop_front() noexcept {
@@ -1038,6 +1334,8 @@ public:
         std::swap(_map_size, __other._map_size);
         std::swap(_start, __other._start);
         std::swap(_finish, __other._finish);
+        std::swap(_spare_blocks, __other._spare_blocks);
+        std::swap(_spare_count, __other._spare_count);
         if (std::allocator_traits<
                 allocator_type>::propagate_on_container_swap::value) {
             std::swap(_alloc, __other._alloc);
@@ -1045,56 +1343,58 @@ public:
     }
 };
 
-template <typename _Tp, typename _Alloc>
-void swap(deque<_Tp, _Alloc> &__lhs, deque<_Tp, _Alloc> &__rhs) {
+template <typename _Tp, typename _Alloc, std::size_t _BlockSize>
+void swap(deque<_Tp, _Alloc, _BlockSize> &__lhs,
+          deque<_Tp, _Alloc, _BlockSize> &__rhs) {
     __lhs.swap(__rhs);
 }
 
 #if __cpp_lib_three_way_comparison
-template <class _Tp, class _Alloc>
-inline std::strong_ordering operator<=>(const Marcus::deque<_Tp, _Alloc> &__x,
-                                        const Marcus::deque<_Tp, _Alloc> &__y) {
+template <class _Tp, class _Alloc, std::size_t _BlockSize>
+inline std::strong_ordering
+operator<=>(const Marcus::deque<_Tp, _Alloc, _BlockSize> &__x,
+            const Marcus::deque<_Tp, _Alloc, _BlockSize> &__y) {
     return std::lexicographical_compare_three_way(__x.begin(), __x.end(),
                                                   __y.begin(), __y.end());
 }
 #else
-template <class _Tp, class _Alloc>
-inline bool operator!=(const Marcus::deque<_Tp, _Alloc> &__x,
-                       const Marcus::deque<_Tp, _Alloc> &__y) {
+template <class _Tp, class _Alloc, std::size_t _BlockSize>
+inline bool operator!=(const Marcus::deque<_Tp, _Alloc, _BlockSize> &__x,
+                       const Marcus::deque<_Tp, _Alloc, _BlockSize> &__y) {
     return !(__x == __y);
 }
 
-template <class _Tp, class _Alloc>
-inline bool operator<(const Marcus::deque<_Tp, _Alloc> &__x,
-                      const Marcus::deque<_Tp, _Alloc> &__y) {
-    return std::lexicographical_compare(__x.begin(), __x.end(), __y.begin(),
-                                        __y.end());
+template <class _Tp, class _Alloc, std::size_t _BlockSize>
+inline bool operator<(const Marcus::deque<_Tp, _Alloc, _BlockSize> &__x,
+                      const Marcus::deque<_Tp, _Alloc, _BlockSize> &__y) {
+    return Marcus::lexicographical_compare(__x.begin(), __x.end(),
+                                           __y.begin(), __y.end());
 }
 
-template <class _Tp, class _Alloc>
-inline bool operator>(const Marcus::deque<_Tp, _Alloc> &__x,
-                      const Marcus::deque<_Tp, _Alloc> &__y) {
+template <class _Tp, class _Alloc, std::size_t _BlockSize>
+inline bool operator>(const Marcus::deque<_Tp, _Alloc, _BlockSize> &__x,
+                      const Marcus::deque<_Tp, _Alloc, _BlockSize> &__y) {
     return __y < __x;
 }
 
-template <class _Tp, class _Alloc>
-inline bool operator<=(const Marcus::deque<_Tp, _Alloc> &__x,
-                       const Marcus::deque<_Tp, _Alloc> &__y) {
+template <class _Tp, class _Alloc, std::size_t _BlockSize>
+inline bool operator<=(const Marcus::deque<_Tp, _Alloc, _BlockSize> &__x,
+                       const Marcus::deque<_Tp, _Alloc, _BlockSize> &__y) {
     return !(__y < __x);
 }
 
-template <class _Tp, class _Alloc>
-inline bool operator>=(const Marcus::deque<_Tp, _Alloc> &__x,
-                       const Marcus::deque<_Tp, _Alloc> &__y) {
+template <class _Tp, class _Alloc, std::size_t _BlockSize>
+inline bool operator>=(const Marcus::deque<_Tp, _Alloc, _BlockSize> &__x,
+                       const Marcus::deque<_Tp, _Alloc, _BlockSize> &__y) {
     return !(__x < __y);
 }
 #endif
 
-template <typename _Tp, typename _Alloc>
-inline bool operator==(const deque<_Tp, _Alloc> &__x,
-                       const deque<_Tp, _Alloc> &__y) {
+template <typename _Tp, typename _Alloc, std::size_t _BlockSize>
+inline bool operator==(const deque<_Tp, _Alloc, _BlockSize> &__x,
+                       const deque<_Tp, _Alloc, _BlockSize> &__y) {
     return __x.size() == __y.size() &&
-           std::equal(__x.begin(), __x.end(), __y.begin());
+           Marcus::equal(__x.begin(), __x.end(), __y.begin());
 }
 
 } // namespace Marcus
@@ -0,0 +1,611 @@
+#pragma once
+
+#include <algorithm>
+#include <common/_common.hpp>
+#include <containers/core/_Flat.hpp>
+#include <containers/vector.hpp>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace Marcus {
+
+// 有序 vector 实现的映射：键和值分开存放，二分查找只触碰键数组
+template <typename _Key, typename _Mapped, typename _Compare = std::less<_Key>,
+          typename _KeyContainer = vector<_Key>,
+          typename _MappedContainer = vector<_Mapped>>
+struct flat_map {
+    using key_type = _Key;
+    using mapped_type = _Mapped;
+    using value_type = std::pair<_Key, _Mapped>;
+    using key_compare = _Compare;
+    using key_container_type = _KeyContainer;
+    using mapped_container_type = _MappedContainer;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const _Key &, _Mapped &>;
+    using const_reference = std::pair<const _Key &, const _Mapped &>;
+    using iterator = _FlatMapIterator<_Key, _Mapped>;
+    using const_iterator = _FlatMapIterator<_Key, const _Mapped>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    struct containers {
+        _KeyContainer keys;
+        _MappedContainer values;
+    };
+
+private:
+    _KeyContainer _M_keys;
+    _MappedContainer _M_values;
+    [[no_unique_address]] _Compare _M_comp;
+
+    const _Key *_M_key_data() const noexcept {
+        return _M_keys.data();
+    }
+
+    iterator _M_iter(size_type __i) noexcept {
+        return {_M_keys.data() + __i, _M_values.data() + __i};
+    }
+
+    const_iterator _M_iter(size_type __i) const noexcept {
+        return {_M_keys.data() + __i, _M_values.data() + __i};
+    }
+
+    // [0, __from) 有序无重复，[__from, size) 是任意顺序的新元素
+    // 键值分开存放，所以尾部按下标排序，再与前缀做一次线性归并
+    // 重复的键保留先出现的那一个；__sorted 时尾部已有序无重复
+    void _M_merge_tail(size_type __from, bool __sorted = false) {
+        size_type __size = _M_keys.size();
+        if (__from == __size) {
+            return;
+        }
+        vector<size_type> __perm;
+        __perm.reserve(__size - __from);
+        for (size_type __i = __from; __i != __size; ++__i) {
+            __perm.push_back(__i);
+        }
+        if (!__sorted) {
+            std::stable_sort(__perm.begin(), __perm.end(),
+                             [this](size_type __x, size_type __y) {
+                                 return _M_comp(_M_keys[__x], _M_keys[__y]);
+                             });
+        }
+        // 尾部整体大于前缀时（顺序追加）只重排尾部，前缀不动
+        bool __append =
+            __from == 0 || _M_comp(_M_keys[__from - 1], _M_keys[__perm[0]]);
+        if (__append && __sorted) {
+            return;
+        }
+        _KeyContainer __keys;
+        _MappedContainer __values;
+        __keys.reserve(__append ? __size - __from : __size);
+        __values.reserve(__append ? __size - __from : __size);
+        auto __emit = [&](size_type __src) {
+            if (!__keys.empty() && !_M_comp(__keys.back(), _M_keys[__src])) {
+                return;
+            }
+            __keys.push_back(std::move(_M_keys[__src]));
+            __values.push_back(std::move(_M_values[__src]));
+        };
+        size_type __i = __append ? __from : 0;
+        size_type __j = 0;
+        while (__i != __from && __j != __perm.size()) {
+            if (_M_comp(_M_keys[__perm[__j]], _M_keys[__i])) {
+                __emit(__perm[__j++]);
+            } else {
+                __emit(__i++);
+            }
+        }
+        for (; __i != __from; ++__i) {
+            __emit(__i);
+        }
+        for (; __j != __perm.size(); ++__j) {
+            __emit(__perm[__j]);
+        }
+        if (!__append) {
+            _M_keys = std::move(__keys);
+            _M_values = std::move(__values);
+            return;
+        }
+        _M_keys.erase(_M_keys.data() + __from, _M_keys.data() + __size);
+        _M_values.erase(_M_values.data() + __from, _M_values.data() + __size);
+        for (size_type __k = 0; __k != __keys.size(); ++__k) {
+            _M_keys.push_back(std::move(__keys[__k]));
+            _M_values.push_back(std::move(__values[__k]));
+        }
+    }
+
+    template <class _Kv>
+    size_type _M_lower_bound(const _Kv &__key) const {
+        return std::lower_bound(_M_key_data(),
+                                _M_key_data() + _M_keys.size(), __key,
+                                _M_comp) -
+               _M_key_data();
+    }
+
+    template <class _Kv>
+    size_type _M_upper_bound(const _Kv &__key) const {
+        return std::upper_bound(_M_key_data(),
+                                _M_key_data() + _M_keys.size(), __key,
+                                _M_comp) -
+               _M_key_data();
+    }
+
+    template <class _Kv>
+    size_type _M_find(const _Kv &__key) const {
+        size_type __i = _M_lower_bound(__key);
+        if (__i != _M_keys.size() && !_M_comp(__key, _M_keys[__i])) {
+            return __i;
+        }
+        return _M_keys.size();
+    }
+
+    template <class _Kv>
+    bool _M_found(size_type __i, const _Kv &__key) const {
+        return __i != _M_keys.size() && !_M_comp(__key, _M_keys[__i]);
+    }
+
+    template <class _Kv, class... _Args>
+    iterator _M_emplace_at(size_type __i, _Kv &&__key, _Args &&...__args) {
+        _M_keys.emplace(_M_keys.data() + __i, std::forward<_Kv>(__key));
+        try {
+            _M_values.emplace(_M_values.data() + __i,
+                              std::forward<_Args>(__args)...);
+        } catch (...) {
+            _M_keys.erase(_M_keys.data() + __i);
+            throw;
+        }
+        return _M_iter(__i);
+    }
+
+    template <class _Kv, class... _Args>
+    std::pair<iterator, bool> _M_try_emplace(_Kv &&__key, _Args &&...__args) {
+        size_type __i = _M_lower_bound(__key);
+        if (_M_found(__i, __key)) {
+            return {_M_iter(__i), false};
+        }
+        return {_M_emplace_at(__i, std::forward<_Kv>(__key),
+                              std::forward<_Args>(__args)...),
+                true};
+    }
+
+    template <std::input_iterator _InputIt>
+    void _M_append(_InputIt __first, _InputIt __last) {
+        size_type __from = _M_keys.size();
+        try {
+            for (; __first != __last; ++__first) {
+                auto &&__value = *__first;
+                _M_keys.emplace_back(__value.first);
+                _M_values.emplace_back(__value.second);
+            }
+        } catch (...) {
+            _M_keys.erase(_M_keys.data() + __from,
+                          _M_keys.data() + _M_keys.size());
+            _M_values.erase(_M_values.data() + __from,
+                            _M_values.data() + _M_values.size());
+            throw;
+        }
+    }
+
+public:
+    flat_map() = default;
+
+    explicit flat_map(_Compare __comp) : _M_comp(__comp) {}
+
+    flat_map(_KeyContainer __keys, _MappedContainer __values,
+             _Compare __comp = _Compare())
+        : _M_keys(std::move(__keys)),
+          _M_values(std::move(__values)),
+          _M_comp(__comp) {
+        if (_M_keys.size() != _M_values.size()) [[unlikely]] {
+            throw std::invalid_argument(
+                "flat_map: key and value containers differ in size");
+        }
+        _M_merge_tail(0);
+    }
+
+    flat_map(sorted_unique_t, _KeyContainer __keys, _MappedContainer __values,
+             _Compare __comp = _Compare())
+        : _M_keys(std::move(__keys)),
+          _M_values(std::move(__values)),
+          _M_comp(__comp) {
+        if (_M_keys.size() != _M_values.size()) [[unlikely]] {
+            throw std::invalid_argument(
+                "flat_map: key and value containers differ in size");
+        }
+    }
+
+    template <std::input_iterator _InputIt>
+    flat_map(_InputIt __first, _InputIt __last, _Compare __comp = _Compare())
+        : _M_comp(__comp) {
+        insert(__first, __last);
+    }
+
+    template <std::input_iterator _InputIt>
+    flat_map(sorted_unique_t, _InputIt __first, _InputIt __last,
+             _Compare __comp = _Compare())
+        : _M_comp(__comp) {
+        insert(sorted_unique, __first, __last);
+    }
+
+    flat_map(std::initializer_list<value_type> __ilist,
+             _Compare __comp = _Compare())
+        : flat_map(__ilist.begin(), __ilist.end(), __comp) {}
+
+    flat_map(flat_map &&) = default;
+    flat_map &operator=(flat_map &&) = default;
+
+    flat_map(const flat_map &__that) : _M_comp(__that._M_comp) {
+        _M_keys.reserve(__that.size());
+        _M_values.reserve(__that.size());
+        for (size_type __i = 0; __i != __that.size(); ++__i) {
+            _M_keys.push_back(__that._M_keys[__i]);
+            _M_values.push_back(__that._M_values[__i]);
+        }
+    }
+
+    flat_map &operator=(const flat_map &__that) {
+        if (&__that != this) {
+            flat_map __tmp(__that);
+            swap(__tmp);
+        }
+        return *this;
+    }
+
+    flat_map &operator=(std::initializer_list<value_type> __ilist) {
+        clear();
+        insert(__ilist);
+        return *this;
+    }
+
+    iterator begin() noexcept {
+        return _M_iter(0);
+    }
+
+    iterator end() noexcept {
+        return _M_iter(_M_keys.size());
+    }
+
+    const_iterator begin() const noexcept {
+        return _M_iter(0);
+    }
+
+    const_iterator end() const noexcept {
+        return _M_iter(_M_keys.size());
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return std::make_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return std::make_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return std::make_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return std::make_reverse_iterator(begin());
+    }
+
+    bool empty() const noexcept {
+        return _M_keys.empty();
+    }
+
+    size_type size() const noexcept {
+        return _M_keys.size();
+    }
+
+    void reserve(size_type __n) {
+        _M_keys.reserve(__n);
+        _M_values.reserve(__n);
+    }
+
+    void clear() noexcept {
+        _M_keys.clear();
+        _M_values.clear();
+    }
+
+    void swap(flat_map &__that) noexcept {
+        _M_keys.swap(__that._M_keys);
+        _M_values.swap(__that._M_values);
+        std::swap(_M_comp, __that._M_comp);
+    }
+
+    key_compare key_comp() const noexcept {
+        return _M_comp;
+    }
+
+    const _KeyContainer &keys() const noexcept {
+        return _M_keys;
+    }
+
+    const _MappedContainer &values() const noexcept {
+        return _M_values;
+    }
+
+    containers extract() && {
+        containers __c{std::move(_M_keys), std::move(_M_values)};
+        clear();
+        return __c;
+    }
+
+    // __keys 必须已经有序且无重复，并与 __values 一一对应
+    void replace(_KeyContainer &&__keys, _MappedContainer &&__values) {
+        if (__keys.size() != __values.size()) [[unlikely]] {
+            throw std::invalid_argument(
+                "flat_map: key and value containers differ in size");
+        }
+        _M_keys = std::move(__keys);
+        _M_values = std::move(__values);
+    }
+
+    _Mapped &at(const _Key &__key) {
+        size_type __i = _M_find(__key);
+        if (__i == _M_keys.size()) [[unlikely]] {
+            throw std::out_of_range("flat_map::at");
+        }
+        return _M_values[__i];
+    }
+
+    const _Mapped &at(const _Key &__key) const {
+        size_type __i = _M_find(__key);
+        if (__i == _M_keys.size()) [[unlikely]] {
+            throw std::out_of_range("flat_map::at");
+        }
+        return _M_values[__i];
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    _Mapped &at(const _Kv &__key) {
+        size_type __i = _M_find(__key);
+        if (__i == _M_keys.size()) [[unlikely]] {
+            throw std::out_of_range("flat_map::at");
+        }
+        return _M_values[__i];
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    const _Mapped &at(const _Kv &__key) const {
+        size_type __i = _M_find(__key);
+        if (__i == _M_keys.size()) [[unlikely]] {
+            throw std::out_of_range("flat_map::at");
+        }
+        return _M_values[__i];
+    }
+
+    _Mapped &operator[](const _Key &__key) {
+        return _M_try_emplace(__key).first->second;
+    }
+
+    _Mapped &operator[](_Key &&__key) {
+        return _M_try_emplace(std::move(__key)).first->second;
+    }
+
+    template <class... _Args>
+    std::pair<iterator, bool> try_emplace(const _Key &__key,
+                                          _Args &&...__args) {
+        return _M_try_emplace(__key, std::forward<_Args>(__args)...);
+    }
+
+    template <class... _Args>
+    std::pair<iterator, bool> try_emplace(_Key &&__key, _Args &&...__args) {
+        return _M_try_emplace(std::move(__key), std::forward<_Args>(__args)...);
+    }
+
+    template <class _Vp>
+    std::pair<iterator, bool> insert_or_assign(const _Key &__key,
+                                               _Vp &&__val) {
+        auto __ret = _M_try_emplace(__key, std::forward<_Vp>(__val));
+        if (!__ret.second) {
+            __ret.first->second = std::forward<_Vp>(__val);
+        }
+        return __ret;
+    }
+
+    template <class _Vp>
+    std::pair<iterator, bool> insert_or_assign(_Key &&__key, _Vp &&__val) {
+        auto __ret = _M_try_emplace(std::move(__key), std::forward<_Vp>(__val));
+        if (!__ret.second) {
+            __ret.first->second = std::forward<_Vp>(__val);
+        }
+        return __ret;
+    }
+
+    template <class... _Args>
+    std::pair<iterator, bool> emplace(_Args &&...__args) {
+        value_type __value(std::forward<_Args>(__args)...);
+        return _M_try_emplace(std::move(__value.first),
+                              std::move(__value.second));
+    }
+
+    std::pair<iterator, bool> insert(const value_type &__value) {
+        return _M_try_emplace(__value.first, __value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&__value) {
+        return _M_try_emplace(std::move(__value.first),
+                              std::move(__value.second));
+    }
+
+    // 批量插入：先追加到末尾，再整体排序归并，O(n + m log m)
+    template <std::input_iterator _InputIt>
+    void insert(_InputIt __first, _InputIt __last) {
+        size_type __from = _M_keys.size();
+        _M_append(__first, __last);
+        _M_merge_tail(__from);
+    }
+
+    // [__first, __last) 必须已经有序且无重复，省去排序
+    template <std::input_iterator _InputIt>
+    void insert(sorted_unique_t, _InputIt __first, _InputIt __last) {
+        size_type __from = _M_keys.size();
+        _M_append(__first, __last);
+        _M_merge_tail(__from, true);
+    }
+
+    void insert(std::initializer_list<value_type> __ilist) {
+        insert(__ilist.begin(), __ilist.end());
+    }
+
+    template <class _Range>
+    void insert_range(_Range &&__range) {
+        insert(std::ranges::begin(__range), std::ranges::end(__range));
+    }
+
+    iterator erase(const_iterator __it) {
+        size_type __i = __it._M_key - _M_key_data();
+        _M_keys.erase(_M_keys.data() + __i);
+        _M_values.erase(_M_values.data() + __i);
+        return _M_iter(__i);
+    }
+
+    iterator erase(iterator __it) {
+        return erase(const_iterator(__it));
+    }
+
+    iterator erase(const_iterator __first, const_iterator __last) {
+        size_type __i = __first._M_key - _M_key_data();
+        size_type __j = __last._M_key - _M_key_data();
+        _M_keys.erase(_M_keys.data() + __i, _M_keys.data() + __j);
+        _M_values.erase(_M_values.data() + __i, _M_values.data() + __j);
+        return _M_iter(__i);
+    }
+
+    size_type erase(const _Key &__key) {
+        size_type __i = _M_find(__key);
+        if (__i == _M_keys.size()) {
+            return 0;
+        }
+        erase(_M_iter(__i));
+        return 1;
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    size_type erase(const _Kv &__key) {
+        size_type __i = _M_lower_bound(__key);
+        size_type __j = _M_upper_bound(__key);
+        erase(_M_iter(__i), _M_iter(__j));
+        return __j - __i;
+    }
+
+    iterator find(const _Key &__key) {
+        return _M_iter(_M_find(__key));
+    }
+
+    const_iterator find(const _Key &__key) const {
+        return _M_iter(_M_find(__key));
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    iterator find(const _Kv &__key) {
+        return _M_iter(_M_find(__key));
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    const_iterator find(const _Kv &__key) const {
+        return _M_iter(_M_find(__key));
+    }
+
+    size_type count(const _Key &__key) const {
+        return _M_find(__key) != _M_keys.size() ? 1 : 0;
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    size_type count(const _Kv &__key) const {
+        return _M_upper_bound(__key) - _M_lower_bound(__key);
+    }
+
+    bool contains(const _Key &__key) const {
+        return _M_find(__key) != _M_keys.size();
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    bool contains(const _Kv &__key) const {
+        return _M_find(__key) != _M_keys.size();
+    }
+
+    iterator lower_bound(const _Key &__key) {
+        return _M_iter(_M_lower_bound(__key));
+    }
+
+    const_iterator lower_bound(const _Key &__key) const {
+        return _M_iter(_M_lower_bound(__key));
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    iterator lower_bound(const _Kv &__key) {
+        return _M_iter(_M_lower_bound(__key));
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    const_iterator lower_bound(const _Kv &__key) const {
+        return _M_iter(_M_lower_bound(__key));
+    }
+
+    iterator upper_bound(const _Key &__key) {
+        return _M_iter(_M_upper_bound(__key));
+    }
+
+    const_iterator upper_bound(const _Key &__key) const {
+        return _M_iter(_M_upper_bound(__key));
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    iterator upper_bound(const _Kv &__key) {
+        return _M_iter(_M_upper_bound(__key));
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    const_iterator upper_bound(const _Kv &__key) const {
+        return _M_iter(_M_upper_bound(__key));
+    }
+
+    std::pair<iterator, iterator> equal_range(const _Key &__key) {
+        return {lower_bound(__key), upper_bound(__key)};
+    }
+
+    std::pair<const_iterator, const_iterator>
+    equal_range(const _Key &__key) const {
+        return {lower_bound(__key), upper_bound(__key)};
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    std::pair<iterator, iterator> equal_range(const _Kv &__key) {
+        return {lower_bound(__key), upper_bound(__key)};
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    std::pair<const_iterator, const_iterator>
+    equal_range(const _Kv &__key) const {
+        return {lower_bound(__key), upper_bound(__key)};
+    }
+
+    _LIBPENGCXX_DEFINE_COMPARISON(flat_map);
+};
+
+} // namespace Marcus
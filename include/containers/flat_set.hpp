@@ -0,0 +1,379 @@
+#pragma once
+
+#include <algorithm>
+#include <common/_common.hpp>
+#include <containers/core/_Flat.hpp>
+#include <containers/vector.hpp>
+#include <functional>
+#include <initializer_list>
+
+namespace Marcus {
+
+// 有序 vector 实现的集合：查找是连续内存上的二分，遍历就是线性扫描
+template <typename _Key, typename _Compare = std::less<_Key>,
+          typename _KeyContainer = vector<_Key>>
+struct flat_set {
+    using key_type = _Key;
+    using value_type = _Key;
+    using key_compare = _Compare;
+    using value_compare = _Compare;
+    using container_type = _KeyContainer;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const _Key &;
+    using const_reference = const _Key &;
+    using iterator = const _Key *;
+    using const_iterator = const _Key *;
+    using reverse_iterator = std::reverse_iterator<const _Key *>;
+    using const_reverse_iterator = std::reverse_iterator<const _Key *>;
+
+private:
+    _KeyContainer _M_keys;
+    [[no_unique_address]] _Compare _M_comp;
+
+    const _Key *_M_data() const noexcept {
+        return _M_keys.data();
+    }
+
+    bool _M_equiv(const _Key &__x, const _Key &__y) const {
+        return !_M_comp(__x, __y) && !_M_comp(__y, __x);
+    }
+
+    // [0, __from) 有序无重复，[__from, size) 是任意顺序的新元素
+    // 先把尾部排序去重（__sorted 时尾部已有序无重复），再与前缀做一次线性归并
+    // 相等时保留先出现的元素
+    void _M_merge_tail(size_type __from, bool __sorted = false) {
+        size_type __size = _M_keys.size();
+        if (__from == __size) {
+            return;
+        }
+        if (!__sorted) {
+            _Key *__tail = _M_keys.data() + __from;
+            std::stable_sort(__tail, _M_keys.data() + __size, _M_comp);
+            _Key *__last = std::unique(
+                __tail, _M_keys.data() + __size,
+                [this](const _Key &__x, const _Key &__y) {
+                    return _M_equiv(__x, __y);
+                });
+            _M_keys.erase(__last, _M_keys.data() + __size);
+            __size = _M_keys.size();
+        }
+        // 尾部整体大于前缀时（顺序追加）无需归并
+        if (__from == 0 || _M_comp(_M_keys[__from - 1], _M_keys[__from])) {
+            return;
+        }
+        _KeyContainer __merged;
+        __merged.reserve(__size);
+        size_type __i = 0;
+        size_type __j = __from;
+        while (__i != __from && __j != __size) {
+            if (_M_comp(_M_keys[__j], _M_keys[__i])) {
+                __merged.push_back(std::move(_M_keys[__j++]));
+            } else {
+                if (!_M_comp(_M_keys[__i], _M_keys[__j])) {
+                    ++__j;
+                }
+                __merged.push_back(std::move(_M_keys[__i++]));
+            }
+        }
+        for (; __i != __from; ++__i) {
+            __merged.push_back(std::move(_M_keys[__i]));
+        }
+        for (; __j != __size; ++__j) {
+            __merged.push_back(std::move(_M_keys[__j]));
+        }
+        _M_keys = std::move(__merged);
+    }
+
+    template <class _Kv>
+    const _Key *_M_lower_bound(const _Kv &__key) const {
+        return std::lower_bound(_M_data(), _M_data() + _M_keys.size(), __key,
+                                _M_comp);
+    }
+
+    template <class _Kv>
+    const _Key *_M_upper_bound(const _Kv &__key) const {
+        return std::upper_bound(_M_data(), _M_data() + _M_keys.size(), __key,
+                                _M_comp);
+    }
+
+    template <class _Kv>
+    const _Key *_M_find(const _Kv &__key) const {
+        const _Key *__it = _M_lower_bound(__key);
+        if (__it != end() && !_M_comp(__key, *__it)) {
+            return __it;
+        }
+        return end();
+    }
+
+public:
+    flat_set() = default;
+
+    explicit flat_set(_Compare __comp) : _M_comp(__comp) {}
+
+    explicit flat_set(_KeyContainer __keys, _Compare __comp = _Compare())
+        : _M_keys(std::move(__keys)),
+          _M_comp(__comp) {
+        _M_merge_tail(0);
+    }
+
+    flat_set(sorted_unique_t, _KeyContainer __keys,
+             _Compare __comp = _Compare())
+        : _M_keys(std::move(__keys)),
+          _M_comp(__comp) {}
+
+    template <std::input_iterator _InputIt>
+    flat_set(_InputIt __first, _InputIt __last, _Compare __comp = _Compare())
+        : _M_comp(__comp) {
+        insert(__first, __last);
+    }
+
+    template <std::input_iterator _InputIt>
+    flat_set(sorted_unique_t, _InputIt __first, _InputIt __last,
+             _Compare __comp = _Compare())
+        : _M_comp(__comp) {
+        insert(sorted_unique, __first, __last);
+    }
+
+    flat_set(std::initializer_list<_Key> __ilist, _Compare __comp = _Compare())
+        : flat_set(__ilist.begin(), __ilist.end(), __comp) {}
+
+    flat_set(flat_set &&) = default;
+    flat_set &operator=(flat_set &&) = default;
+
+    flat_set(const flat_set &__that) : _M_comp(__that._M_comp) {
+        _M_keys.reserve(__that.size());
+        for (const _Key &__key: __that._M_keys) {
+            _M_keys.push_back(__key);
+        }
+    }
+
+    flat_set &operator=(const flat_set &__that) {
+        if (&__that != this) {
+            flat_set __tmp(__that);
+            swap(__tmp);
+        }
+        return *this;
+    }
+
+    flat_set &operator=(std::initializer_list<_Key> __ilist) {
+        clear();
+        insert(__ilist);
+        return *this;
+    }
+
+    const_iterator begin() const noexcept {
+        return _M_data();
+    }
+
+    const_iterator end() const noexcept {
+        return _M_data() + _M_keys.size();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return std::make_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return std::make_reverse_iterator(begin());
+    }
+
+    bool empty() const noexcept {
+        return _M_keys.empty();
+    }
+
+    size_type size() const noexcept {
+        return _M_keys.size();
+    }
+
+    void reserve(size_type __n) {
+        _M_keys.reserve(__n);
+    }
+
+    void clear() noexcept {
+        _M_keys.clear();
+    }
+
+    void swap(flat_set &__that) noexcept {
+        _M_keys.swap(__that._M_keys);
+        std::swap(_M_comp, __that._M_comp);
+    }
+
+    key_compare key_comp() const noexcept {
+        return _M_comp;
+    }
+
+    value_compare value_comp() const noexcept {
+        return _M_comp;
+    }
+
+    const _KeyContainer &keys() const noexcept {
+        return _M_keys;
+    }
+
+    _KeyContainer extract() && {
+        _KeyContainer __keys = std::move(_M_keys);
+        _M_keys.clear();
+        return __keys;
+    }
+
+    // __keys 必须已经有序且无重复
+    void replace(_KeyContainer &&__keys) {
+        _M_keys = std::move(__keys);
+    }
+
+    template <class... _Args>
+    std::pair<iterator, bool> emplace(_Args &&...__args) {
+        _Key __key(std::forward<_Args>(__args)...);
+        const _Key *__it = _M_lower_bound(__key);
+        if (__it != end() && !_M_comp(__key, *__it)) {
+            return {__it, false};
+        }
+        return {_M_keys.insert(__it, std::move(__key)), true};
+    }
+
+    std::pair<iterator, bool> insert(const _Key &__key) {
+        const _Key *__it = _M_lower_bound(__key);
+        if (__it != end() && !_M_comp(__key, *__it)) {
+            return {__it, false};
+        }
+        return {_M_keys.insert(__it, __key), true};
+    }
+
+    std::pair<iterator, bool> insert(_Key &&__key) {
+        const _Key *__it = _M_lower_bound(__key);
+        if (__it != end() && !_M_comp(__key, *__it)) {
+            return {__it, false};
+        }
+        return {_M_keys.insert(__it, std::move(__key)), true};
+    }
+
+    // 批量插入：先追加到末尾，再整体排序归并，O(n + m log m)
+    template <std::input_iterator _InputIt>
+    void insert(_InputIt __first, _InputIt __last) {
+        size_type __from = _M_keys.size();
+        for (; __first != __last; ++__first) {
+            _M_keys.emplace_back(*__first);
+        }
+        _M_merge_tail(__from);
+    }
+
+    // [__first, __last) 必须已经有序且无重复，省去排序
+    template <std::input_iterator _InputIt>
+    void insert(sorted_unique_t, _InputIt __first, _InputIt __last) {
+        size_type __from = _M_keys.size();
+        for (; __first != __last; ++__first) {
+            _M_keys.emplace_back(*__first);
+        }
+        _M_merge_tail(__from, true);
+    }
+
+    void insert(std::initializer_list<_Key> __ilist) {
+        insert(__ilist.begin(), __ilist.end());
+    }
+
+    template <class _Range>
+    void insert_range(_Range &&__range) {
+        insert(std::ranges::begin(__range), std::ranges::end(__range));
+    }
+
+    iterator erase(const_iterator __it) {
+        return _M_keys.erase(__it);
+    }
+
+    iterator erase(const_iterator __first, const_iterator __last) {
+        return _M_keys.erase(__first, __last);
+    }
+
+    size_type erase(const _Key &__key) {
+        const _Key *__first = _M_lower_bound(__key);
+        const _Key *__last = _M_upper_bound(__key);
+        size_type __n = __last - __first;
+        _M_keys.erase(__first, __last);
+        return __n;
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    size_type erase(const _Kv &__key) {
+        const _Key *__first = _M_lower_bound(__key);
+        const _Key *__last = _M_upper_bound(__key);
+        size_type __n = __last - __first;
+        _M_keys.erase(__first, __last);
+        return __n;
+    }
+
+    const_iterator find(const _Key &__key) const {
+        return _M_find(__key);
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    const_iterator find(const _Kv &__key) const {
+        return _M_find(__key);
+    }
+
+    size_type count(const _Key &__key) const {
+        return _M_find(__key) != end() ? 1 : 0;
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    size_type count(const _Kv &__key) const {
+        return _M_upper_bound(__key) - _M_lower_bound(__key);
+    }
+
+    bool contains(const _Key &__key) const {
+        return _M_find(__key) != end();
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    bool contains(const _Kv &__key) const {
+        return _M_find(__key) != end();
+    }
+
+    const_iterator lower_bound(const _Key &__key) const {
+        return _M_lower_bound(__key);
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    const_iterator lower_bound(const _Kv &__key) const {
+        return _M_lower_bound(__key);
+    }
+
+    const_iterator upper_bound(const _Key &__key) const {
+        return _M_upper_bound(__key);
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    const_iterator upper_bound(const _Kv &__key) const {
+        return _M_upper_bound(__key);
+    }
+
+    std::pair<const_iterator, const_iterator>
+    equal_range(const _Key &__key) const {
+        return {_M_lower_bound(__key), _M_upper_bound(__key)};
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _Compare, _Kv, _Key)>
+    std::pair<const_iterator, const_iterator>
+    equal_range(const _Kv &__key) const {
+        return {_M_lower_bound(__key), _M_upper_bound(__key)};
+    }
+
+    _LIBPENGCXX_DEFINE_COMPARISON(flat_set);
+};
+
+} // namespace Marcus
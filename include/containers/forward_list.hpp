@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <common/_common.hpp>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
@@ -220,11 +221,14 @@ public:
     }
 
     void clear() noexcept {
-        Node *cur = _dummy._next;
-        while (cur != nullptr) {
-            auto nxt = cur->_next;
-            destroyAndDeallocateNode(cur);
-            cur = nxt;
+        if (!(std::is_trivially_destructible_v<T> &&
+              _deallocate_is_noop(_alloc))) {
+            Node *cur = _dummy._next;
+            while (cur != nullptr) {
+                auto nxt = cur->_next;
+                destroyAndDeallocateNode(cur);
+                cur = nxt;
+            }
         }
         _dummy._next = nullptr;
     }
@@ -52,18 +52,73 @@ private:
     ListNode _dummy;
     std::size_t _size;
     [[no_unique_address]] Alloc _alloc;
+    // 删除的节点先用 _next 串在这里，下次插入直接复用，最多留 _cacheLimit 个
+    ListNode *_cachedNodes = nullptr;
+    std::size_t _cacheSize = 0;
+    std::size_t _cacheLimit = 0;
 
     ListNode *newNode() {
+        if (_cachedNodes != nullptr) {
+            ListNode *node = _cachedNodes;
+            _cachedNodes = node->_next;
+            --_cacheSize;
+            return node;
+        }
         AllocNode allocNode(_alloc);
         return std::allocator_traits<AllocNode>::allocate(allocNode, 1);
     }
 
-    void deleteNode(ListNode *node) noexcept {
+    void deallocateNode(ListNode *node) noexcept {
         AllocNode allocNode(_alloc);
         std::allocator_traits<AllocNode>::deallocate(
             allocNode, static_cast<ListValueNode<T> *>(node), 1);
     }
 
+    void deleteNode(ListNode *node) noexcept {
+        if (_cacheSize < _cacheLimit) {
+            node->_next = _cachedNodes;
+            _cachedNodes = node;
+            ++_cacheSize;
+            return;
+        }
+        deallocateNode(node);
+    }
+
+    void trimNodeCache(std::size_t keep) noexcept {
+        while (_cacheSize > keep) {
+            ListNode *node = _cachedNodes;
+            _cachedNodes = node->_next;
+            --_cacheSize;
+            deallocateNode(node);
+        }
+    }
+
+    // 分配器相等时节点可以直接换到另一条链表，之后由它释放
+    bool sameAllocator(const list &other) const noexcept {
+        if constexpr (std::allocator_traits<Alloc>::is_always_equal::value) {
+            return true;
+        } else {
+            return _alloc == other._alloc;
+        }
+    }
+
+    // 把 [first, last) 的节点摘下来接到 pos 之前，不改动 _size。
+    // pos 就是 first 或 last 时节点已经在原位
+    static void transferNodes(ListNode *pos, ListNode *first,
+                              ListNode *last) noexcept {
+        if (first == last || pos == first || pos == last) {
+            return;
+        }
+        ListNode *tail = last->_prev;
+        first->_prev->_next = last;
+        last->_prev = first->_prev;
+        ListNode *pre = pos->_prev;
+        pre->_next = first;
+        first->_prev = pre;
+        tail->_next = pos;
+        pos->_prev = tail;
+    }
+
 public:
     list() noexcept {
         _size = 0;
@@ -83,10 +138,13 @@ public:
         _uninit_move_assign(std::move(other));
     }
 
+    // 缓存的节点是用原来的分配器申请的，换分配器之前先还掉
     list &operator=(list &&other) {
-        _alloc = std::move(other._alloc);
         clear();
+        trimNodeCache(0);
+        _alloc = std::move(other._alloc);
         _uninit_move_assign(std::move(other));
+        return *this;
     }
 
 private:
@@ -111,7 +169,10 @@ public:
     }
 
     list &operator=(const list &other) {
-        assign(other.cbegin(), other.cend());
+        if (&other != this) {
+            assign(other.cbegin(), other.cend());
+        }
+        return *this;
     }
 
     bool empty() const noexcept {
@@ -154,6 +215,7 @@ public:
 
     list &operator=(std::initializer_list<T> _ilist) {
         assign(_ilist);
+        return *this;
     }
 
 private:
@@ -259,15 +321,35 @@ public:
 
     ~list() noexcept {
         clear();
+        trimNodeCache(0);
+    }
+
+    // 最多缓存 n 个删除下来的节点供之后的插入复用，0 (默认) 表示不缓存。
+    // 适合大小基本不变、不断有元素进出的链表，例如 LRU 缓存
+    void set_node_cache_limit(std::size_t n) noexcept {
+        _cacheLimit = n;
+        trimNodeCache(n);
+    }
+
+    std::size_t node_cache_limit() const noexcept {
+        return _cacheLimit;
     }
 
+    std::size_t node_cache_size() const noexcept {
+        return _cacheSize;
+    }
+
+    // 节点内存随 arena 整体回收、元素也不需要析构时，整条链表不必遍历
     void clear() noexcept {
-        ListNode *cur = _dummy._next;
-        while (cur != &_dummy) {
-            std::destroy_at(&cur->value());
-            auto nxt = cur->_next;
-            deleteNode(cur);
-            cur = nxt;
+        if (!(std::is_trivially_destructible_v<T> &&
+              _deallocate_is_noop(_alloc))) {
+            ListNode *cur = _dummy._next;
+            while (cur != &_dummy) {
+                std::destroy_at(&cur->value());
+                auto nxt = cur->_next;
+                deleteNode(cur);
+                cur = nxt;
+            }
         }
         _dummy._prev = _dummy._next = &_dummy;
         _size = 0;
@@ -316,6 +398,10 @@ public:
             return _cur->value();
         }
 
+        T *operator->() const noexcept {
+            return std::addressof(_cur->value());
+        }
+
         bool operator!=(const iterator &other) const noexcept {
             return _cur != other._cur;
         }
@@ -374,6 +460,10 @@ public:
             return _cur->value();
         }
 
+        const T *operator->() const noexcept {
+            return std::addressof(_cur->value());
+        }
+
         bool operator!=(const const_iterator &other) const noexcept {
             return _cur != other._cur;
         }
@@ -550,9 +640,67 @@ public:
         return insert(pos, ilist.begin(), ilist.end());
     }
 
+    // 分配器相等时只改指针，O(1)，不分配也不移动元素；
+    // 否则节点不能换主人，只能逐个移动元素再从 other 中删除
+    void splice(const_iterator pos, list &other) {
+        if (&other != this) {
+            splice(pos, other, other.cbegin(), other.cend());
+        }
+    }
+
     void splice(const_iterator pos, list &&other) {
-        insert(pos, std::make_move_iterator(other.begin()),
-               std::make_move_iterator(other.end()));
+        splice(pos, other);
+    }
+
+    void splice(const_iterator pos, list &other, const_iterator it) {
+        ListNode *node = const_cast<ListNode *>(it._cur);
+        if (&other == this || sameAllocator(other)) {
+            transferNodes(const_cast<ListNode *>(pos._cur), node,
+                          node->_next);
+            ++_size;
+            --other._size;
+        } else {
+            emplace(pos, std::move(node->value()));
+            other.erase(it);
+        }
+    }
+
+    void splice(const_iterator pos, list &&other, const_iterator it) {
+        splice(pos, other, it);
+    }
+
+    // 来自另一条链表时要数出区间长度来更新 size，是 O(区间长度)；
+    // 整条链表或同一条链表内的搬移是 O(1)
+    void splice(const_iterator pos, list &other, const_iterator first,
+                const_iterator last) {
+        if (&other == this) {
+            transferNodes(const_cast<ListNode *>(pos._cur),
+                          const_cast<ListNode *>(first._cur),
+                          const_cast<ListNode *>(last._cur));
+            return;
+        }
+        if (!sameAllocator(other)) {
+            while (first != last) {
+                ListNode *node = const_cast<ListNode *>(first._cur);
+                emplace(pos, std::move(node->value()));
+                first = other.erase(first);
+            }
+            return;
+        }
+        std::size_t n = first == other.cbegin() && last == other.cend()
+                            ? other._size
+                            : static_cast<std::size_t>(
+                                  std::distance(first, last));
+        transferNodes(const_cast<ListNode *>(pos._cur),
+                      const_cast<ListNode *>(first._cur),
+                      const_cast<ListNode *>(last._cur));
+        _size += n;
+        other._size -= n;
+    }
+
+    void splice(const_iterator pos, list &&other, const_iterator first,
+                const_iterator last) {
+        splice(pos, other, first, last);
     }
 
     Alloc get_allocator() const noexcept {
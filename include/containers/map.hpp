@@ -1,6 +1,7 @@
 #pragma once
 
 #include <common/_common.hpp>
+#include <containers/core/_BTree.hpp>
 #include <containers/core/_RbTree.hpp>
 #include <cstddef>
 #include <initializer_list>
@@ -31,7 +32,7 @@ public:
         return this->_M_comp(__lhs.first, __rhs.first);
     }
 
-    struct _RBTreeIsMap;
+    struct _RbTreeIsMap;
 };
 
 template <typename _Compare, typename _Value>
@@ -44,12 +45,16 @@ struct _RbTreeValueCompare<
     _RbTreeValueCompare(_Compare __comp = _Compare()) noexcept
         : _M_comp(__comp) {}
 
-    template <typename _Lhs>
+    template <typename _Lhs,
+              typename = std::enable_if_t<
+                  !std::is_same_v<std::remove_cvref_t<_Lhs>, _Value>>>
     bool operator()(_Lhs &&__lhs, const _Value &__rhs) const noexcept {
         return this->_M_comp(__lhs, __rhs.first);
     }
 
-    template <typename _Rhs>
+    template <typename _Rhs,
+              typename = std::enable_if_t<
+                  !std::is_same_v<std::remove_cvref_t<_Rhs>, _Value>>>
     bool operator()(const _Value &__lhs, _Rhs &&__rhs) const noexcept {
         return this->_M_comp(__lhs.first, __rhs);
     }
@@ -59,6 +64,8 @@ struct _RbTreeValueCompare<
     }
 
     using is_transparent = typename _Compare::is_transparent;
+
+    struct _RbTreeIsMap;
 };
 
 template <typename _Key, typename _Mapped, typename _Compare = std::less<_Key>,
@@ -83,36 +90,40 @@ public:
 
     map() = default;
 
+    explicit map(const _Alloc &__alloc, _Compare __comp = _Compare())
+        : _RbTreeImpl<value_type, _ValueComp, _Alloc>(__alloc, __comp) {}
+
     explicit map(_Compare __comp)
         : _RbTreeImpl<value_type, _ValueComp, _Alloc>(__comp) {}
 
     map(std::initializer_list<value_type> __ilist) {
-        _M_single_insert(__ilist.begin(), __ilist.end());
+        this->_M_single_insert(__ilist.begin(), __ilist.end());
     }
 
     explicit map(std::initializer_list<value_type> __ilist, _Compare __comp)
         : _RbTreeImpl<value_type, _ValueComp, _Alloc>(__comp) {
-        _M_single_insert(__ilist.begin(), __ilist.end());
+        this->_M_single_insert(__ilist.begin(), __ilist.end());
     }
 
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
     explicit map(_InputIt __first, _InputIt __last) {
-        _M_single_insert(__first, __last);
+        this->_M_single_insert(__first, __last);
     }
 
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
     explicit map(_InputIt __first, _InputIt __last, _Compare __comp)
         : _RbTreeImpl<value_type, _ValueComp, _Alloc>(__comp) {
-        _M_single_insert(__first, __last);
+        this->_M_single_insert(__first, __last);
     }
 
     map(map &&) = default;
 
     map &operator=(map &&) = default;
 
-    map(const map &__other) : _RbTreeImpl<value_type, _ValueComp, _Alloc>() {
+    map(const map &__other)
+        : _RbTreeImpl<value_type, _ValueComp, _Alloc>(__other.get_allocator()) {
         this->_M_single_insert(__other.begin(), __other.end());
     }
 
@@ -161,6 +172,8 @@ public:
         return this->_M_find(__key);
     }
 
+    using _RbTreeImpl<value_type, _ValueComp, _Alloc>::insert;
+
     std::pair<iterator, bool> insert(value_type &&__value) {
         return this->_M_single_emplace(std::move(__value));
     }
@@ -259,6 +272,47 @@ public:
         return this->_M_single_emplace(std::forward<Vs>(__value)...);
     }
 
+    // 提示位置正确时直接挂在 __hint 旁边，适合按顺序追加
+    template <typename... _Ts>
+    iterator emplace_hint(const_iterator __hint, _Ts &&...__value) {
+        return this->_M_single_emplace_hint(__hint, std::forward<_Ts>(__value)...);
+    }
+
+    iterator insert(const_iterator __hint, value_type &&__value) {
+        return this->_M_single_emplace_hint(__hint, std::move(__value));
+    }
+
+    iterator insert(const_iterator __hint, const value_type &__value) {
+        return this->_M_single_emplace_hint(__hint, __value);
+    }
+
+    void merge(_RbTreeImpl<value_type, _ValueComp, _Alloc> &__that) {
+        this->template _M_merge<false>(__that);
+    }
+
+    void merge(_RbTreeImpl<value_type, _ValueComp, _Alloc> &&__that) {
+        this->template _M_merge<false>(__that);
+    }
+
+    void set_union(const map &__that) {
+        map __copy(__that);
+        this->template _M_merge<false>(__copy);
+    }
+
+    void set_union(map &&__that) {
+        this->template _M_merge<false>(__that);
+    }
+
+    void set_intersection(
+        const _RbTreeImpl<value_type, _ValueComp, _Alloc> &__that) noexcept {
+        this->template _M_filter<true>(__that);
+    }
+
+    void set_difference(
+        const _RbTreeImpl<value_type, _ValueComp, _Alloc> &__that) noexcept {
+        this->template _M_filter<false>(__that);
+    }
+
     template <typename... _Ms>
     std::pair<iterator, bool> try_emplace(_Key &&__key, _Ms &&...__mapped) {
         return this->_M_single_emplace(
@@ -276,7 +330,7 @@ public:
 
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
-    iterator insert(_InputIt __first, _InputIt __last) {
+    void insert(_InputIt __first, _InputIt __last) {
         return this->_M_single_insert(__first, __last);
     }
 
@@ -284,7 +338,7 @@ public:
 
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
-    iterator assign(_InputIt __first, _InputIt __last) {
+    void assign(_InputIt __first, _InputIt __last) {
         this->clear();
         return this->_M_single_insert(__first, __last);
     }
@@ -311,6 +365,16 @@ public:
         return this->_M_contains(__key) ? 1 : 0;
     }
 
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _ValueComp, _Kv, value_type)>
+    size_t rank(_Kv &&__key) const noexcept {
+        return this->template _M_rank<false>(__key);
+    }
+
+    size_t rank(const _Key &__key) const noexcept {
+        return this->template _M_rank<false>(__key);
+    }
+
     template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
                                 _ValueComp, _Kv, value_type)>
     bool contains(_Kv &&__key) const noexcept {
@@ -321,6 +385,8 @@ public:
         return this->_M_contains(__key);
     }
 
+    using _RbTreeImpl<value_type, _ValueComp, _Alloc>::extract;
+
     template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
                                 _ValueComp, _Kv, value_type)>
     node_type extract(_Kv &&__key) {
@@ -356,30 +422,33 @@ public:
 
     multimap() = default;
 
+    explicit multimap(const _Alloc &__alloc, _Compare __comp = _Compare())
+        : _RbTreeImpl<value_type, _ValueComp, _Alloc>(__alloc, __comp) {}
+
     explicit multimap(_Compare __comp)
         : _RbTreeImpl<value_type, _ValueComp, _Alloc>(__comp) {}
 
     multimap(std::initializer_list<value_type> __ilist) {
-        _M_multi_insert(__ilist.begin(), __ilist.end());
+        this->_M_multi_insert(__ilist.begin(), __ilist.end());
     }
 
     explicit multimap(std::initializer_list<value_type> __ilist,
                       _Compare __comp)
         : _RbTreeImpl<value_type, _ValueComp, _Alloc>(__comp) {
-        _M_multi_insert(__ilist.begin(), __ilist.end());
+        this->_M_multi_insert(__ilist.begin(), __ilist.end());
     }
 
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
     explicit multimap(_InputIt __first, _InputIt __last) {
-        _M_multi_insert(__first, __last);
+        this->_M_multi_insert(__first, __last);
     }
 
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
     explicit multimap(_InputIt __first, _InputIt __last, _Compare __comp)
         : _RbTreeImpl<value_type, _ValueComp, _Alloc>(__comp) {
-        _M_multi_insert(__first, __last);
+        this->_M_multi_insert(__first, __last);
     }
 
     multimap(multimap &&) = default;
@@ -387,7 +456,7 @@ public:
     multimap &operator=(multimap &&) = default;
 
     multimap(const multimap &__other)
-        : _RbTreeImpl<value_type, _ValueComp, _Alloc>() {
+        : _RbTreeImpl<value_type, _ValueComp, _Alloc>(__other.get_allocator()) {
         this->_M_multi_insert(__other.begin(), __other.end());
     }
 
@@ -449,6 +518,27 @@ public:
         return this->_M_single_emplace(std::forward<_Ts>(__value)...);
     }
 
+    template <typename... _Ts>
+    iterator emplace_hint(const_iterator __hint, _Ts &&...__value) {
+        return this->_M_multi_emplace_hint(__hint, std::forward<_Ts>(__value)...);
+    }
+
+    iterator insert(const_iterator __hint, value_type &&__value) {
+        return this->_M_multi_emplace_hint(__hint, std::move(__value));
+    }
+
+    iterator insert(const_iterator __hint, const value_type &__value) {
+        return this->_M_multi_emplace_hint(__hint, __value);
+    }
+
+    void merge(_RbTreeImpl<value_type, _ValueComp, _Alloc> &__that) {
+        this->template _M_merge<true>(__that);
+    }
+
+    void merge(_RbTreeImpl<value_type, _ValueComp, _Alloc> &&__that) {
+        this->template _M_merge<true>(__that);
+    }
+
     template <typename... _Ts>
     std::pair<iterator, bool> try_emplace(_Key &&__key, _Ts &&...__value) {
         return this->_M_single_emplace(
@@ -465,17 +555,17 @@ public:
 
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
-    iterator insert(_InputIt __first, _InputIt __last) {
-        return this->_M_single_insert(__first, __last);
+    void insert(_InputIt __first, _InputIt __last) {
+        return this->_M_multi_insert(__first, __last);
     }
 
     using _RbTreeImpl<value_type, _ValueComp, _Alloc>::assign;
 
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
-    iterator assign(_InputIt __first, _InputIt __last) {
+    void assign(_InputIt __first, _InputIt __last) {
         this->clear();
-        return this->_M_single_insert(__first, __last);
+        return this->_M_multi_insert(__first, __last);
     }
 
     using _RbTreeImpl<value_type, _ValueComp, _Alloc>::erase;
@@ -500,6 +590,16 @@ public:
         return this->_M_multi_count(__value);
     }
 
+    template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                                _ValueComp, _Kv, value_type)>
+    size_t rank(_Kv &&__key) const noexcept {
+        return this->template _M_rank<false>(__key);
+    }
+
+    size_t rank(const _Key &__key) const noexcept {
+        return this->template _M_rank<false>(__key);
+    }
+
     template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
                                 _ValueComp, _Kv, value_type)>
     bool contains(_Kv &&__value) const noexcept {
@@ -510,6 +610,8 @@ public:
         return this->_M_contains(__key);
     }
 
+    using _RbTreeImpl<value_type, _ValueComp, _Alloc>::extract;
+
     template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
                                 _ValueComp, _Kv, value_type)>
     node_type extract(_Kv &&__key) {
@@ -523,4 +625,269 @@ public:
     }
 };
 
+// 与 map 接口相同，但以 B 树存储：查找时每层只访问一个连续的节点
+// 插入和删除会使所有迭代器失效
+template <typename _Key, typename _Mapped, typename _Compare = std::less<_Key>,
+          typename _Alloc = std::allocator<std::pair<const _Key, _Mapped>>>
+struct btree_map
+    : _BTreeImpl<std::pair<const _Key, _Mapped>,
+                 _RbTreeValueCompare<_Compare, std::pair<const _Key, _Mapped>>,
+                 _Alloc> {
+    using key_type = _Key;
+    using mapped_type = _Mapped;
+    using value_type = std::pair<const _Key, _Mapped>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+private:
+    using _ValueComp = _RbTreeValueCompare<_Compare, value_type>;
+    using _Base = _BTreeImpl<value_type, _ValueComp, _Alloc>;
+
+public:
+    using typename _Base::const_iterator;
+    using typename _Base::iterator;
+
+    btree_map() = default;
+
+    explicit btree_map(_Compare __comp) : _Base(_ValueComp(__comp)) {}
+
+    btree_map(std::initializer_list<value_type> __ilist) {
+        this->_M_single_insert(__ilist.begin(), __ilist.end());
+    }
+
+    explicit btree_map(std::initializer_list<value_type> __ilist,
+                       _Compare __comp)
+        : _Base(_ValueComp(__comp)) {
+        this->_M_single_insert(__ilist.begin(), __ilist.end());
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    explicit btree_map(_InputIt __first, _InputIt __last) {
+        this->_M_single_insert(__first, __last);
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    explicit btree_map(_InputIt __first, _InputIt __last, _Compare __comp)
+        : _Base(_ValueComp(__comp)) {
+        this->_M_single_insert(__first, __last);
+    }
+
+    btree_map(btree_map &&) = default;
+
+    btree_map &operator=(btree_map &&) = default;
+
+    btree_map(const btree_map &) = default;
+
+    btree_map &operator=(const btree_map &) = default;
+
+    btree_map &operator=(std::initializer_list<value_type> __ilist) {
+        this->assign(__ilist);
+        return *this;
+    }
+
+    void assign(std::initializer_list<value_type> __ilist) {
+        this->clear();
+        this->_M_single_insert(__ilist.begin(), __ilist.end());
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    void assign(_InputIt __first, _InputIt __last) {
+        this->clear();
+        this->_M_single_insert(__first, __last);
+    }
+
+    _ValueComp value_comp() const noexcept {
+        return this->_M_comp;
+    }
+
+    template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                                _ValueComp, _Kv, value_type)>
+    iterator find(_Kv &&__key) noexcept {
+        return this->_M_find_it(__key);
+    }
+
+    template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                                _ValueComp, _Kv, value_type)>
+    const_iterator find(_Kv &&__key) const noexcept {
+        return this->_M_find_it(__key);
+    }
+
+    iterator find(const _Key &__key) noexcept {
+        return this->_M_find_it(__key);
+    }
+
+    const_iterator find(const _Key &__key) const noexcept {
+        return this->_M_find_it(__key);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&__value) {
+        return this->_M_single_emplace(std::move(__value));
+    }
+
+    std::pair<iterator, bool> insert(const value_type &__value) {
+        return this->_M_single_emplace(__value);
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    void insert(_InputIt __first, _InputIt __last) {
+        this->_M_single_insert(__first, __last);
+    }
+
+    template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                                _ValueComp, _Kv, value_type)>
+    const _Mapped &at(const _Kv &__key) const {
+        const_iterator __it = this->_M_find_it(__key);
+        if (__it == this->end()) [[unlikely]] {
+            throw std::out_of_range("btree_map::at");
+        }
+        return __it->second;
+    }
+
+    template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                                _ValueComp, _Kv, value_type)>
+    _Mapped &at(const _Kv &__key) {
+        iterator __it = this->_M_find_it(__key);
+        if (__it == this->end()) [[unlikely]] {
+            throw std::out_of_range("btree_map::at");
+        }
+        return __it->second;
+    }
+
+    const _Mapped &at(const _Key &__key) const {
+        const_iterator __it = this->_M_find_it(__key);
+        if (__it == this->end()) [[unlikely]] {
+            throw std::out_of_range("btree_map::at");
+        }
+        return __it->second;
+    }
+
+    _Mapped &at(const _Key &__key) {
+        iterator __it = this->_M_find_it(__key);
+        if (__it == this->end()) [[unlikely]] {
+            throw std::out_of_range("btree_map::at");
+        }
+        return __it->second;
+    }
+
+    template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                                _ValueComp, _Kv, value_type)>
+    _Mapped &operator[](const _Kv &__key) {
+        iterator __it = this->_M_find_it(__key);
+        if (__it == this->end()) {
+            __it = this->_M_single_emplace(std::piecewise_construct,
+                                           std::forward_as_tuple(__key),
+                                           std::forward_as_tuple())
+                       .first;
+        }
+        return __it->second;
+    }
+
+    _Mapped &operator[](const _Key &__key) {
+        iterator __it = this->_M_find_it(__key);
+        if (__it == this->end()) {
+            __it = this->_M_single_emplace(std::piecewise_construct,
+                                           std::forward_as_tuple(__key),
+                                           std::forward_as_tuple())
+                       .first;
+        }
+        return __it->second;
+    }
+
+    template <typename _Mp,
+              typename = std::enable_if_t<std::is_convertible_v<_Mp, _Mapped>>>
+    std::pair<iterator, bool> insert_or_assign(const _Key &__key,
+                                               _Mp &&__mapped) {
+        iterator __it = this->_M_find_it(__key);
+        if (__it != this->end()) {
+            __it->second = std::forward<_Mp>(__mapped);
+            return {__it, false};
+        }
+        return this->_M_single_emplace(
+            std::piecewise_construct, std::forward_as_tuple(__key),
+            std::forward_as_tuple(std::forward<_Mp>(__mapped)));
+    }
+
+    template <typename... _Ts>
+    std::pair<iterator, bool> emplace(_Ts &&...__value) {
+        return this->_M_single_emplace(std::forward<_Ts>(__value)...);
+    }
+
+    template <typename... _Ms>
+    std::pair<iterator, bool> try_emplace(const _Key &__key,
+                                          _Ms &&...__mapped) {
+        iterator __it = this->_M_find_it(__key);
+        if (__it != this->end()) {
+            return {__it, false};
+        }
+        return this->_M_single_emplace(
+            std::piecewise_construct, std::forward_as_tuple(__key),
+            std::forward_as_tuple(std::forward<_Ms>(__mapped)...));
+    }
+
+    using _Base::lower_bound;
+    using _Base::upper_bound;
+    using _Base::equal_range;
+
+    iterator lower_bound(const _Key &__key) noexcept {
+        return this->_M_lower_bound_it(__key);
+    }
+
+    const_iterator lower_bound(const _Key &__key) const noexcept {
+        return this->_M_lower_bound_it(__key);
+    }
+
+    iterator upper_bound(const _Key &__key) noexcept {
+        return this->_M_upper_bound_it(__key);
+    }
+
+    const_iterator upper_bound(const _Key &__key) const noexcept {
+        return this->_M_upper_bound_it(__key);
+    }
+
+    std::pair<iterator, iterator> equal_range(const _Key &__key) noexcept {
+        return {this->lower_bound(__key), this->upper_bound(__key)};
+    }
+
+    std::pair<const_iterator, const_iterator>
+    equal_range(const _Key &__key) const noexcept {
+        return {this->lower_bound(__key), this->upper_bound(__key)};
+    }
+
+    using _Base::erase;
+
+    template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                                _ValueComp, _Kv, value_type)>
+    size_t erase(_Kv &&__key) {
+        return this->_M_single_erase(__key);
+    }
+
+    size_t erase(const _Key &__key) {
+        return this->_M_single_erase(__key);
+    }
+
+    template <class _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                             _ValueComp, _Kv, value_type)>
+    size_t count(_Kv &&__key) const noexcept {
+        return this->_M_contains(__key) ? 1 : 0;
+    }
+
+    size_t count(const _Key &__key) const noexcept {
+        return this->_M_contains(__key) ? 1 : 0;
+    }
+
+    template <typename _Kv, _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(
+                                _ValueComp, _Kv, value_type)>
+    bool contains(_Kv &&__key) const noexcept {
+        return this->_M_contains(__key);
+    }
+
+    bool contains(const _Key &__key) const noexcept {
+        return this->_M_contains(__key);
+    }
+};
+
 } // namespace Marcus
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <common/_common.hpp>
+#include <containers/core/_BTree.hpp>
 #include <containers/core/_RbTree.hpp>
+#include <initializer_list>
 
 namespace Marcus {
 
@@ -17,14 +19,40 @@ struct set : _RbTreeImpl<const _Tp, _Compare, _Alloc> {
 
     set() = default;
 
+    explicit set(const _Alloc &__alloc, _Compare __comp = _Compare())
+        : _RbTreeImpl<const _Tp, _Compare, _Alloc>(__alloc, __comp) {}
+
     explicit set(_Compare __comp)
         : _RbTreeImpl<const _Tp, _Compare, _Alloc>(__comp) {}
 
+    set(std::initializer_list<_Tp> __ilist) {
+        this->_M_single_insert(__ilist.begin(), __ilist.end());
+    }
+
+    explicit set(std::initializer_list<_Tp> __ilist, _Compare __comp)
+        : _RbTreeImpl<const _Tp, _Compare, _Alloc>(__comp) {
+        this->_M_single_insert(__ilist.begin(), __ilist.end());
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    explicit set(_InputIt __first, _InputIt __last) {
+        this->_M_single_insert(__first, __last);
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    explicit set(_InputIt __first, _InputIt __last, _Compare __comp)
+        : _RbTreeImpl<const _Tp, _Compare, _Alloc>(__comp) {
+        this->_M_single_insert(__first, __last);
+    }
+
     set(set &&) = default;
 
     set &operator=(set &&) = default;
 
-    set(const set &__other) : _RbTreeImpl<const _Tp, _Compare, _Alloc>() {
+    set(const set &__other)
+        : _RbTreeImpl<const _Tp, _Compare, _Alloc>(__other.get_allocator()) {
         this->_M_single_insert(__other.begin(), __other.end());
     }
 
@@ -59,6 +87,8 @@ struct set : _RbTreeImpl<const _Tp, _Compare, _Alloc> {
         return this->_M_find(__value);
     }
 
+    using _RbTreeImpl<const _Tp, _Compare, _Alloc>::insert;
+
     std::pair<iterator, bool> insert(_Tp &&__value) {
         return this->_M_single_emplace(std::move(__value));
     }
@@ -72,6 +102,49 @@ struct set : _RbTreeImpl<const _Tp, _Compare, _Alloc> {
         return this->_M_single_emplace(std::forward<_Ts>(__value)...);
     }
 
+    template <typename... _Ts>
+    iterator emplace_hint(const_iterator __hint, _Ts &&...__value) {
+        return this->_M_single_emplace_hint(__hint, std::forward<_Ts>(__value)...);
+    }
+
+    iterator insert(const_iterator __hint, _Tp &&__value) {
+        return this->_M_single_emplace_hint(__hint, std::move(__value));
+    }
+
+    iterator insert(const_iterator __hint, const _Tp &__value) {
+        return this->_M_single_emplace_hint(__hint, __value);
+    }
+
+    // 集合运算直接拆分、拼接两棵树：__that 的节点原样接过来，不重新分配
+    // （分配器不相等时才逐个搬移元素），与本集合重复的元素留在 __that 中；
+    // 交集和差集不改变 __that
+    void merge(_RbTreeImpl<const _Tp, _Compare, _Alloc> &__that) {
+        this->template _M_merge<false>(__that);
+    }
+
+    void merge(_RbTreeImpl<const _Tp, _Compare, _Alloc> &&__that) {
+        this->template _M_merge<false>(__that);
+    }
+
+    void set_union(const set &__that) {
+        set __copy(__that);
+        this->template _M_merge<false>(__copy);
+    }
+
+    void set_union(set &&__that) {
+        this->template _M_merge<false>(__that);
+    }
+
+    void set_intersection(
+        const _RbTreeImpl<const _Tp, _Compare, _Alloc> &__that) noexcept {
+        this->template _M_filter<true>(__that);
+    }
+
+    void set_difference(
+        const _RbTreeImpl<const _Tp, _Compare, _Alloc> &__that) noexcept {
+        this->template _M_filter<false>(__that);
+    }
+
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
     void insert(_InputIt __first, _InputIt __last) {
@@ -119,6 +192,8 @@ struct set : _RbTreeImpl<const _Tp, _Compare, _Alloc> {
         return this->_M_contains(__value);
     }
 
+    using _RbTreeImpl<const _Tp, _Compare, _Alloc>::extract;
+
     template <typename _Tv,
               _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
     node_type extract(_Tv &&__value) {
@@ -144,15 +219,40 @@ struct multiset : _RbTreeImpl<const _Tp, _Compare, _Alloc> {
 
     multiset() = default;
 
+    explicit multiset(const _Alloc &__alloc, _Compare __comp = _Compare())
+        : _RbTreeImpl<const _Tp, _Compare, _Alloc>(__alloc, __comp) {}
+
     explicit multiset(_Compare __comp)
         : _RbTreeImpl<const _Tp, _Compare, _Alloc>(__comp) {}
 
+    multiset(std::initializer_list<_Tp> __ilist) {
+        this->_M_multi_insert(__ilist.begin(), __ilist.end());
+    }
+
+    explicit multiset(std::initializer_list<_Tp> __ilist, _Compare __comp)
+        : _RbTreeImpl<const _Tp, _Compare, _Alloc>(__comp) {
+        this->_M_multi_insert(__ilist.begin(), __ilist.end());
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    explicit multiset(_InputIt __first, _InputIt __last) {
+        this->_M_multi_insert(__first, __last);
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    explicit multiset(_InputIt __first, _InputIt __last, _Compare __comp)
+        : _RbTreeImpl<const _Tp, _Compare, _Alloc>(__comp) {
+        this->_M_multi_insert(__first, __last);
+    }
+
     multiset(multiset &&) = default;
 
     multiset &operator=(multiset &&) = default;
 
     multiset(const multiset &__other)
-        : _RbTreeImpl<const _Tp, _Compare, _Alloc>() {
+        : _RbTreeImpl<const _Tp, _Compare, _Alloc>(__other.get_allocator()) {
         this->_M_multi_insert(__other.begin(), __other.end());
     }
 
@@ -200,6 +300,27 @@ struct multiset : _RbTreeImpl<const _Tp, _Compare, _Alloc> {
         return this->_M_multi_emplace(std::forward<_Ts>(__value)...);
     }
 
+    template <typename... _Ts>
+    iterator emplace_hint(const_iterator __hint, _Ts &&...__value) {
+        return this->_M_multi_emplace_hint(__hint, std::forward<_Ts>(__value)...);
+    }
+
+    iterator insert(const_iterator __hint, _Tp &&__value) {
+        return this->_M_multi_emplace_hint(__hint, std::move(__value));
+    }
+
+    iterator insert(const_iterator __hint, const _Tp &__value) {
+        return this->_M_multi_emplace_hint(__hint, __value);
+    }
+
+    void merge(_RbTreeImpl<const _Tp, _Compare, _Alloc> &__that) {
+        this->template _M_merge<true>(__that);
+    }
+
+    void merge(_RbTreeImpl<const _Tp, _Compare, _Alloc> &&__that) {
+        this->template _M_merge<true>(__that);
+    }
+
     template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
                                                      _InputIt)>
     void insert(_InputIt __first, _InputIt __last) {
@@ -247,6 +368,8 @@ struct multiset : _RbTreeImpl<const _Tp, _Compare, _Alloc> {
         return this->_M_contains(__value);
     }
 
+    using _RbTreeImpl<const _Tp, _Compare, _Alloc>::extract;
+
     template <class _Tv,
               _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
     node_type extract(_Tv &&__value) {
@@ -260,4 +383,141 @@ struct multiset : _RbTreeImpl<const _Tp, _Compare, _Alloc> {
     }
 };
 
+// 与 set 接口相同，但以 B 树存储；插入和删除会使所有迭代器失效
+template <typename _Tp, typename _Compare = std::less<_Tp>,
+          typename _Alloc = std::allocator<_Tp>>
+struct btree_set : _BTreeImpl<_Tp, _Compare, _Alloc> {
+private:
+    using _Base = _BTreeImpl<_Tp, _Compare, _Alloc>;
+
+public:
+    using typename _Base::const_iterator;
+    using iterator = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reverse_iterator = const_reverse_iterator;
+    using value_type = _Tp;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    btree_set() = default;
+
+    explicit btree_set(_Compare __comp) : _Base(__comp) {}
+
+    btree_set(std::initializer_list<_Tp> __ilist) {
+        this->_M_single_insert(__ilist.begin(), __ilist.end());
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    explicit btree_set(_InputIt __first, _InputIt __last) {
+        this->_M_single_insert(__first, __last);
+    }
+
+    btree_set(btree_set &&) = default;
+
+    btree_set &operator=(btree_set &&) = default;
+
+    btree_set(const btree_set &) = default;
+
+    btree_set &operator=(const btree_set &) = default;
+
+    btree_set &operator=(std::initializer_list<_Tp> __ilist) {
+        this->assign(__ilist);
+        return *this;
+    }
+
+    void assign(std::initializer_list<_Tp> __ilist) {
+        this->clear();
+        this->_M_single_insert(__ilist.begin(), __ilist.end());
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    void assign(_InputIt __first, _InputIt __last) {
+        this->clear();
+        this->_M_single_insert(__first, __last);
+    }
+
+    _Compare value_comp() const noexcept {
+        return this->_M_comp;
+    }
+
+    const_iterator begin() const noexcept {
+        return _Base::begin();
+    }
+
+    const_iterator end() const noexcept {
+        return _Base::end();
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return _Base::rbegin();
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return _Base::rend();
+    }
+
+    template <typename _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    const_iterator find(_Tv &&__value) const noexcept {
+        return this->_M_find_it(__value);
+    }
+
+    const_iterator find(const _Tp &__value) const noexcept {
+        return this->_M_find_it(__value);
+    }
+
+    std::pair<iterator, bool> insert(_Tp &&__value) {
+        return this->_M_single_emplace(std::move(__value));
+    }
+
+    std::pair<iterator, bool> insert(const _Tp &__value) {
+        return this->_M_single_emplace(__value);
+    }
+
+    template <typename... _Ts>
+    std::pair<iterator, bool> emplace(_Ts &&...__value) {
+        return this->_M_single_emplace(std::forward<_Ts>(__value)...);
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    void insert(_InputIt __first, _InputIt __last) {
+        this->_M_single_insert(__first, __last);
+    }
+
+    using _Base::erase;
+
+    template <typename _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    std::size_t erase(_Tv &&__value) {
+        return this->_M_single_erase(__value);
+    }
+
+    std::size_t erase(const _Tp &__value) {
+        return this->_M_single_erase(__value);
+    }
+
+    template <typename _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    std::size_t count(_Tv &&__value) const noexcept {
+        return this->_M_contains(__value) ? 1 : 0;
+    }
+
+    std::size_t count(const _Tp &__value) const noexcept {
+        return this->_M_contains(__value) ? 1 : 0;
+    }
+
+    template <typename _Tv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_COMPARE(_Compare, _Tv, _Tp)>
+    bool contains(_Tv &&__value) const noexcept {
+        return this->_M_contains(__value);
+    }
+
+    bool contains(const _Tp &__value) const noexcept {
+        return this->_M_contains(__value);
+    }
+};
+
 } // namespace Marcus
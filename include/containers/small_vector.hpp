@@ -0,0 +1,200 @@
+#pragma once
+
+#include <common/_common.hpp>
+#include <containers/core/_VectorBase.hpp>
+#include <initializer_list>
+#include <memory>
+
+namespace Marcus {
+
+// 接口与 vector 相同，但前 _Np 个元素存放在对象内部，不分配内存；
+// 超过 _Np 个时整体搬到堆上，之后与 vector 一样按增长策略扩容
+template <typename _Tp, std::size_t _Np, typename _Alloc = std::allocator<_Tp>,
+          typename _Growth = geometric_growth<>>
+struct small_vector : _VectorBase<small_vector<_Tp, _Np, _Alloc, _Growth>, _Tp,
+                                  _Alloc, _Growth> {
+    static_assert(_Np > 0, "small_vector: inline capacity must be positive");
+
+private:
+    using _Base = _VectorBase<small_vector<_Tp, _Np, _Alloc, _Growth>, _Tp,
+                              _Alloc, _Growth>;
+    friend _Base;
+
+    using _Base::_alloc;
+    using _Base::_cap;
+    using _Base::_data;
+    using _Base::_reallocate;
+    using _Base::_relocate;
+    using _Base::_size;
+
+    alignas(_Tp) unsigned char _inline[_Np * sizeof(_Tp)];
+
+    static constexpr const char *_S_at_what = "small_vector::at";
+
+    _Tp *_inline_data() noexcept {
+        return reinterpret_cast<_Tp *>(_inline);
+    }
+
+    bool _is_inline() const noexcept {
+        return _data == reinterpret_cast<const _Tp *>(_inline);
+    }
+
+    // 内部缓冲区不归分配器管，只释放堆上的
+    void _replace_buffer(_Tp *_new_data, std::size_t _new_cap) noexcept {
+        if (!_is_inline()) {
+            _alloc.deallocate(_data, _cap);
+        }
+        _data = _new_data;
+        _cap = _new_cap;
+    }
+
+    // 接管 _other 的元素：堆上的直接拿走指针，内部的逐个搬过来。
+    // 调用前本对象必须为空且使用内部缓冲区
+    void _take(small_vector &_other) noexcept(
+        std::is_nothrow_move_constructible_v<_Tp>) {
+        if (_other._is_inline()) {
+            _relocate(_data, _other._data, _other._size);
+        } else {
+            _data = _other._data;
+            _cap = _other._cap;
+            _other._data = _other._inline_data();
+            _other._cap = _Np;
+        }
+        _size = _other._size;
+        _other._size = 0;
+    }
+
+    void _destroy_and_release() noexcept {
+        std::destroy(_data, _data + _size);
+        _size = 0;
+        _replace_buffer(_inline_data(), _Np);
+    }
+
+public:
+    using _Base::assign;
+    using _Base::resize;
+
+    small_vector() noexcept {
+        _data = _inline_data();
+        _cap = _Np;
+    }
+
+    explicit small_vector(const _Alloc &alloc) noexcept : _Base(alloc) {
+        _data = _inline_data();
+        _cap = _Np;
+    }
+
+    small_vector(std::initializer_list<_Tp> _list,
+                 const _Alloc &alloc = _Alloc())
+        : small_vector(_list.begin(), _list.end(), alloc) {}
+
+    explicit small_vector(std::size_t _n, const _Alloc &alloc = _Alloc())
+        : _Base(alloc) {
+        _data = _inline_data();
+        _cap = _Np;
+        resize(_n);
+    }
+
+    small_vector(std::size_t _n, const _Tp &val,
+                 const _Alloc &alloc = _Alloc())
+        : _Base(alloc) {
+        _data = _inline_data();
+        _cap = _Np;
+        resize(_n, val);
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                    _InputIt)>
+    small_vector(_InputIt _first, _InputIt _last,
+                 const _Alloc &alloc = _Alloc())
+        : _Base(alloc) {
+        _data = _inline_data();
+        _cap = _Np;
+        assign(_first, _last);
+    }
+
+    small_vector(const small_vector &_other) : _Base(_other._alloc) {
+        _data = _inline_data();
+        _cap = _Np;
+        assign(_other.begin(), _other.end());
+    }
+
+    small_vector(small_vector &&_other) noexcept(
+        std::is_nothrow_move_constructible_v<_Tp>)
+        : _Base(std::move(_other._alloc)) {
+        _data = _inline_data();
+        _cap = _Np;
+        _take(_other);
+    }
+
+    small_vector &operator=(const small_vector &_other) {
+        if (&_other == this) [[unlikely]] {
+            return *this;
+        }
+        assign(_other.begin(), _other.end());
+        return *this;
+    }
+
+    small_vector &operator=(small_vector &&_other) noexcept(
+        std::is_nothrow_move_constructible_v<_Tp>) {
+        if (&_other == this) [[unlikely]] {
+            return *this;
+        }
+        _destroy_and_release();
+        _alloc = _other._alloc;
+        _take(_other);
+        return *this;
+    }
+
+    small_vector &operator=(std::initializer_list<_Tp> _list) {
+        assign(_list.begin(), _list.end());
+        return *this;
+    }
+
+    void swap(small_vector &_other) noexcept(
+        std::is_nothrow_move_constructible_v<_Tp>) {
+        if (!_is_inline() && !_other._is_inline()) {
+            // 堆缓冲区要由申请它的分配器释放，分配器跟着一起交换
+            std::swap(_data, _other._data);
+            std::swap(_size, _other._size);
+            std::swap(_cap, _other._cap);
+            std::swap(_alloc, _other._alloc);
+            return;
+        }
+        small_vector _tmp(std::move(_other));
+        _other = std::move(*this);
+        *this = std::move(_tmp);
+    }
+
+    // 放得进内部缓冲区时搬回去，否则换成恰好够用的堆缓冲区
+    void shrink_to_fit() {
+        if (_is_inline() || _cap == _size) {
+            return;
+        }
+        if (_size <= _Np) {
+            _Tp *_old_data = _data;
+            std::size_t _old_cap = _cap;
+            _relocate(_inline_data(), _old_data, _size);
+            _alloc.deallocate(_old_data, _old_cap);
+            _data = _inline_data();
+            _cap = _Np;
+        } else {
+            _reallocate(_size);
+        }
+    }
+
+    static constexpr std::size_t inline_capacity() noexcept {
+        return _Np;
+    }
+
+    ~small_vector() noexcept {
+        std::destroy(_data, _data + _size);
+        if (!_is_inline()) {
+            _alloc.deallocate(_data, _cap);
+        }
+    }
+
+    _LIBPENGCXX_DEFINE_COMPARISON(small_vector);
+};
+
+} // namespace Marcus
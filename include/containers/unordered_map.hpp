@@ -0,0 +1,198 @@
+#pragma once
+
+#include <common/_common.hpp>
+#include <containers/core/_HashTable.hpp>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+
+namespace Marcus {
+
+template <typename _Key, typename _Mapped, typename _Hash = std::hash<_Key>,
+          typename _KeyEqual = std::equal_to<_Key>,
+          typename _Alloc = std::allocator<std::pair<const _Key, _Mapped>>>
+struct unordered_map
+    : _HashTableImpl<_Key, std::pair<const _Key, _Mapped>, _HashKeyFirst,
+                     _Hash, _KeyEqual, _Alloc> {
+    using key_type = _Key;
+    using mapped_type = _Mapped;
+    using value_type = std::pair<const _Key, _Mapped>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+private:
+    using _Base = _HashTableImpl<_Key, value_type, _HashKeyFirst, _Hash,
+                                 _KeyEqual, _Alloc>;
+
+public:
+    using typename _Base::const_iterator;
+    using typename _Base::iterator;
+
+    unordered_map() = default;
+
+    explicit unordered_map(size_type __bucket_count,
+                           const _Hash &__hash = _Hash(),
+                           const _KeyEqual &__eq = _KeyEqual(),
+                           const _Alloc &__alloc = _Alloc())
+        : _Base(__bucket_count, __hash, __eq, __alloc) {}
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    unordered_map(_InputIt __first, _InputIt __last,
+                  size_type __bucket_count = 0, const _Hash &__hash = _Hash(),
+                  const _KeyEqual &__eq = _KeyEqual(),
+                  const _Alloc &__alloc = _Alloc())
+        : _Base(__bucket_count, __hash, __eq, __alloc) {
+        this->_M_insert_range(__first, __last);
+    }
+
+    unordered_map(std::initializer_list<value_type> __ilist,
+                  size_type __bucket_count = 0, const _Hash &__hash = _Hash(),
+                  const _KeyEqual &__eq = _KeyEqual(),
+                  const _Alloc &__alloc = _Alloc())
+        : _Base(__bucket_count, __hash, __eq, __alloc) {
+        this->_M_insert_range(__ilist.begin(), __ilist.end());
+    }
+
+    unordered_map(unordered_map &&) = default;
+
+    unordered_map &operator=(unordered_map &&) = default;
+
+    unordered_map(const unordered_map &) = default;
+
+    unordered_map &operator=(const unordered_map &) = default;
+
+    unordered_map &operator=(std::initializer_list<value_type> __ilist) {
+        this->clear();
+        this->_M_insert_range(__ilist.begin(), __ilist.end());
+        return *this;
+    }
+
+    template <typename _Kv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_HASH(_Hash, _KeyEqual)>
+    const _Mapped &at(const _Kv &__key) const {
+        const_iterator __it = this->find(__key);
+        if (__it == this->end()) [[unlikely]] {
+            throw std::out_of_range("unordered_map::at");
+        }
+        return __it->second;
+    }
+
+    template <typename _Kv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_HASH(_Hash, _KeyEqual)>
+    _Mapped &at(const _Kv &__key) {
+        iterator __it = this->find(__key);
+        if (__it == this->end()) [[unlikely]] {
+            throw std::out_of_range("unordered_map::at");
+        }
+        return __it->second;
+    }
+
+    const _Mapped &at(const _Key &__key) const {
+        const_iterator __it = this->find(__key);
+        if (__it == this->end()) [[unlikely]] {
+            throw std::out_of_range("unordered_map::at");
+        }
+        return __it->second;
+    }
+
+    _Mapped &at(const _Key &__key) {
+        iterator __it = this->find(__key);
+        if (__it == this->end()) [[unlikely]] {
+            throw std::out_of_range("unordered_map::at");
+        }
+        return __it->second;
+    }
+
+    _Mapped &operator[](const _Key &__key) {
+        return this
+            ->_M_try_emplace(__key, std::piecewise_construct,
+                             std::forward_as_tuple(__key),
+                             std::forward_as_tuple())
+            .first->second;
+    }
+
+    _Mapped &operator[](_Key &&__key) {
+        return this
+            ->_M_try_emplace(__key, std::piecewise_construct,
+                             std::forward_as_tuple(std::move(__key)),
+                             std::forward_as_tuple())
+            .first->second;
+    }
+
+    std::pair<iterator, bool> insert(value_type &&__value) {
+        return this->_M_try_emplace(__value.first, std::move(__value));
+    }
+
+    std::pair<iterator, bool> insert(const value_type &__value) {
+        return this->_M_try_emplace(__value.first, __value);
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    void insert(_InputIt __first, _InputIt __last) {
+        this->_M_insert_range(__first, __last);
+    }
+
+    void insert(std::initializer_list<value_type> __ilist) {
+        this->_M_insert_range(__ilist.begin(), __ilist.end());
+    }
+
+    template <typename _Mp,
+              typename = std::enable_if_t<std::is_convertible_v<_Mp, _Mapped>>>
+    std::pair<iterator, bool> insert_or_assign(const _Key &__key,
+                                               _Mp &&__mapped) {
+        std::pair<iterator, bool> __result = this->_M_try_emplace(
+            __key, std::piecewise_construct, std::forward_as_tuple(__key),
+            std::forward_as_tuple(std::forward<_Mp>(__mapped)));
+        if (!__result.second) {
+            __result.first->second = std::forward<_Mp>(__mapped);
+        }
+        return __result;
+    }
+
+    template <typename _Mp,
+              typename = std::enable_if_t<std::is_convertible_v<_Mp, _Mapped>>>
+    std::pair<iterator, bool> insert_or_assign(_Key &&__key, _Mp &&__mapped) {
+        std::pair<iterator, bool> __result = this->_M_try_emplace(
+            __key, std::piecewise_construct,
+            std::forward_as_tuple(std::move(__key)),
+            std::forward_as_tuple(std::forward<_Mp>(__mapped)));
+        if (!__result.second) {
+            __result.first->second = std::forward<_Mp>(__mapped);
+        }
+        return __result;
+    }
+
+    template <typename... Vs>
+    std::pair<iterator, bool> emplace(Vs &&...__value) {
+        return this->_M_emplace(std::forward<Vs>(__value)...);
+    }
+
+    template <typename... _Ms>
+    std::pair<iterator, bool> try_emplace(_Key &&__key, _Ms &&...__mapped) {
+        return this->_M_try_emplace(
+            __key, std::piecewise_construct,
+            std::forward_as_tuple(std::move(__key)),
+            std::forward_as_tuple(std::forward<_Ms>(__mapped)...));
+    }
+
+    template <typename... _Ms>
+    std::pair<iterator, bool> try_emplace(const _Key &__key,
+                                          _Ms &&...__mapped) {
+        return this->_M_try_emplace(
+            __key, std::piecewise_construct, std::forward_as_tuple(__key),
+            std::forward_as_tuple(std::forward<_Ms>(__mapped)...));
+    }
+
+    bool operator==(const unordered_map &__that) const {
+        return this->_M_equal(__that, std::equal_to<value_type>());
+    }
+
+    bool operator!=(const unordered_map &__that) const {
+        return !(*this == __that);
+    }
+};
+
+} // namespace Marcus
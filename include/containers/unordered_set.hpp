@@ -0,0 +1,120 @@
+#pragma once
+
+#include <common/_common.hpp>
+#include <containers/core/_HashTable.hpp>
+#include <functional>
+#include <initializer_list>
+
+namespace Marcus {
+
+template <typename _Tp, typename _Hash = std::hash<_Tp>,
+          typename _KeyEqual = std::equal_to<_Tp>,
+          typename _Alloc = std::allocator<_Tp>>
+struct unordered_set
+    : _HashTableImpl<_Tp, _Tp, _HashKeyIdentity, _Hash, _KeyEqual, _Alloc> {
+    using value_type = _Tp;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+private:
+    using _Base =
+        _HashTableImpl<_Tp, _Tp, _HashKeyIdentity, _Hash, _KeyEqual, _Alloc>;
+
+public:
+    using typename _Base::const_iterator;
+    using iterator = const_iterator;
+
+    unordered_set() = default;
+
+    explicit unordered_set(size_type __bucket_count,
+                           const _Hash &__hash = _Hash(),
+                           const _KeyEqual &__eq = _KeyEqual(),
+                           const _Alloc &__alloc = _Alloc())
+        : _Base(__bucket_count, __hash, __eq, __alloc) {}
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    unordered_set(_InputIt __first, _InputIt __last,
+                  size_type __bucket_count = 0, const _Hash &__hash = _Hash(),
+                  const _KeyEqual &__eq = _KeyEqual(),
+                  const _Alloc &__alloc = _Alloc())
+        : _Base(__bucket_count, __hash, __eq, __alloc) {
+        this->_M_insert_range(__first, __last);
+    }
+
+    unordered_set(std::initializer_list<_Tp> __ilist,
+                  size_type __bucket_count = 0, const _Hash &__hash = _Hash(),
+                  const _KeyEqual &__eq = _KeyEqual(),
+                  const _Alloc &__alloc = _Alloc())
+        : _Base(__bucket_count, __hash, __eq, __alloc) {
+        this->_M_insert_range(__ilist.begin(), __ilist.end());
+    }
+
+    unordered_set(unordered_set &&) = default;
+
+    unordered_set &operator=(unordered_set &&) = default;
+
+    unordered_set(const unordered_set &) = default;
+
+    unordered_set &operator=(const unordered_set &) = default;
+
+    unordered_set &operator=(std::initializer_list<_Tp> __ilist) {
+        this->clear();
+        this->_M_insert_range(__ilist.begin(), __ilist.end());
+        return *this;
+    }
+
+    // 元素不可修改，begin/end 都返回 const_iterator
+    const_iterator begin() const noexcept {
+        return _Base::begin();
+    }
+
+    const_iterator end() const noexcept {
+        return _Base::end();
+    }
+
+    const_iterator find(const _Tp &__key) const {
+        return _Base::find(__key);
+    }
+
+    template <typename _Kv,
+              _LIBPENGCXX_REQUIRES_TRANSPARENT_HASH(_Hash, _KeyEqual)>
+    const_iterator find(const _Kv &__key) const {
+        return _Base::find(__key);
+    }
+
+    std::pair<iterator, bool> insert(_Tp &&__value) {
+        return this->_M_try_emplace(__value, std::move(__value));
+    }
+
+    std::pair<iterator, bool> insert(const _Tp &__value) {
+        return this->_M_try_emplace(__value, __value);
+    }
+
+    template <_LIBPENGCXX_REQUIRES_ITERATOR_CATEGORY(std::input_iterator,
+                                                     _InputIt)>
+    void insert(_InputIt __first, _InputIt __last) {
+        this->_M_insert_range(__first, __last);
+    }
+
+    void insert(std::initializer_list<_Tp> __ilist) {
+        this->_M_insert_range(__ilist.begin(), __ilist.end());
+    }
+
+    template <typename... Vs>
+    std::pair<iterator, bool> emplace(Vs &&...__value) {
+        return this->_M_emplace(std::forward<Vs>(__value)...);
+    }
+
+    bool operator==(const unordered_set &__that) const {
+        return this->_M_equal(__that, [](const _Tp &, const _Tp &) {
+            return true;
+        });
+    }
+
+    bool operator!=(const unordered_set &__that) const {
+        return !(*this == __that);
+    }
+};
+
+} // namespace Marcus
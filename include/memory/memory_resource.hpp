@@ -0,0 +1,343 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+
+namespace Marcus {
+
+// 内存资源的抽象接口。容器通过 polymorphic_allocator 使用它，
+// 同一种容器类型可以在运行时换用不同的资源
+class memory_resource {
+public:
+    static constexpr std::size_t _S_max_align = alignof(std::max_align_t);
+
+    memory_resource() = default;
+    memory_resource(const memory_resource &) = default;
+    memory_resource &operator=(const memory_resource &) = default;
+    virtual ~memory_resource() = default;
+
+    [[nodiscard]] void *allocate(std::size_t __bytes,
+                                 std::size_t __align = _S_max_align) {
+        return this->do_allocate(__bytes, __align);
+    }
+
+    void deallocate(void *__p, std::size_t __bytes,
+                    std::size_t __align = _S_max_align) {
+        this->do_deallocate(__p, __bytes, __align);
+    }
+
+    bool is_equal(const memory_resource &__that) const noexcept {
+        return this == &__that || this->do_is_equal(__that);
+    }
+
+    // 为 true 时 deallocate 什么也不做，内存只在资源释放时整体归还
+    bool deallocate_is_noop() const noexcept {
+        return _M_noop_deallocate;
+    }
+
+protected:
+    explicit memory_resource(bool __noop_deallocate) noexcept
+        : _M_noop_deallocate(__noop_deallocate) {}
+
+private:
+    bool _M_noop_deallocate = false;
+
+    virtual void *do_allocate(std::size_t __bytes, std::size_t __align) = 0;
+    virtual void do_deallocate(void *__p, std::size_t __bytes,
+                               std::size_t __align) = 0;
+
+    virtual bool do_is_equal(const memory_resource &) const noexcept {
+        return false;
+    }
+};
+
+struct _NewDeleteResource final : memory_resource {
+private:
+    void *do_allocate(std::size_t __bytes, std::size_t __align) override {
+        if (__align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(__bytes, std::align_val_t(__align));
+        }
+        return ::operator new(__bytes);
+    }
+
+    void do_deallocate(void *__p, std::size_t __bytes,
+                       std::size_t __align) override {
+        if (__align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(__p, __bytes, std::align_val_t(__align));
+        } else {
+            ::operator delete(__p, __bytes);
+        }
+    }
+};
+
+// 直接使用全局 operator new/delete 的资源，也是 polymorphic_allocator 的默认值
+inline memory_resource *new_delete_resource() noexcept {
+    static _NewDeleteResource __resource;
+    return &__resource;
+}
+
+// 单调增长的内存区：分配只是移动游标，deallocate 什么也不做，
+// 所有内存在 release() 或析构时一次归还上游。适合一次请求里的临时容器，
+// 请求结束时连同容器一起丢弃，容器也不必逐个归还节点
+class monotonic_arena : public memory_resource {
+    struct _Chunk {
+        _Chunk *_M_next;
+        std::size_t _M_bytes;
+    };
+
+    // 大块开头存放 _Chunk，之后的可用内存仍按 max_align_t 对齐
+    static constexpr std::size_t _S_header =
+        (sizeof(_Chunk) + _S_max_align - 1) / _S_max_align * _S_max_align;
+    static constexpr std::size_t _S_min_chunk = 1024;
+
+    memory_resource *_M_upstream;
+    _Chunk *_M_chunks = nullptr;
+    char *_M_cursor = nullptr;
+    char *_M_end = nullptr;
+    void *_M_buffer = nullptr; // 用户提供的初始缓冲区，用完才向上游申请
+    std::size_t _M_buffer_size = 0;
+    std::size_t _M_initial_size;
+    std::size_t _M_next_size;
+
+    // 新大块至少能放下这次请求，之后的大块按两倍增长
+    void _M_grow(std::size_t __bytes, std::size_t __align) {
+        const std::size_t __size =
+            std::max(_M_next_size, _S_header + __bytes + __align);
+        void *__mem = _M_upstream->allocate(__size, _S_max_align);
+        _M_chunks = ::new (__mem) _Chunk{_M_chunks, __size};
+        _M_cursor = static_cast<char *>(__mem) + _S_header;
+        _M_end = static_cast<char *>(__mem) + __size;
+        _M_next_size = __size * 2;
+    }
+
+    void *do_allocate(std::size_t __bytes, std::size_t __align) override {
+        if (__bytes == 0) {
+            __bytes = 1;
+        }
+        void *__p = _M_cursor;
+        std::size_t __space = _M_end - _M_cursor;
+        if (!std::align(__align, __bytes, __p, __space)) [[unlikely]] {
+            this->_M_grow(__bytes, __align);
+            __p = _M_cursor;
+            __space = _M_end - _M_cursor;
+            std::align(__align, __bytes, __p, __space);
+        }
+        _M_cursor = static_cast<char *>(__p) + __bytes;
+        return __p;
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+public:
+    explicit monotonic_arena(
+        memory_resource *__upstream = new_delete_resource()) noexcept
+        : monotonic_arena(_S_min_chunk, __upstream) {}
+
+    // __initial_size: 第一次向上游申请的大块字节数
+    explicit monotonic_arena(
+        std::size_t __initial_size,
+        memory_resource *__upstream = new_delete_resource()) noexcept
+        : memory_resource(true),
+          _M_upstream(__upstream),
+          _M_initial_size(std::max(__initial_size, _S_min_chunk)),
+          _M_next_size(_M_initial_size) {}
+
+    // 先从 __buffer 分配（例如栈上的数组），用完后再向上游申请
+    monotonic_arena(
+        void *__buffer, std::size_t __size,
+        memory_resource *__upstream = new_delete_resource()) noexcept
+        : monotonic_arena(std::max(__size, _S_min_chunk), __upstream) {
+        _M_buffer = __buffer;
+        _M_buffer_size = __size;
+        _M_cursor = static_cast<char *>(__buffer);
+        _M_end = _M_cursor + __size;
+    }
+
+    monotonic_arena(const monotonic_arena &) = delete;
+    monotonic_arena &operator=(const monotonic_arena &) = delete;
+
+    ~monotonic_arena() noexcept override {
+        this->release();
+    }
+
+    // 把所有大块还给上游，之后的分配重新从初始缓冲区开始。
+    // 调用前必须确保不再有容器使用这里分配的内存
+    void release() noexcept {
+        while (_M_chunks != nullptr) {
+            _Chunk *__chunk = _M_chunks;
+            _M_chunks = __chunk->_M_next;
+            _M_upstream->deallocate(__chunk, __chunk->_M_bytes, _S_max_align);
+        }
+        _M_cursor = static_cast<char *>(_M_buffer);
+        _M_end = _M_cursor + _M_buffer_size;
+        _M_next_size = _M_initial_size;
+    }
+
+    memory_resource *upstream_resource() const noexcept {
+        return _M_upstream;
+    }
+};
+
+// 按大小分级的内存池：每一级一条空闲链表，块从上游申请的大块中切分，
+// 释放后挂回链表等待复用，适合反复创建、销毁节点的 list、map 等容器。
+// 超过最大一级或对齐要求超过 max_align_t 的请求直接转给上游。
+// 所有大块在 release() 或析构时归还上游。不是线程安全的
+class pool_resource : public memory_resource {
+    struct _Chunk {
+        _Chunk *_M_next;
+        std::size_t _M_bytes;
+    };
+
+    struct _FreeSlot {
+        _FreeSlot *_M_next;
+    };
+
+    struct _Pool {
+        _FreeSlot *_M_free;
+        std::size_t _M_next_slots; // 下一个大块的块数，按两倍增长
+    };
+
+    static constexpr std::size_t _S_header =
+        (sizeof(_Chunk) + _S_max_align - 1) / _S_max_align * _S_max_align;
+    static constexpr std::size_t _S_min_block = sizeof(void *);
+    static constexpr std::size_t _S_max_block = 512;
+    static constexpr std::size_t _S_num_pools =
+        std::bit_width(_S_max_block / _S_min_block);
+    static constexpr std::size_t _S_min_slots = 16;
+    static constexpr std::size_t _S_max_chunk_bytes = 64 * 1024;
+
+    memory_resource *_M_upstream;
+    _Chunk *_M_chunks = nullptr;
+    _Pool _M_pools[_S_num_pools];
+
+    // 第 __i 级的块大小是 _S_min_block << __i
+    static std::size_t _S_pool_index(std::size_t __bytes) noexcept {
+        __bytes = std::max(__bytes, _S_min_block);
+        return std::bit_width((__bytes - 1) / _S_min_block);
+    }
+
+    void _M_reset_pools() noexcept {
+        for (_Pool &__pool: _M_pools) {
+            __pool = {nullptr, _S_min_slots};
+        }
+    }
+
+    void _M_refill(_Pool &__pool, std::size_t __block) {
+        const std::size_t __slots = __pool._M_next_slots;
+        const std::size_t __size = _S_header + __slots * __block;
+        void *__mem = _M_upstream->allocate(__size, _S_max_align);
+        _M_chunks = ::new (__mem) _Chunk{_M_chunks, __size};
+        char *__first = static_cast<char *>(__mem) + _S_header;
+        for (std::size_t __i = __slots; __i != 0; --__i) {
+            __pool._M_free = ::new (static_cast<void *>(
+                __first + (__i - 1) * __block)) _FreeSlot{__pool._M_free};
+        }
+        __pool._M_next_slots =
+            std::min(__slots * 2, std::max(_S_min_slots,
+                                           _S_max_chunk_bytes / __block));
+    }
+
+    void *do_allocate(std::size_t __bytes, std::size_t __align) override {
+        if (__bytes > _S_max_block || __align > _S_max_align) [[unlikely]] {
+            return _M_upstream->allocate(__bytes, __align);
+        }
+        // 块大小都是 2 的幂，按对齐要求选级就能保证块地址对齐
+        const std::size_t __i = _S_pool_index(std::max(__bytes, __align));
+        _Pool &__pool = _M_pools[__i];
+        if (__pool._M_free == nullptr) [[unlikely]] {
+            this->_M_refill(__pool, _S_min_block << __i);
+        }
+        _FreeSlot *__slot = __pool._M_free;
+        __pool._M_free = __slot->_M_next;
+        return __slot;
+    }
+
+    void do_deallocate(void *__p, std::size_t __bytes,
+                       std::size_t __align) override {
+        if (__bytes > _S_max_block || __align > _S_max_align) [[unlikely]] {
+            _M_upstream->deallocate(__p, __bytes, __align);
+            return;
+        }
+        _Pool &__pool = _M_pools[_S_pool_index(std::max(__bytes, __align))];
+        __pool._M_free = ::new (__p) _FreeSlot{__pool._M_free};
+    }
+
+public:
+    explicit pool_resource(
+        memory_resource *__upstream = new_delete_resource()) noexcept
+        : _M_upstream(__upstream) {
+        this->_M_reset_pools();
+    }
+
+    pool_resource(const pool_resource &) = delete;
+    pool_resource &operator=(const pool_resource &) = delete;
+
+    ~pool_resource() noexcept override {
+        this->release();
+    }
+
+    // 把所有大块还给上游。直接转给上游的大请求不受影响
+    void release() noexcept {
+        while (_M_chunks != nullptr) {
+            _Chunk *__chunk = _M_chunks;
+            _M_chunks = __chunk->_M_next;
+            _M_upstream->deallocate(__chunk, __chunk->_M_bytes, _S_max_align);
+        }
+        this->_M_reset_pools();
+    }
+
+    memory_resource *upstream_resource() const noexcept {
+        return _M_upstream;
+    }
+};
+
+// 把 memory_resource 包装成标准分配器，可以传给任何 Marcus 容器。
+// 复制容器时分配器照原样复制，副本仍然从同一个资源分配
+template <typename _Tp>
+class polymorphic_allocator {
+    memory_resource *_M_resource;
+
+public:
+    using value_type = _Tp;
+
+    polymorphic_allocator() noexcept : _M_resource(new_delete_resource()) {}
+
+    polymorphic_allocator(memory_resource *__resource) noexcept
+        : _M_resource(__resource) {}
+
+    template <typename _Up>
+    polymorphic_allocator(const polymorphic_allocator<_Up> &__that) noexcept
+        : _M_resource(__that.resource()) {}
+
+    [[nodiscard]] _Tp *allocate(std::size_t __n) {
+        if (__n > std::numeric_limits<std::size_t>::max() / sizeof(_Tp))
+            [[unlikely]] {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<_Tp *>(
+            _M_resource->allocate(__n * sizeof(_Tp), alignof(_Tp)));
+    }
+
+    void deallocate(_Tp *__p, std::size_t __n) noexcept {
+        _M_resource->deallocate(__p, __n * sizeof(_Tp), alignof(_Tp));
+    }
+
+    memory_resource *resource() const noexcept {
+        return _M_resource;
+    }
+
+    bool deallocate_is_noop() const noexcept {
+        return _M_resource->deallocate_is_noop();
+    }
+
+    template <typename _Up>
+    bool operator==(const polymorphic_allocator<_Up> &__that) const noexcept {
+        return _M_resource->is_equal(*__that.resource());
+    }
+};
+
+} // namespace Marcus
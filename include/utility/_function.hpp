@@ -1,115 +1,150 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <type_traits>
 #include <typeinfo>
 #include <utility>
+#include <utility/_function_storage.hpp>
 
 namespace Marcus {
 
-template <class _FnSig>
+// _InlineSize: 不超过这么多字节的可调用对象存放在 Function 内部，不分配内存
+template <class _FnSig, std::size_t _InlineSize = 3 * sizeof(void *)>
 struct Function {
     static_assert(!std::is_same_v<_FnSig, _FnSig>,
                   "not a valid function signature");
 };
 
 // type : _Ret(_Args...)
-template <class _Ret, class... _Args>
-struct Function<_Ret(_Args...)> {
+template <class _Ret, class... _Args, std::size_t _InlineSize>
+struct Function<_Ret(_Args...), _InlineSize> {
 private:
-    struct _FuncBase {
-        virtual _Ret _M_call(_Args... __args) = 0;
-        virtual std::unique_ptr<_FuncBase> _M_clone() const = 0;
-        virtual const std::type_info &_M_type() const = 0;
-        virtual ~_FuncBase() = default;
-    };
+    using _Storage = _FuncStorage<_InlineSize>;
+    using _VTable = _FuncVTable<_InlineSize, _Ret, _Args...>;
 
     template <class _Fn>
-    struct _FuncImpl : _FuncBase {
-        _Fn _M_f;
+    static constexpr const _VTable *_S_vtable =
+        &_FuncVTableFor<_Fn, _InlineSize, _Ret, _Args...>::_S_value;
 
-        template <class... _CArgs>
-        explicit _FuncImpl(std::in_place_t, _CArgs &&...__args)
-            : _M_f(std::forward<_CArgs>(__args)...) {}
+    mutable _Storage _M_storage{}; // 整体复制时不读到未初始化的字节
+    const _VTable *_M_vtable = nullptr; // 为空表示没有目标
 
-        _Ret _M_call(_Args... __args) override {
-            return std::invoke(_M_f, std::forward<_Args>(__args)...);
-        }
-
-        std::unique_ptr<_FuncBase> _M_clone() const override {
-            return std::make_unique<_FuncImpl>(std::in_place, _M_f);
+    void _M_reset() noexcept {
+        if (_M_vtable) {
+            _M_vtable->_M_release(_M_storage);
+            _M_vtable = nullptr;
         }
+    }
 
-        const std::type_info &_M_type() const override {
-            return typeid(_Fn);
+    void _M_take(Function &__that) noexcept {
+        if (__that._M_vtable) {
+            __that._M_vtable->_M_relocate(_M_storage, __that._M_storage);
+            _M_vtable = __that._M_vtable;
+            __that._M_vtable = nullptr;
         }
-    };
-
-    std::unique_ptr<_FuncBase> _M_base;
+    }
 
 public:
-    Function() = default;
+    Function() noexcept = default;
 
     Function(std::nullptr_t) noexcept : Function() {}
 
     template <class _Fn,
               class = std::enable_if_t<
-                  std::is_invocable_r_v<_Ret, std::decay_t<_Fn>, _Args...> &&
-                  std::is_copy_constructible_v<_Fn> &&
-                  !std::is_same_v<std::decay_t<_Fn>, Function<_Ret(_Args...)>>>>
-    Function(_Fn &&__f) // Without explicit, lambda expressions are allowed to
-                        // implicitly convert to Function.
-        : _M_base(std::make_unique<_FuncImpl<std::decay_t<_Fn>>>(
-              std::in_place, std::forward<_Fn>(__f))) {}
-
-    Function(Function &&) = default;
-    Function &operator=(Function &&) = default;
-
-    Function(const Function &other)
-        : _M_base(other._M_base ? other._M_base->_M_clone() : nullptr) {}
-
-    Function &operator=(const Function &other) {
-        if (other._M_base) {
-            _M_base = other._M_base->_M_clone();
-        } else {
-            _M_base = nullptr;
+                  std::is_invocable_r_v<_Ret, std::decay_t<_Fn> &, _Args...> &&
+                  std::is_copy_constructible_v<std::decay_t<_Fn>> &&
+                  !std::is_same_v<std::decay_t<_Fn>, Function>>>
+    Function(_Fn &&__f) { // Without explicit, lambda expressions are allowed to
+                          // implicitly convert to Function.
+        using _Dp = std::decay_t<_Fn>;
+        // 函数引用衰变成的指针不可能为空，只检查本来就是指针的实参
+        using _Arg = std::remove_cvref_t<_Fn>;
+        if constexpr (std::is_pointer_v<_Arg> ||
+                      std::is_member_pointer_v<_Arg>) {
+            if (__f == nullptr) {
+                return;
+            }
+        }
+        _FuncManager<_Dp, _InlineSize>::_S_create(_M_storage,
+                                                  std::forward<_Fn>(__f));
+        _M_vtable = _S_vtable<_Dp>;
+    }
+
+    Function(Function &&__that) noexcept {
+        this->_M_take(__that);
+    }
+
+    Function &operator=(Function &&__that) noexcept {
+        if (this != &__that) {
+            this->_M_reset();
+            this->_M_take(__that);
         }
+        return *this;
+    }
+
+    Function(const Function &__that) {
+        if (__that._M_vtable) {
+            if (__that._M_vtable->_M_trivial) {
+                _M_storage = __that._M_storage;
+            } else {
+                __that._M_vtable->_M_copy(_M_storage, __that._M_storage);
+            }
+            _M_vtable = __that._M_vtable;
+        }
+    }
+
+    Function &operator=(const Function &__that) {
+        if (this != &__that) {
+            Function(__that).swap(*this);
+        }
+        return *this;
+    }
+
+    Function &operator=(std::nullptr_t) noexcept {
+        this->_M_reset();
+        return *this;
+    }
+
+    ~Function() noexcept {
+        this->_M_reset();
     }
 
     explicit operator bool() const noexcept {
-        return _M_base != nullptr;
+        return _M_vtable != nullptr;
     }
 
     bool operator==(std::nullptr_t) const noexcept {
-        return _M_base == nullptr;
+        return _M_vtable == nullptr;
     }
 
     bool operator!=(std::nullptr_t) const noexcept {
-        return _M_base != nullptr;
+        return _M_vtable != nullptr;
     }
 
     _Ret operator()(_Args... __args) const {
-        if (!_M_base) [[unlikely]] {
+        if (!_M_vtable) [[unlikely]] {
             throw std::bad_function_call();
         }
-        return _M_base->_M_call(std::forward<_Args>(__args)...);
+        return _M_vtable->_M_call(_M_storage, std::forward<_Args>(__args)...);
     }
 
     const std::type_info &target_type() const noexcept {
-        return _M_base ? _M_base->_M_type() : typeid(void);
+        return _M_vtable ? _M_vtable->_M_type() : typeid(void);
     }
 
     template <class _Fn>
     _Fn *target() const noexcept {
-        return _M_base && typeid(_Fn) == _M_base->_M_type()
-                   ? std::addressof(
-                         static_cast<_FuncImpl<_Fn> *>(_M_base.get())->_M_f)
+        return _M_vtable && typeid(_Fn) == _M_vtable->_M_type()
+                   ? _FuncManager<_Fn, _InlineSize>::_S_get(_M_storage)
                    : nullptr;
     }
 
-    void swap(Function &__that) const noexcept {
-        _M_base.swap(__that._M_base);
+    void swap(Function &__that) noexcept {
+        Function __tmp(std::move(__that));
+        __that = std::move(*this);
+        *this = std::move(__tmp);
     }
 };
 
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace Marcus {
+
+template <class _FnSig>
+struct function_ref {
+    static_assert(!std::is_same_v<_FnSig, _FnSig>,
+                  "not a valid function signature");
+};
+
+// 不拥有目标的可调用对象视图：只存目标地址和一个调用桩，两个指针大小，
+// 可以平凡复制。目标必须比 function_ref 活得久，适合同步回调的参数
+template <class _Ret, class... _Args>
+struct function_ref<_Ret(_Args...)> {
+private:
+    union _Target {
+        void *_M_obj;
+        void (*_M_fn)();
+    };
+
+    _Target _M_target;
+    _Ret (*_M_call)(_Target, _Args &&...);
+
+    template <class _Tp>
+    static _Ret _S_call_object(_Target __t, _Args &&...__args) {
+        _Tp &__f = *static_cast<_Tp *>(__t._M_obj);
+        if constexpr (std::is_void_v<_Ret>) {
+            std::invoke(__f, std::forward<_Args>(__args)...);
+        } else {
+            return std::invoke(__f, std::forward<_Args>(__args)...);
+        }
+    }
+
+    template <class _Fp>
+    static _Ret _S_call_function(_Target __t, _Args &&...__args) {
+        _Fp *__f = reinterpret_cast<_Fp *>(__t._M_fn);
+        if constexpr (std::is_void_v<_Ret>) {
+            std::invoke(__f, std::forward<_Args>(__args)...);
+        } else {
+            return std::invoke(__f, std::forward<_Args>(__args)...);
+        }
+    }
+
+public:
+    // 函数指针直接保存，不需要它所在的变量活着
+    template <class _Fp, class = std::enable_if_t<
+                             std::is_function_v<_Fp> &&
+                             std::is_invocable_r_v<_Ret, _Fp *, _Args...>>>
+    function_ref(_Fp *__f) noexcept {
+        _M_target._M_fn = reinterpret_cast<void (*)()>(__f);
+        _M_call = &_S_call_function<_Fp>;
+    }
+
+    template <class _Fn, class _Tp = std::remove_reference_t<_Fn>,
+              class = std::enable_if_t<
+                  !std::is_same_v<std::remove_cv_t<_Tp>, function_ref> &&
+                  !std::is_pointer_v<std::remove_cv_t<_Tp>> &&
+                  !std::is_function_v<_Tp> &&
+                  std::is_invocable_r_v<_Ret, _Tp &, _Args...>>>
+    function_ref(_Fn &&__f) noexcept {
+        _M_target._M_obj = const_cast<void *>(
+            static_cast<const volatile void *>(std::addressof(__f)));
+        _M_call = &_S_call_object<_Tp>;
+    }
+
+    function_ref(const function_ref &) noexcept = default;
+
+    function_ref &operator=(const function_ref &) noexcept = default;
+
+    _Ret operator()(_Args... __args) const {
+        return _M_call(_M_target, std::forward<_Args>(__args)...);
+    }
+};
+
+} // namespace Marcus
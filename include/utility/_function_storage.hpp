@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace Marcus {
+
+// Function、MoveOnlyFunction 和 any 共用的存储：不超过 _Size 字节、
+// 对齐不超过指针、移动不抛异常的对象直接构造在缓冲区里，否则放在堆上，
+// 缓冲区只存指针
+template <std::size_t _Size>
+union _FuncStorage {
+    void *_M_ptr;
+    alignas(void *) unsigned char
+        _M_buf[_Size < sizeof(void *) ? sizeof(void *) : _Size];
+};
+
+// 按存放位置对 _Fn 的各项操作，都是普通函数，可以取地址放进函数表
+template <class _Fn, std::size_t _Size>
+struct _FuncManager {
+    using _Storage = _FuncStorage<_Size>;
+
+    static constexpr bool _S_local =
+        sizeof(_Fn) <= sizeof(_Storage) && alignof(_Fn) <= alignof(_Storage) &&
+        std::is_nothrow_move_constructible_v<_Fn>;
+
+    // 缓冲区里的对象可以按字节搬动、不需要析构
+    static constexpr bool _S_trivial =
+        _S_local && std::is_trivially_copyable_v<_Fn>;
+
+    static _Fn *_S_get(const _Storage &__s) noexcept {
+        if constexpr (_S_local) {
+            return std::launder(reinterpret_cast<_Fn *>(
+                const_cast<unsigned char *>(__s._M_buf)));
+        } else {
+            return static_cast<_Fn *>(__s._M_ptr);
+        }
+    }
+
+    template <class... _CArgs>
+    static void _S_create(_Storage &__s, _CArgs &&...__args) {
+        if constexpr (_S_local) {
+            ::new (static_cast<void *>(__s._M_buf))
+                _Fn(std::forward<_CArgs>(__args)...);
+        } else {
+            __s._M_ptr = new _Fn(std::forward<_CArgs>(__args)...);
+        }
+    }
+
+    static void _S_destroy(_Storage &__s) noexcept {
+        if constexpr (_S_local) {
+            _S_get(__s)->~_Fn();
+        } else {
+            delete _S_get(__s);
+        }
+    }
+
+    // 把 __src 中的对象转移到 __dst，之后 __src 不再持有对象
+    static void _S_move(_Storage &__dst, _Storage &__src) noexcept {
+        if constexpr (_S_local) {
+            ::new (static_cast<void *>(__dst._M_buf))
+                _Fn(std::move(*_S_get(__src)));
+            _S_get(__src)->~_Fn();
+        } else {
+            __dst._M_ptr = __src._M_ptr;
+        }
+    }
+
+    static void _S_copy(_Storage &__dst, const _Storage &__src) {
+        _S_create(__dst, *_S_get(__src));
+    }
+
+    template <class _Ret, class... _Args>
+    static _Ret _S_call(_Storage &__s, _Args &&...__args) {
+        if constexpr (std::is_void_v<_Ret>) {
+            std::invoke(*_S_get(__s), std::forward<_Args>(__args)...);
+        } else {
+            return std::invoke(*_S_get(__s), std::forward<_Args>(__args)...);
+        }
+    }
+
+    static const std::type_info &_S_type() noexcept {
+        return typeid(_Fn);
+    }
+};
+
+// 手写的虚表：每种可调用类型一份常量，对象里只存一个指向它的指针
+template <std::size_t _Size, class _Ret, class... _Args>
+struct _FuncVTable {
+    using _Storage = _FuncStorage<_Size>;
+
+    _Ret (*_M_call)(_Storage &, _Args &&...);
+    void (*_M_copy)(_Storage &, const _Storage &); // 不可复制时为空
+    void (*_M_move)(_Storage &, _Storage &) noexcept;
+    void (*_M_destroy)(_Storage &) noexcept;
+    const std::type_info &(*_M_type)() noexcept;
+    bool _M_trivial;
+
+    // 空对象和平凡对象直接按字节搬动，省掉一次间接调用
+    void _M_relocate(_Storage &__dst, _Storage &__src) const noexcept {
+        if (_M_trivial) {
+            std::memcpy(&__dst, &__src, sizeof(_Storage));
+        } else {
+            _M_move(__dst, __src);
+        }
+    }
+
+    void _M_release(_Storage &__s) const noexcept {
+        if (!_M_trivial) {
+            _M_destroy(__s);
+        }
+    }
+};
+
+template <class _Fn, std::size_t _Size, class _Ret, class... _Args>
+struct _FuncVTableFor {
+    using _Manager = _FuncManager<_Fn, _Size>;
+
+    static constexpr auto _S_copy_ptr() noexcept {
+        using _Copy = void (*)(_FuncStorage<_Size> &,
+                               const _FuncStorage<_Size> &);
+        if constexpr (std::is_copy_constructible_v<_Fn>) {
+            return static_cast<_Copy>(&_Manager::_S_copy);
+        } else {
+            return static_cast<_Copy>(nullptr);
+        }
+    }
+
+    static constexpr _FuncVTable<_Size, _Ret, _Args...> _S_value = {
+        &_Manager::template _S_call<_Ret, _Args...>,
+        _S_copy_ptr(),
+        &_Manager::_S_move,
+        &_Manager::_S_destroy,
+        &_Manager::_S_type,
+        _Manager::_S_trivial,
+    };
+};
+
+} // namespace Marcus
@@ -1,81 +1,109 @@
 #pragma once
 
+#include <cassert>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include <utility/_function_storage.hpp>
 
 namespace Marcus {
 
-template <typename _FnSig>
+// _InlineSize 与 Function 相同：小的可调用对象存放在内部，不分配内存
+template <typename _FnSig, std::size_t _InlineSize = 3 * sizeof(void *)>
 struct MoveOnlyFunction {
     static_assert(!std::is_same_v<_FnSig, _FnSig>,
                   "not a valid function signature");
 };
 
-template <typename _Ret, typename... _Args>
-struct MoveOnlyFunction<_Ret(_Args...)> {
+template <typename _Ret, typename... _Args, std::size_t _InlineSize>
+struct MoveOnlyFunction<_Ret(_Args...), _InlineSize> {
 private:
-    struct _FuncBase {
-        virtual _Ret _M_call(_Args... __args) = 0;
-        virtual ~_FuncBase() = default;
-    };
+    using _Storage = _FuncStorage<_InlineSize>;
+    using _VTable = _FuncVTable<_InlineSize, _Ret, _Args...>;
 
     template <typename _Fn>
-    struct _FuncImpl : _FuncBase {
-        _Fn _M_f;
+    static constexpr const _VTable *_S_vtable =
+        &_FuncVTableFor<_Fn, _InlineSize, _Ret, _Args...>::_S_value;
 
-        template <typename... _CArgs>
-        explicit _FuncImpl(std::in_place_t, _CArgs &&...__args)
-            : _M_f(std::forward<_CArgs>(__args)...) {}
+    mutable _Storage _M_storage;
+    const _VTable *_M_vtable = nullptr; // 为空表示没有目标
 
-        _Ret _M_call(_Args... __args) override {
-            return std::invoke(_M_f, std::forward<_Args>(__args)...);
+    void _M_reset() noexcept {
+        if (_M_vtable) {
+            _M_vtable->_M_release(_M_storage);
+            _M_vtable = nullptr;
         }
-    };
+    }
 
-    std::unique_ptr<_FuncBase> _M_base;
+    void _M_take(MoveOnlyFunction &__that) noexcept {
+        if (__that._M_vtable) {
+            __that._M_vtable->_M_relocate(_M_storage, __that._M_storage);
+            _M_vtable = __that._M_vtable;
+            __that._M_vtable = nullptr;
+        }
+    }
 
 public:
-    MoveOnlyFunction() = default; // _M_base 初始化为 nullptr
+    MoveOnlyFunction() noexcept = default;
 
     MoveOnlyFunction(std::nullptr_t) noexcept : MoveOnlyFunction() {}
 
     template <typename _Fn, typename = std::enable_if_t<
                                 std::is_invocable_r_v<_Ret, _Fn &, _Args...>>>
-    MoveOnlyFunction(_Fn __f)
-        : _M_base(std::make_unique<_FuncImpl<_Fn>>(std::in_place,
-                                                   std::move(__f))) {}
+    MoveOnlyFunction(_Fn __f) {
+        _FuncManager<_Fn, _InlineSize>::_S_create(_M_storage, std::move(__f));
+        _M_vtable = _S_vtable<_Fn>;
+    }
 
     template <typename _Fn, typename... _CArgs>
-    explicit MoveOnlyFunction(std::in_place_type_t<_Fn>, _CArgs &&...__args)
-        : _M_base(std::make_unique<_FuncImpl<_Fn>>(
-              std::in_place, std::forward<_CArgs>(__args)...)) {}
+    explicit MoveOnlyFunction(std::in_place_type_t<_Fn>, _CArgs &&...__args) {
+        _FuncManager<_Fn, _InlineSize>::_S_create(
+            _M_storage, std::forward<_CArgs>(__args)...);
+        _M_vtable = _S_vtable<_Fn>;
+    }
+
+    MoveOnlyFunction(MoveOnlyFunction &&__that) noexcept {
+        this->_M_take(__that);
+    }
+
+    MoveOnlyFunction &operator=(MoveOnlyFunction &&__that) noexcept {
+        if (this != &__that) {
+            this->_M_reset();
+            this->_M_take(__that);
+        }
+        return *this;
+    }
 
-    MoveOnlyFunction(MoveOnlyFunction &&) = default;
-    MoveOnlyFunction &operator=(MoveOnlyFunction &&) = default;
     MoveOnlyFunction(const MoveOnlyFunction &) = delete;
     MoveOnlyFunction &operator=(const MoveOnlyFunction &) = delete;
 
+    ~MoveOnlyFunction() noexcept {
+        this->_M_reset();
+    }
+
     explicit operator bool() const noexcept {
-        return _M_base != nullptr;
+        return _M_vtable != nullptr;
     }
 
     bool operator==(std::nullptr_t) const noexcept {
-        return _M_base == nullptr;
+        return _M_vtable == nullptr;
     }
 
     bool operator!=(std::nullptr_t) const noexcept {
-        return _M_base != nullptr;
+        return _M_vtable != nullptr;
     }
 
     _Ret operator()(_Args... __args) const {
-        assert(_M_base);
-        return _M_base->_M_call(std::forward<_Args>(__args)...);
+        assert(_M_vtable);
+        return _M_vtable->_M_call(_M_storage, std::forward<_Args>(__args)...);
     }
 
-    void swap(MoveOnlyFunction &__that) const noexcept {
-        _M_base.swap(__that._M_base);
+    void swap(MoveOnlyFunction &__that) noexcept {
+        MoveOnlyFunction __tmp(std::move(__that));
+        __that = std::move(*this);
+        *this = std::move(__tmp);
     }
 };
 } // namespace Marcus
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstring>
 #include <exception>
 #include <initializer_list>
 #include <type_traits>
 #include <typeinfo>
 #include <utility>
+#include <utility/_function_storage.hpp>
 
 namespace Marcus {
 
@@ -25,91 +27,146 @@ struct InPlaceType {
 template <typename T>
 constexpr InPlaceType<T> in_place_type{};
 
-struct AnyConcept {
-    virtual ~AnyConcept() = default;
-    virtual AnyConcept *clone() const = 0;
-    virtual AnyConcept *move_clone() = 0;
-    virtual const std::type_info &type() const noexcept = 0;
-    virtual void *get_ptr() noexcept = 0;
-    virtual const void *get_ptr() const noexcept = 0;
+// any 的函数表：每种存放类型一份常量，取代虚函数，对象本身不必放在堆上
+struct _AnyVTable {
+    using _Storage = _FuncStorage<2 * sizeof(void *)>;
+
+    void (*_M_copy)(_Storage &, const _Storage &);
+    void (*_M_move)(_Storage &, _Storage &) noexcept;
+    void (*_M_destroy)(_Storage &) noexcept;
+    void *(*_M_get)(const _Storage &) noexcept;
+    const std::type_info &(*_M_type)() noexcept;
+    bool _M_trivial;
+
+    void _M_relocate(_Storage &__dst, _Storage &__src) const noexcept {
+        if (_M_trivial) {
+            std::memcpy(&__dst, &__src, sizeof(_Storage));
+        } else {
+            _M_move(__dst, __src);
+        }
+    }
+
+    void _M_release(_Storage &__s) const noexcept {
+        if (!_M_trivial) {
+            _M_destroy(__s);
+        }
+    }
 };
 
 template <typename T>
-struct AnyModel : AnyConcept {
-    T _value;
+struct _AnyVTableFor {
+    using _Storage = _AnyVTable::_Storage;
+    using _Manager = _FuncManager<T, sizeof(_Storage)>;
 
-    template <typename... Args>
-    AnyModel(Args &&...args) : _value(std::forward<Args>(args)...) {}
-
-    AnyConcept *clone() const override {
-        return new AnyModel<T>(
-            _value); // Create a new AnyModel with a copy of _value
+    static void *_S_get(const _Storage &__s) noexcept {
+        return const_cast<void *>(
+            static_cast<const volatile void *>(_Manager::_S_get(__s)));
     }
 
-    AnyConcept *move_clone() override {
-        return new AnyModel<T>(
-            std::move(_value)); // Create a new AnyModel with a moved _value
-    }
+    static constexpr _AnyVTable _S_value = {
+        &_Manager::_S_copy, &_Manager::_S_move, &_Manager::_S_destroy,
+        &_S_get,            &_Manager::_S_type, _Manager::_S_trivial,
+    };
+};
 
-    const std::type_info &type() const noexcept override {
-        return typeid(T); // Return type_info of T
-    }
+// 不超过两个指针大小、移动不抛异常的值直接存放在 any 内部，不分配内存
+class any {
+private:
+    using _Storage = _AnyVTable::_Storage;
 
-    void *get_ptr() noexcept override {
-        return &_value; // Return pointer to the stored value
+    _Storage _M_storage;
+    const _AnyVTable *_M_vtable = nullptr; // 为空表示没有值
+
+    template <typename T>
+    static constexpr const _AnyVTable *_S_vtable = &_AnyVTableFor<T>::_S_value;
+
+    template <typename T, typename... Args>
+    void _M_create(Args &&...args) {
+        _FuncManager<T, sizeof(_Storage)>::_S_create(
+            _M_storage, std::forward<Args>(args)...);
+        _M_vtable = _S_vtable<T>;
     }
 
-    const void *get_ptr() const noexcept override {
-        return &_value; // Return const pointer to the stored value
+    void _M_take(any &other) noexcept {
+        if (other._M_vtable) {
+            other._M_vtable->_M_relocate(_M_storage, other._M_storage);
+            _M_vtable = other._M_vtable;
+            other._M_vtable = nullptr;
+        }
     }
-};
 
-class any {
-private:
-    AnyConcept *_storage;
+    // 同一个函数表说明类型相同，可以直接取值，不必比较 type_info
+    template <typename T>
+    T *_M_get_if() const noexcept {
+        using U = std::remove_cv_t<T>;
+        if (_M_vtable == _S_vtable<U>) {
+            return _FuncManager<U, sizeof(_Storage)>::_S_get(_M_storage);
+        }
+        if (_M_vtable && _M_vtable->_M_type() == typeid(U)) {
+            return static_cast<U *>(_M_vtable->_M_get(_M_storage));
+        }
+        return nullptr;
+    }
 
     void *_get_value_ptr() noexcept {
-        return _storage ? _storage->get_ptr() : nullptr;
+        return _M_vtable ? _M_vtable->_M_get(_M_storage) : nullptr;
     }
 
     const void *_get_value_ptr() const noexcept {
-        return _storage ? _storage->get_ptr() : nullptr;
+        return _M_vtable ? _M_vtable->_M_get(_M_storage) : nullptr;
     }
 
 public:
-    any() noexcept : _storage(nullptr) {}
+    any() noexcept = default;
 
     template <typename T, typename = std::enable_if_t<
                               !std::is_same_v<std::decay_t<T>, any>>>
-    any(T &&value)
-        : _storage(new AnyModel<std::decay_t<T>>(std::forward<T>(value))) {}
+    any(T &&value) {
+        this->_M_create<std::decay_t<T>>(std::forward<T>(value));
+    }
 
-    any(const any &other)
-        : _storage(other._storage ? other._storage->clone() : nullptr) {}
+    any(const any &other) {
+        if (other._M_vtable) {
+            if (other._M_vtable->_M_trivial) {
+                _M_storage = other._M_storage;
+            } else {
+                other._M_vtable->_M_copy(_M_storage, other._M_storage);
+            }
+            _M_vtable = other._M_vtable;
+        }
+    }
 
-    any(any &&other) noexcept : _storage(other._storage) {
-        other._storage = nullptr;
+    any(any &&other) noexcept {
+        this->_M_take(other);
     }
 
     template <typename T, typename... Args>
-    explicit any(InPlaceType<T>, Args &&...args)
-        : _storage(new AnyModel<T>(std::forward<Args>(args)...)) {}
+    explicit any(InPlaceType<T>, Args &&...args) {
+        this->_M_create<T>(std::forward<Args>(args)...);
+    }
 
     template <typename T, typename U, typename... Args>
-    explicit any(InPlaceType<T>, std::initializer_list<U> ilist, Args &&...args)
-        : _storage(new AnyModel<T>(ilist, std::forward<Args>(args)...)) {}
+    explicit any(InPlaceType<T>, std::initializer_list<U> ilist,
+                 Args &&...args) {
+        this->_M_create<T>(ilist, std::forward<Args>(args)...);
+    }
 
     ~any() noexcept {
-        delete _storage;
+        reset();
     }
 
     any &operator=(const any &other) {
-        any(other).swap(*this);
+        if (this != &other) {
+            any(other).swap(*this);
+        }
         return *this;
     }
 
     any &operator=(any &&other) noexcept {
-        any(std::move(other)).swap(*this);
+        if (this != &other) {
+            reset();
+            this->_M_take(other);
+        }
         return *this;
     }
 
@@ -122,31 +179,34 @@ public:
     template <typename T, typename... Args>
     void emplace(Args &&...args) {
         reset();
-        _storage = new AnyModel<T>(std::forward<Args>(args)...);
+        this->_M_create<T>(std::forward<Args>(args)...);
     }
 
     template <typename T, typename U, typename... Args>
     void emplace(std::initializer_list<U> ilist, Args &&...args) {
         reset();
-        _storage = new AnyModel<T>(ilist, std::forward<Args>(args)...);
+        this->_M_create<T>(ilist, std::forward<Args>(args)...);
     }
 
     void reset() noexcept {
-        delete _storage;
-        _storage = nullptr;
+        if (_M_vtable) {
+            _M_vtable->_M_release(_M_storage);
+            _M_vtable = nullptr;
+        }
     }
 
     void swap(any &other) noexcept {
-        using std::swap;
-        swap(_storage, other._storage);
+        any tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
     }
 
     bool has_value() const noexcept {
-        return _storage != nullptr;
+        return _M_vtable != nullptr;
     }
 
     const std::type_info &type() const noexcept {
-        return _storage ? _storage->type() : typeid(void);
+        return _M_vtable ? _M_vtable->_M_type() : typeid(void);
     }
 
     friend void *any_cast_impl_ref(any *operand, const std::type_info &info);
@@ -185,39 +245,42 @@ inline const void *any_cast_impl_ref(const any *operand,
 
 template <typename T>
 T any_cast(any &operand) {
-    using U = std::remove_reference_t<T>;
-    void *p = any_cast_impl_ref(&operand, typeid(U));
-    return static_cast<T>(*static_cast<U *>(p));
+    using U = std::remove_cvref_t<T>;
+    U *p = operand.template _M_get_if<U>();
+    if (!p) {
+        throw BadAnyCast();
+    }
+    return static_cast<T>(*p);
 }
 
 template <typename T>
 T any_cast(const any &operand) {
-    using U = std::remove_reference_t<T>;
-    const void *p = any_cast_impl_ref(&operand, typeid(U));
-    return static_cast<T>(*static_cast<const U *>(p));
+    using U = std::remove_cvref_t<T>;
+    const U *p = operand.template _M_get_if<U>();
+    if (!p) {
+        throw BadAnyCast();
+    }
+    return static_cast<T>(*p);
 }
 
 template <typename T>
 T any_cast(any &&operand) {
-    using U = std::remove_reference_t<T>;
-    void *p = any_cast_impl_ref(&operand, typeid(U));
-    return static_cast<T>(std::move(*static_cast<U *>(p)));
+    using U = std::remove_cvref_t<T>;
+    U *p = operand.template _M_get_if<U>();
+    if (!p) {
+        throw BadAnyCast();
+    }
+    return static_cast<T>(std::move(*p));
 }
 
 template <typename T>
 const T *any_cast(const any *operand) noexcept {
-    if (!operand || !operand->has_value() || operand->type() != typeid(T)) {
-        return nullptr;
-    }
-    return static_cast<const T *>(operand->_get_value_ptr());
+    return operand ? operand->template _M_get_if<T>() : nullptr;
 }
 
 template <typename T>
 T *any_cast(any *operand) noexcept {
-    if (!operand || !operand->has_value() || operand->type() != typeid(T)) {
-        return nullptr;
-    }
-    return static_cast<T *>(operand->_get_value_ptr());
+    return operand ? operand->template _M_get_if<T>() : nullptr;
 }
 
 template <typename T, typename... Args>
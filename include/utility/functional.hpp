@@ -1,4 +1,5 @@
 #pragma once
 
 #include <utility/_function.hpp>
+#include <utility/_function_ref.hpp>
 #include <utility/_move_only_function.hpp>
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <common/_common.hpp>
 #include <functional>
 #include <type_traits>
+#include <utility>
 
 namespace Marcus {
 
@@ -26,100 +28,137 @@ struct BadVariantAccess : std::exception {
 template <typename, typename>
 struct variant_index;
 
+template <typename>
+struct variant_size;
+
+template <size_t _Ip, typename _Vp>
+constexpr decltype(auto) _variant_get(_Vp &&__v);
+
+// 按下标分派：以 std::integral_constant<size_t, I> 调用 __f。备选类型不多时
+// 生成 switch，编译器可以把 __f 内联进每个分支；太多时退回函数指针表
+template <typename _Ret, size_t _Np, typename _Fn>
+constexpr _Ret _variant_dispatch(size_t __i, _Fn &&__f) {
+    if constexpr (_Np <= 16) {
+        switch (__i) {
+#define _LIBPENGCXX_VARIANT_CASE(_Ip) \
+    case _Ip: \
+        if constexpr (_Ip < _Np) { \
+            return __f(std::integral_constant<size_t, _Ip>()); \
+        } \
+        [[fallthrough]];
+            _LIBPENGCXX_VARIANT_CASE(0)
+            _LIBPENGCXX_VARIANT_CASE(1)
+            _LIBPENGCXX_VARIANT_CASE(2)
+            _LIBPENGCXX_VARIANT_CASE(3)
+            _LIBPENGCXX_VARIANT_CASE(4)
+            _LIBPENGCXX_VARIANT_CASE(5)
+            _LIBPENGCXX_VARIANT_CASE(6)
+            _LIBPENGCXX_VARIANT_CASE(7)
+            _LIBPENGCXX_VARIANT_CASE(8)
+            _LIBPENGCXX_VARIANT_CASE(9)
+            _LIBPENGCXX_VARIANT_CASE(10)
+            _LIBPENGCXX_VARIANT_CASE(11)
+            _LIBPENGCXX_VARIANT_CASE(12)
+            _LIBPENGCXX_VARIANT_CASE(13)
+            _LIBPENGCXX_VARIANT_CASE(14)
+            _LIBPENGCXX_VARIANT_CASE(15)
+#undef _LIBPENGCXX_VARIANT_CASE
+        default:
+            _LIBPENGCXX_UNREACHABLE();
+        }
+    } else {
+        return [&]<size_t... _Is>(std::index_sequence<_Is...>) -> _Ret {
+            static constexpr _Ret (*__table[])(_Fn &&) = {
+                [](_Fn &&__g) -> _Ret {
+                    return __g(std::integral_constant<size_t, _Is>());
+                }...};
+            return __table[__i](std::forward<_Fn>(__f));
+        }(std::make_index_sequence<_Np>());
+    }
+}
+
 template <typename, size_t>
 struct variant_alternative;
 
 template <typename... _Ts>
 struct variant {
 private:
-    size_t _index;
+    // 下标用能装下备选数目的最小无符号整数，放在存储之后以免额外填充
+    using _Index = std::conditional_t<
+        (sizeof...(_Ts) <= 0xff), unsigned char,
+        std::conditional_t<(sizeof...(_Ts) <= 0xffff), unsigned short,
+                           unsigned int>>;
 
     alignas(
         std::max({alignof(_Ts)...})) char _union[std::max({sizeof(_Ts)...})];
-
-    using DestructorFunction = void (*)(char *) noexcept;
-
-    static DestructorFunction *destructors_table() noexcept {
-        static DestructorFunction function_ptrs[sizeof...(_Ts)] = {
-            [](char *_union_p) noexcept {
-                reinterpret_cast<_Ts *>(_union_p)->~_Ts();
-            }...};
-        return function_ptrs;
+    _Index _index;
+
+    // 所有备选类型都平凡时，对应的特殊成员直接默认，variant 也就可以按字节
+    // 复制，vector 等容器会走 memcpy
+    static constexpr bool _S_trivial_destructor =
+        (std::is_trivially_destructible_v<_Ts> && ...);
+    static constexpr bool _S_trivial_copy =
+        (std::is_trivially_copy_constructible_v<_Ts> && ...);
+    static constexpr bool _S_trivial_move =
+        (std::is_trivially_move_constructible_v<_Ts> && ...);
+    static constexpr bool _S_trivial_copy_assign =
+        _S_trivial_destructor && _S_trivial_copy &&
+        (std::is_trivially_copy_assignable_v<_Ts> && ...);
+    static constexpr bool _S_trivial_move_assign =
+        _S_trivial_destructor && _S_trivial_move &&
+        (std::is_trivially_move_assignable_v<_Ts> && ...);
+
+    template <typename _Fn>
+    void _M_apply(_Fn &&__f) const {
+        _variant_dispatch<void, sizeof...(_Ts)>(_index, __f);
     }
 
-    using CopyConstructorFunction = void (*)(char *, const char *) noexcept;
-
-    static CopyConstructorFunction *copy_constructors_table() noexcept {
-        static CopyConstructorFunction function_ptrs[sizeof...(_Ts)] = {
-            [](char *_union_dst, const char *_union_src) noexcept {
-                new (_union_dst)
-                    _Ts(*reinterpret_cast<const _Ts *>(_union_src));
-            }...};
-        return function_ptrs;
+    void _M_destroy() noexcept {
+        this->_M_apply([&](auto __i) {
+            constexpr size_t _Ip = decltype(__i)::value;
+            using _Tp = typename variant_alternative<variant, _Ip>::type;
+            get_if<_Ip>()->~_Tp();
+        });
     }
 
-    using CopyAssignmentFunction = void (*)(char *, const char *) noexcept;
-
-    static CopyAssignmentFunction *copy_assigment_functions_table() noexcept {
-        static CopyAssignmentFunction function_ptrs[sizeof...(_Ts)] = {
-            [](char *_union_dst, const char *_union_src) noexcept {
-                *reinterpret_cast<_Ts *>(_union_dst) =
-                    *reinterpret_cast<const _Ts *>(_union_src);
-            }...};
-        return function_ptrs;
-    }
-
-    using MoveConstructorFunction = void (*)(char *, char *) noexcept;
-
-    static MoveConstructorFunction *move_constructors_table() noexcept {
-        static MoveConstructorFunction function_ptrs[sizeof...(_Ts)] = {
-            [](char *_union_dst, char *_union_src) noexcept {
-                new (_union_dst)
-                    _Ts(std::move(*reinterpret_cast<const _Ts *>(_union_src)));
-            }...};
-        return function_ptrs;
-    }
-
-    using MoveAssignmentFunction = void (*)(char *, char *) noexcept;
-
-    static MoveAssignmentFunction *move_assigment_functions_table() noexcept {
-        static MoveAssignmentFunction function_ptrs[sizeof...(_Ts)] = {
-            [](char *_union_dst, char *_union_src) noexcept {
-                *reinterpret_cast<_Ts *>(_union_dst) =
-                    std::move(*reinterpret_cast<_Ts *>(_union_src));
-            }...};
-        return function_ptrs;
-    }
-
-    template <typename Lambda>
-    using ConstVisitorFunction = std::common_type<typename std::invoke_result<
-        Lambda, const _Ts &>::type...>::type (*)(const char *, Lambda &&);
-
-    template <typename Lambda>
-    static ConstVisitorFunction<Lambda> *const_visitors_table() noexcept {
-        static ConstVisitorFunction<Lambda> function_ptrs[sizeof...(_Ts)] = {
-            [](const char *_union_p, Lambda &&lambda) ->
-            typename std::invoke_result<Lambda, const _Ts &>::type {
-                std::invoke(std::forward<Lambda>(lambda),
-                            *reinterpret_cast<const _Ts *>(_union_p));
-            }...};
-        return function_ptrs;
+    // 从 __other 构造，__other 为右值时移动
+    template <typename _Vp>
+    void _M_construct_from(_Vp &&__other) {
+        __other._M_apply([&](auto __i) {
+            constexpr size_t _Ip = decltype(__i)::value;
+            using _Tp = typename variant_alternative<variant, _Ip>::type;
+            new (_union) _Tp(_variant_get<_Ip>(std::forward<_Vp>(__other)));
+        });
+        _index = __other._index;
     }
 
-    template <typename Lambda>
-    using VisitorFunction = std::common_type<typename std::invoke_result<
-        Lambda, _Ts &>::type...>::type (*)(char *, Lambda &&);
-
-    template <typename Lambda>
-    static VisitorFunction<Lambda> *visitors_table() noexcept {
-        static VisitorFunction<Lambda> function_ptrs[sizeof...(_Ts)] = {
-            [](char *_union_p, Lambda &&lambda)
-                -> std::common_type<
-                    typename std::invoke_result<Lambda, _Ts &>::type...>::type {
-                return std::invoke(std::forward<Lambda>(lambda),
-                                   *reinterpret_cast<_Ts *>(_union_p));
-            }...};
-        return function_ptrs;
+    // 下标相同时直接赋值，否则销毁当前值再重新构造。构造可能抛异常时先
+    // 构造到临时对象里，抛出时当前值原封不动；之后的移动放在 noexcept
+    // 里完成，移动构造会抛异常的类型在这里直接终止，而不是留下已销毁的值
+    template <typename _Vp>
+    void _M_assign_from(_Vp &&__other) {
+        if (_index == __other._index) {
+            __other._M_apply([&](auto __i) {
+                constexpr size_t _Ip = decltype(__i)::value;
+                *get_if<_Ip>() = _variant_get<_Ip>(std::forward<_Vp>(__other));
+            });
+            return;
+        }
+        __other._M_apply([&](auto __i) {
+            constexpr size_t _Ip = decltype(__i)::value;
+            using _Tp = typename variant_alternative<variant, _Ip>::type;
+            using _Src =
+                decltype(_variant_get<_Ip>(std::forward<_Vp>(__other)));
+            if constexpr (std::is_nothrow_constructible_v<_Tp, _Src>) {
+                this->_M_destroy();
+                new (_union) _Tp(_variant_get<_Ip>(std::forward<_Vp>(__other)));
+            } else {
+                _Tp __tmp(_variant_get<_Ip>(std::forward<_Vp>(__other)));
+                this->_M_destroy();
+                [&]() noexcept { new (_union) _Tp(std::move(__tmp)); }();
+            }
+            _index = _Ip;
+        });
     }
 
 public:
@@ -129,25 +168,46 @@ public:
             std::disjunction<std::is_same<_T, _Ts>...>::value, int>::type = 0>
     variant(_T __value) : _index(variant_index<variant, _T>::value) {
         _T *__p = reinterpret_cast<_T *>(_union);
-        new (__p) _T(__value);
+        new (__p) _T(std::move(__value));
     }
 
-    variant(const variant &__other) : _index(__other._index) {
-        copy_constructors_table()[index()](_union, __other._union);
+    variant(const variant &)
+        requires _S_trivial_copy
+    = default;
+
+    variant(const variant &__other) {
+        this->_M_construct_from(__other);
     }
 
+    variant &operator=(const variant &)
+        requires _S_trivial_copy_assign
+    = default;
+
     variant &operator=(const variant &__other) {
-        _index = __other._index;
-        copy_assigment_functions_table()[index()](_union, __other._union);
+        if (this != &__other) {
+            this->_M_assign_from(__other);
+        }
+        return *this;
     }
 
-    variant(variant &&__other) : _index(__other._index) {
-        move_constructors_table()[index()](_union, __other._union);
+    variant(variant &&)
+        requires _S_trivial_move
+    = default;
+
+    variant(variant &&__other) noexcept(
+        (std::is_nothrow_move_constructible_v<_Ts> && ...)) {
+        this->_M_construct_from(std::move(__other));
     }
 
+    variant &operator=(variant &&)
+        requires _S_trivial_move_assign
+    = default;
+
     variant &operator=(variant &&__other) {
-        _index = __other._index;
-        move_assigment_functions_table()[index()](_union, __other._union);
+        if (this != &__other) {
+            this->_M_assign_from(std::move(__other));
+        }
+        return *this;
     }
 
     template <size_t I, typename... Args>
@@ -156,23 +216,35 @@ public:
             std::forward<Args>(args)...);
     }
 
+    ~variant()
+        requires _S_trivial_destructor
+    = default;
+
     ~variant() noexcept {
-        destructors_table()[index()](_union);
+        this->_M_destroy();
     }
 
+    // 返回类型在函数体里推导，重载决议时不会实例化访问者
     template <typename Lambda>
-    std::common_type<typename std::invoke_result<Lambda, _Ts &>::type...>::type
-    visit(Lambda &&lambda) {
-        return visitors_table<Lambda>()[index()](_union,
-                                                 std::forward<Lambda>(lambda));
+    decltype(auto) visit(Lambda &&lambda) {
+        using _Ret = std::common_type<
+            typename std::invoke_result<Lambda, _Ts &>::type...>::type;
+        return _variant_dispatch<_Ret, sizeof...(_Ts)>(
+            index(), [&](auto __i) -> _Ret {
+                return std::invoke(std::forward<Lambda>(lambda),
+                                   *get_if<decltype(__i)::value>());
+            });
     }
 
     template <typename Lambda>
-    std::common_type<
-        typename std::invoke_result<Lambda, const _Ts &>::type...>::type
-    visit(Lambda &&lambda) const {
-        return const_visitors_table<Lambda>()[index()](
-            _union, std::forward<Lambda>(lambda));
+    decltype(auto) visit(Lambda &&lambda) const {
+        using _Ret = std::common_type<
+            typename std::invoke_result<Lambda, const _Ts &>::type...>::type;
+        return _variant_dispatch<_Ret, sizeof...(_Ts)>(
+            index(), [&](auto __i) -> _Ret {
+                return std::invoke(std::forward<Lambda>(lambda),
+                                   *get_if<decltype(__i)::value>());
+            });
     }
 
     constexpr size_t index() const noexcept {
@@ -265,4 +337,54 @@ struct variant_index<variant<T0, Ts...>, T> {
     static constexpr size_t value = variant_index<variant<Ts...>, T>::value + 1;
 };
 
+template <typename... _Ts>
+struct variant_size<variant<_Ts...>>
+    : std::integral_constant<size_t, sizeof...(_Ts)> {};
+
+template <size_t _Ip, typename _Vp>
+constexpr decltype(auto) _variant_get(_Vp &&__v) {
+    auto *__p = __v.template get_if<_Ip>();
+    if constexpr (std::is_lvalue_reference_v<_Vp>) {
+        return (*__p);
+    } else {
+        return std::move(*__p);
+    }
+}
+
+template <typename _Ret, typename _Fn>
+constexpr _Ret _variant_visit(_Fn &&__f) {
+    return std::forward<_Fn>(__f)();
+}
+
+// 逐个按下标分派，把已取出的备选值收进一层层的 lambda 里，
+// 最后一次性传给访问者
+template <typename _Ret, typename _Fn, typename _V0, typename... _Vs>
+constexpr _Ret _variant_visit(_Fn &&__f, _V0 &&__v0, _Vs &&...__vs) {
+    constexpr size_t _Np = variant_size<std::remove_cvref_t<_V0>>::value;
+    return _variant_dispatch<_Ret, _Np>(__v0.index(), [&](auto __i) -> _Ret {
+        return _variant_visit<_Ret>(
+            [&](auto &&...__rest) -> _Ret {
+                return std::forward<_Fn>(__f)(
+                    _variant_get<decltype(__i)::value>(
+                        std::forward<_V0>(__v0)),
+                    std::forward<decltype(__rest)>(__rest)...);
+            },
+            std::forward<_Vs>(__vs)...);
+    });
+}
+
+// 同时访问多个 variant，返回类型取各 variant 第一个备选类型的调用结果，
+// 其他组合的结果须能转换成它
+template <typename _Fn, typename... _Vs>
+constexpr decltype(auto) visit(_Fn &&__f, _Vs &&...__vs) {
+    using _Ret = std::invoke_result_t<
+        _Fn, decltype(_variant_get<0>(std::declval<_Vs>()))...>;
+    return _variant_visit<_Ret>(
+        [&](auto &&...__alts) -> _Ret {
+            return std::invoke(std::forward<_Fn>(__f),
+                               std::forward<decltype(__alts)>(__alts)...);
+        },
+        std::forward<_Vs>(__vs)...);
+}
+
 } // namespace Marcus
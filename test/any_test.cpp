@@ -1,4 +1,7 @@
+#include "_alloc_counter.hpp"
+#include <array>
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -446,6 +449,63 @@ void test_make_any() {
     TEST_PASSED()
 }
 
+// 移动可能抛异常的小对象
+struct ThrowingMove {
+    int value;
+
+    ThrowingMove(int v) : value(v) {}
+
+    ThrowingMove(const ThrowingMove &) = default;
+
+    ThrowingMove(ThrowingMove &&other) noexcept(false) : value(other.value) {}
+};
+
+void test_allocations() {
+    TEST_CASE("Allocations")
+    int before = allocations;
+    // 小的标量和指针存放在内部
+    Marcus::any a = 42;
+    Marcus::any b = 3.5;
+    Marcus::any c = static_cast<const char *>("text");
+    Marcus::any d = std::array<void *, 2>{};
+    Marcus::any copied = a;
+    Marcus::any moved = std::move(b);
+    copied = c;
+    moved = std::move(copied);
+    a.swap(moved);
+    a.emplace<long>(7L);
+    assert(allocations == before);
+    assert(Marcus::any_cast<int>(moved) == 42);
+    assert(Marcus::any_cast<const char *>(c) == std::string("text"));
+    assert(Marcus::any_cast<long>(a) == 7L);
+    assert(!b.has_value() && !copied.has_value());
+
+    // 大对象和移动可能抛异常的对象放在堆上，移动只转移指针
+    using big_array = std::array<long, 8>;
+    Marcus::any big = big_array{1, 2, 3};
+    assert(allocations == before + 1);
+    Marcus::any big_moved = std::move(big);
+    big_moved.swap(d);
+    assert(allocations == before + 1);
+    assert(Marcus::any_cast<big_array &>(d)[2] == 3);
+    Marcus::any big_copy = d;
+    assert(allocations == before + 2);
+    Marcus::any throwing = ThrowingMove(5);
+    assert(allocations == before + 3);
+    Marcus::any throwing_moved = std::move(throwing);
+    assert(allocations == before + 3);
+    assert(Marcus::any_cast<ThrowingMove &>(throwing_moved).value == 5);
+
+    // 内部存放的对象同样正确地复制、移动和析构
+    Marcus::any s = MyStruct(1, "short");
+    Marcus::any s_copy = s;
+    Marcus::any s_moved = std::move(s);
+    assert(!s.has_value());
+    assert(Marcus::any_cast<MyStruct &>(s_moved).name == "short");
+    assert(Marcus::any_cast<MyStruct &>(s_copy).name == "short");
+    TEST_PASSED()
+}
+
 int main() {
     std::cout << "Starting Marcus::any tests..." << std::endl << std::endl;
 
@@ -464,6 +524,7 @@ int main() {
     test_any_cast_ref();
     test_any_cast_ptr();
     test_make_any();
+    test_allocations();
 
     std::cout << "All Marcus::any tests passed successfully!" << std::endl;
 
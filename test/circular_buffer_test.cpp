@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cassert>
+#include <containers/circular_buffer.hpp>
+#include <numeric>
+#include <stdexcept>
+#include <stdio.h>
+#include <string>
+
+using Marcus::circular_buffer;
+using Marcus::circular_buffer_mode;
+
+static_assert(std::random_access_iterator<circular_buffer<int>::iterator>);
+static_assert(
+    std::random_access_iterator<circular_buffer<int>::const_iterator>);
+
+void test_bounded() {
+    circular_buffer<int> buf(4);
+    assert(buf.empty() && buf.capacity() == 4);
+    for (int i = 0; i < 4; i++) {
+        buf.push_back(i);
+    }
+    assert(buf.full() && buf.front() == 0 && buf.back() == 3);
+    // 默认模式下满了再插入会抛异常，内容不变
+    bool thrown = false;
+    try {
+        buf.push_back(4);
+    } catch (std::length_error &) {
+        thrown = true;
+    }
+    assert(thrown && buf.size() == 4 && buf.back() == 3);
+
+    buf.pop_front();
+    buf.pop_front();
+    buf.push_back(4);
+    buf.push_back(5);
+    // 物理上已经回绕，逻辑顺序不变
+    assert(buf[0] == 2 && buf[3] == 5 && buf.at(1) == 3);
+    assert(std::equal(buf.begin(), buf.end(), std::begin({2, 3, 4, 5})));
+    assert(buf.rbegin()[0] == 5 && buf.end() - buf.begin() == 4);
+    auto [first, second] = buf.as_spans();
+    assert(first.size() == 2 && second.size() == 2);
+    assert(first[0] == 2 && second[1] == 5);
+
+    buf.pop_back();
+    buf.push_front(1);
+    assert(buf.front() == 1 && buf.back() == 4);
+    try {
+        buf.at(4);
+        assert(false);
+    } catch (std::out_of_range &) {
+    }
+}
+
+void test_overwrite_oldest() {
+    circular_buffer<int> window(3, circular_buffer_mode::overwrite_oldest);
+    for (int i = 0; i < 10; i++) {
+        window.push_back(i);
+    }
+    // 只留下最近三个
+    assert(window.size() == 3 && window.front() == 7 && window.back() == 9);
+    window.push_front(100);
+    assert(window.front() == 100 && window.back() == 8);
+
+    int sum = 0;
+    auto [a, b] = std::as_const(window).as_spans();
+    assert(a.size() + b.size() == 3);
+    sum = std::accumulate(a.begin(), a.end(), sum);
+    sum = std::accumulate(b.begin(), b.end(), sum);
+    assert(sum == 100 + 7 + 8);
+
+    // 参数引用的正是将被顶替的元素；字符串足够长，放在堆上
+    std::string alpha(40, 'a'), beta(40, 'b'), gamma(40, 'c');
+    circular_buffer<std::string> names({alpha, beta, gamma},
+                                       circular_buffer_mode::overwrite_oldest);
+    names.push_back(names.front());
+    assert(names.front() == beta && names.back() == alpha);
+    names.push_front(names.back());
+    assert(names.front() == alpha && names.back() == gamma);
+    assert(names.size() == 3);
+}
+
+void test_copy_move_and_capacity() {
+    circular_buffer<std::string> buf(4, circular_buffer_mode::overwrite_oldest);
+    for (int i = 0; i < 6; i++) {
+        buf.emplace_back(std::to_string(i));
+    }
+    circular_buffer<std::string> copy(buf);
+    assert(copy == buf && copy.mode() == buf.mode());
+    // 副本从物理下标 0 开始，不再回绕
+    assert(copy.as_spans().second.empty() && copy[0] == "2");
+
+    circular_buffer<std::string> moved(std::move(copy));
+    assert(copy.empty() && copy.capacity() == 0 && moved == buf);
+    copy = buf;
+    copy.push_back("6");
+    assert(copy != buf && buf < copy);
+
+    // 满时原地旋转，未满时搬到新缓冲区
+    std::string *p = buf.linearize();
+    assert(p[0] == "2" && p[3] == "5" && buf.as_spans().second.empty());
+    buf.pop_front();
+    buf.pop_front();
+    buf.push_back("6");
+    assert(!buf.as_spans().second.empty());
+    p = buf.linearize();
+    assert(p[0] == "4" && p[2] == "6" && buf.as_spans().second.empty());
+
+    // 缩小时只留下最新的元素
+    buf.set_capacity(2);
+    assert(buf.capacity() == 2 && buf.size() == 2 && buf.front() == "5");
+    buf.set_capacity(8);
+    buf.push_back("5");
+    assert(buf.size() == 3 && buf.back() == "5");
+    buf.clear();
+    assert(buf.empty() && buf.capacity() == 8);
+
+    circular_buffer<std::string> list({"a", "b", "c"});
+    assert(list.full() && list.back() == "c");
+    swap(list, buf);
+    assert(list.empty() && buf.size() == 3);
+}
+
+int main() {
+    test_bounded();
+    test_overwrite_oldest();
+    test_copy_move_and_capacity();
+    printf("circular_buffer tests passed\n");
+}
@@ -0,0 +1,67 @@
+#include <cassert>
+#include <containers/concurrent_map.hpp>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main() {
+    Marcus::concurrent_map<std::string, int> table;
+    assert(table.try_emplace("hello", 1));
+    assert(!table.try_emplace("hello", 2));
+    assert(table.insert_or_assign("world", 2));
+    assert(!table.insert_or_assign("world", 3));
+    int seen = 0;
+    assert(table.find_and_apply("world", [&](const int &value) {
+        seen = value;
+    }));
+    assert(seen == 3);
+    assert(!table.find_and_apply("missing", [](const int &) {
+        assert(false);
+    }));
+    assert(!table.upsert("hello", [](int &value) { value += 10; }));
+    assert(table.find_and_apply("hello", [](const int &value) {
+        assert(value == 11);
+    }));
+    assert(table.upsert("foo", [](int &) { assert(false); }, 7));
+    assert(table.size() == 3 && table.contains("foo"));
+    assert(!table.erase_if("foo", [](int &value) { return value != 7; }));
+    assert(table.erase_if("foo", [](int &value) { return value == 7; }));
+    assert(!table.erase("foo") && table.erase("world"));
+    assert(table.size() == 1);
+
+    // 多个线程对重叠的键做计数，总数必须守恒
+    Marcus::concurrent_map<int, long, std::less<int>, std::hash<int>, 8>
+        counters;
+    const int threads = 8, rounds = 20000, keys = 100;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < rounds; i++) {
+                int key = (i * 7 + t) % keys;
+                counters.upsert(key, [](long &count) { ++count; }, 1L);
+                counters.find_and_apply(key, [](const long &count) {
+                    assert(count > 0);
+                });
+            }
+        });
+    }
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+    long total = 0;
+    counters.for_each([&](const std::pair<const int, long> &entry) {
+        total += entry.second;
+    });
+    printf("counters = %zu, total = %ld\n", counters.size(), total);
+    assert(counters.size() == keys);
+    assert(total == long(threads) * rounds);
+
+    size_t erased = counters.erase_if(
+        [](const std::pair<const int, long> &entry) {
+            return entry.first % 2 == 0;
+        });
+    assert(erased == keys / 2 && counters.size() == keys / 2);
+    counters.clear();
+    assert(counters.empty());
+}
@@ -1,8 +1,12 @@
 #include <algorithm>
 #include <cassert>
 #include <containers/deque.hpp>
+#include <deque>
 #include <iostream>
+#include <list>
+#include <new>
 #include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -295,6 +299,18 @@ void test_push_pop() {
     print_deque(d, "d (after all pops)");
     assert(d.empty());
 
+    // 恰好填满整块时 end() 仍然可达，用作 FIFO 时头尾会反复跨过块边界
+    for (int i = 0; i < 128; i++) {
+        d.push_back(i);
+    }
+    assert(std::distance(d.begin(), d.end()) == 128 && d.back() == 127);
+    for (int i = 0; i < 10000; i++) {
+        d.push_back(i);
+        assert(d.front() == (i < 128 ? i : i - 128));
+        d.pop_front();
+    }
+    d.clear();
+
     std::cout << "\n--- Testing Push/Pop with MyClass ---\n";
     MyClass::reset_counts();
     Marcus::deque<MyClass> mc_deque;
@@ -479,6 +495,215 @@ void test_assign() {
     std::cout << "Assign tests passed.\n";
 }
 
+void test_ranges() {
+    std::cout << "\n--- Testing Ranges ---\n";
+    // 跨越多个块的批量追加
+    std::vector<int> src(1000);
+    std::iota(src.begin(), src.end(), 0);
+    Marcus::deque<int> d;
+    d.push_back(-1);
+    d.append_range(src);
+    assert(d.size() == 1001 && d.front() == -1 && d.back() == 999);
+    for (int i = 0; i < 1000; ++i) {
+        assert(d[i + 1] == i);
+    }
+    d.push_back(1000);
+    d.push_front(-2);
+    assert(d.size() == 1003 && d.back() == 1000 && d.front() == -2);
+
+    std::list<int> l = {7, 8, 9};
+    auto it = d.insert_range(d.begin() + 2, l);
+    assert(it == d.begin() + 2 && *it == 7 && d[4] == 9 && d[5] == 0);
+
+    std::istringstream in("5 6");
+    d.insert(d.begin(), std::istream_iterator<int>(in),
+             std::istream_iterator<int>{});
+    assert(d.size() == 1008 && d[0] == 5 && d[1] == 6 && d[2] == -2);
+
+    d.assign_range(l);
+    print_deque(d, "d (assign_range from list)");
+    assert(d.size() == 3 && d.front() == 7 && d.back() == 9);
+
+    std::istringstream in2("1 2 3");
+    Marcus::deque<int> d2(std::istream_iterator<int>(in2),
+                          std::istream_iterator<int>{});
+    assert(d2.size() == 3 && d2[2] == 3);
+
+    // 刚好填满整块时 _finish 要落在下一块的开头
+    Marcus::deque<int> d3;
+    std::vector<int> block(Marcus::deque<int>::iterator::_block_size);
+    d3.append_range(block);
+    d3.append_range(block);
+    assert(d3.size() == 2 * block.size());
+    d3.push_back(1);
+    assert(d3.back() == 1);
+
+    // 插入位置靠前时新元素从开头放入，插入点之后的元素原地不动
+    Marcus::deque<int, std::allocator<int>, 4> near_front;
+    std::deque<int> expected;
+    for (int i = 0; i < 1000; ++i) {
+        near_front.push_back(i);
+        expected.push_back(i);
+    }
+    const int *after = &near_front[2];
+    std::vector<int> five = {-1, -2, -3, -4, -5};
+    auto pos = near_front.insert_range(near_front.begin() + 2, five);
+    expected.insert(expected.begin() + 2, five.begin(), five.end());
+    assert(pos == near_front.begin() + 2 && &near_front[7] == after);
+    for (std::size_t at: {0, 1, 9, 300, 700, 1004}) {
+        std::vector<int> run(at % 11 + 1, static_cast<int>(at));
+        near_front.insert_range(near_front.begin() + at, run);
+        expected.insert(expected.begin() + at, run.begin(), run.end());
+    }
+    assert(std::equal(near_front.begin(), near_front.end(), expected.begin(),
+                      expected.end()));
+
+    std::list<std::string> strs = {"a", "b", "c"};
+    Marcus::deque<std::string> ds = {"x", "y"};
+    ds.insert(ds.begin() + 1, strs.begin(), strs.end());
+    assert(ds.size() == 5 && ds[0] == "x" && ds[1] == "a" && ds[4] == "y");
+
+    std::cout << "Ranges tests passed.\n";
+}
+
+// 统计 allocate 次数和尚未归还的次数，fail_at 次之后的分配抛 bad_alloc
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+    static inline int allocations = 0;
+    static inline int outstanding = 0;
+    static inline int fail_at = -1;
+
+    counting_allocator() = default;
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U> &) noexcept {}
+
+    T *allocate(std::size_t n) {
+        if (fail_at >= 0 && fail_at-- == 0) {
+            throw std::bad_alloc();
+        }
+        ++allocations;
+        ++outstanding;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+        --outstanding;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const counting_allocator<U> &) const noexcept {
+        return true;
+    }
+};
+
+void test_block_size_and_spares() {
+    std::cout << "\n--- Testing Block Size And Spare Blocks ---\n";
+    using small_blocks = Marcus::deque<int, counting_allocator<int>, 4>;
+    static_assert(small_blocks::iterator::_block_size == 4);
+    small_blocks d;
+    for (int i = 0; i < 10; ++i) {
+        d.push_back(i);
+    }
+    d.push_front(-1);
+    assert(d.size() == 11 && d.front() == -1 && d.back() == 9);
+    assert(d[5] == 4 && d.end() - d.begin() == 11);
+
+    // 在块边界上反复进出，空出来的块留着复用，不再分配
+    while (d.size() != 3) {
+        d.pop_back();
+    }
+    d.push_back(2);
+    d.pop_back();
+    int before = counting_allocator<int>::allocations;
+    for (int i = 0; i < 100; ++i) {
+        d.push_back(i);
+        d.pop_back();
+        d.push_front(i);
+        d.pop_front();
+    }
+    assert(counting_allocator<int>::allocations == before);
+    assert(d.size() == 3 && d[2] == 1);
+
+    small_blocks other(d);
+    other.swap(d);
+    assert(other.size() == 3 && d[0] == -1);
+
+    // 构造到一半分配失败，已经拿到的块不能留在缓存里
+    int live = counting_allocator<int>::outstanding;
+    counting_allocator<int>::fail_at = 2;
+    bool thrown = false;
+    try {
+        small_blocks partial(20);
+    } catch (std::bad_alloc &) {
+        thrown = true;
+    }
+    counting_allocator<int>::fail_at = -1;
+    assert(thrown && counting_allocator<int>::outstanding == live);
+    std::cout << "Block size and spare block tests passed.\n";
+}
+
+void test_segmented_algorithms() {
+    std::cout << "\n--- Testing Segmented Algorithms ---\n";
+    // 块很小，任何区间都会跨好几个块，且首尾都不在块边界上
+    using small_blocks = Marcus::deque<int, std::allocator<int>, 4>;
+    small_blocks d;
+    for (int i = 0; i < 20; ++i) {
+        d.push_back(i);
+    }
+    d.push_front(-1);
+    d.push_front(-2);
+
+    std::vector<std::pair<int, int>> segments;
+    int sum = 0;
+    Marcus::for_each_segment(d.cbegin() + 1, d.cend() - 1,
+                             [&](const int *first, const int *last) {
+                                 segments.emplace_back(*first, *(last - 1));
+                                 sum = std::accumulate(first, last, sum);
+                             });
+    assert(segments.size() == 6);
+    assert(segments.front().first == -1 && segments.back().second == 18);
+    assert(sum == std::accumulate(d.begin() + 1, d.end() - 1, 0));
+
+    assert(Marcus::find(d.begin(), d.end(), 13) == d.begin() + 15);
+    assert(Marcus::find(d.cbegin(), d.cend(), 100) == d.cend());
+    assert(Marcus::find(d.begin() + 3, d.begin() + 3, 1) == d.begin() + 3);
+
+    // deque -> vector, vector -> deque, deque -> 块边界错开的 deque
+    std::vector<int> v(d.size());
+    assert(Marcus::copy(d.begin(), d.end(), v.begin()) == v.end());
+    assert(std::equal(v.begin(), v.end(), d.begin()));
+    small_blocks e(25, 0);
+    auto it = Marcus::copy(v.begin(), v.end(), e.begin() + 1);
+    assert(it == e.begin() + 23 && e[0] == 0 && e[1] == -2 && e[23] == 0);
+    small_blocks f(23, 7);
+    Marcus::copy(e.begin() + 1, e.begin() + 23, f.begin());
+    assert(Marcus::equal(d.begin(), d.end(), f.begin()) && f[22] == 7);
+    assert(Marcus::equal(d.cbegin(), d.cend(), v.begin()));
+    v[17] = 100;
+    assert(!Marcus::equal(d.begin(), d.end(), v.begin()));
+
+    Marcus::fill(e.begin() + 2, e.end() - 2, 5);
+    assert(e[1] == -2 && e[2] == 5 && e[22] == 5 && e[23] == 0);
+    assert(std::count(e.begin(), e.end(), 5) == 21);
+
+    // 长度不同、在不同位置出现差异
+    small_blocks g(d);
+    assert(!Marcus::lexicographical_compare(d.begin(), d.end(), g.begin(),
+                                            g.end()));
+    assert(Marcus::lexicographical_compare(d.begin(), d.end() - 1, g.begin(),
+                                           g.end()));
+    g.pop_front();
+    assert(Marcus::lexicographical_compare(d.begin(), d.end(), g.cbegin(),
+                                           g.cend()));
+    g.push_front(-2);
+    g[19] = 0;
+    assert(g < d && !(d < g) && d != g);
+    std::cout << "Segmented algorithm tests passed.\n";
+}
+
 void test_assignment_operators() {
     std::cout << "\n--- Testing Assignment Operators ---\n";
     Marcus::deque<int> d1 = {1, 2, 3};
@@ -645,6 +870,9 @@ int main() {
     test_insert();
     test_erase();
     test_assign();
+    test_ranges();
+    test_block_size_and_spares();
+    test_segmented_algorithms();
     test_assignment_operators();
     test_swap();
     test_comparison_operators();
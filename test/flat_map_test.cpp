@@ -0,0 +1,94 @@
+#include <cassert>
+#include <containers/flat_map.hpp>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+int main() {
+    Marcus::flat_map<int, std::string> m{
+        {3, "three"}, {1, "one"}, {2, "two"}, {1, "uno"}};
+    for (auto [k, v]: m) {
+        printf("%d %s\n", k, v.c_str());
+    }
+    assert(m.size() == 3);
+    assert(m.at(1) == "one"); // the first of duplicate keys wins
+    m[4] = "four";
+    m[2] += "!";
+    assert(m.at(2) == "two!");
+    assert(!m.try_emplace(4, "x").second);
+    assert(!m.insert_or_assign(4, "FOUR").second && m[4] == "FOUR");
+    assert(m.emplace(0, "zero").second && m.begin()->second == "zero");
+    assert(m.find(5) == m.end());
+    assert(m.lower_bound(2)->first == 2 && m.upper_bound(2)->first == 3);
+    assert(m.erase(3) == 1 && m.erase(3) == 0);
+    try {
+        m.at(3);
+        assert(false);
+    } catch (std::out_of_range const &) {
+    }
+
+    // keys and values live in separate arrays
+    assert(m.keys().size() == m.values().size());
+    assert(m.keys()[0] == 0 && m.values()[0] == "zero");
+
+    // bulk construction from parallel containers
+    Marcus::vector<int> ks{5, 1, 4, 1};
+    Marcus::vector<int> vs{50, 10, 40, 11};
+    Marcus::flat_map<int, int> bulk(std::move(ks), std::move(vs));
+    assert(bulk.size() == 3);
+    assert(bulk.at(1) == 10 && bulk.at(4) == 40 && bulk.at(5) == 50);
+
+    // random batches merged into the map, checked against std::map
+    std::mt19937 rng(5);
+    Marcus::flat_map<int, int> flat;
+    std::map<int, int> ref;
+    for (int round = 0; round < 200; ++round) {
+        std::vector<std::pair<int, int>> batch(rng() % 64);
+        for (auto &[k, v]: batch) {
+            k = rng() % 2000;
+            v = rng();
+        }
+        flat.insert_range(batch);
+        ref.insert(batch.begin(), batch.end());
+        for (int k = 0; k < 8; ++k) {
+            int x = rng() % 2000;
+            assert(flat.erase(x) == ref.erase(x));
+        }
+        assert(flat.size() == ref.size());
+        auto it = flat.begin();
+        for (auto const &[k, v]: ref) {
+            assert(it->first == k && it->second == v);
+            ++it;
+        }
+    }
+
+    // ascending appends take the fast path and leave the prefix in place
+    Marcus::flat_map<int, int> seq;
+    std::vector<std::pair<int, int>> run;
+    for (int i = 0; i < 100; ++i) {
+        run.emplace_back(i, i * i);
+    }
+    seq.insert(Marcus::sorted_unique, run.begin(), run.begin() + 50);
+    seq.insert(run.begin() + 50, run.end());
+    assert(seq.size() == 100 && seq.rbegin()->second == 99 * 99);
+    assert((seq.end() - seq.begin()) == 100);
+
+    Marcus::flat_map<int, int> copy = flat;
+    assert(copy == flat);
+    copy.erase(copy.begin(), copy.begin() + 10);
+    assert(copy.size() + 10 == flat.size());
+
+    // heterogeneous lookup through std::less<>
+    Marcus::flat_map<std::string, int, std::less<>> ages{{"bob", 30},
+                                                         {"alice", 25}};
+    assert(ages.contains(std::string_view("alice")));
+    assert(ages.at(std::string_view("bob")) == 30);
+    assert(ages.find("carol") == ages.end());
+    auto c = std::move(ages).extract();
+    assert(c.keys.size() == 2 && c.values[0] == 25);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <cassert>
+#include <containers/flat_set.hpp>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+int main() {
+    // unsorted input with duplicates is sorted and deduplicated on construction
+    Marcus::flat_set<int> s{5, 3, 9, 3, 1, 5, 7};
+    for (int i: s) {
+        printf("%d\n", i);
+    }
+    assert(s.size() == 5);
+    assert(*s.begin() == 1 && *s.rbegin() == 9);
+    printf("insert 4 = %d\n", s.insert(4).second); // 1
+    printf("insert 4 = %d\n", s.insert(4).second); // 0
+    printf("find 7 = %d\n", s.find(7) != s.end()); // 1
+    printf("find 8 = %d\n", s.find(8) != s.end()); // 0
+    assert(*s.lower_bound(6) == 7 && *s.upper_bound(7) == 9);
+    s.erase(3);
+    assert(!s.contains(3) && s.size() == 5);
+
+    // sorted_unique skips the sort, appending past the end keeps the prefix
+    Marcus::vector<int> keys{1, 2, 3, 4};
+    Marcus::flat_set<int> sorted(Marcus::sorted_unique, std::move(keys));
+    int more[] = {5, 6, 7};
+    sorted.insert(Marcus::sorted_unique, more, more + 3);
+    assert(sorted.size() == 7 && *sorted.rbegin() == 7);
+
+    // random batches merged into the set, checked against std::set
+    std::mt19937 rng(3);
+    Marcus::flat_set<int> flat;
+    std::set<int> ref;
+    for (int round = 0; round < 200; ++round) {
+        std::vector<int> batch(rng() % 64);
+        for (int &x: batch) {
+            x = rng() % 2000;
+        }
+        flat.insert_range(batch);
+        ref.insert(batch.begin(), batch.end());
+        for (int k = 0; k < 8; ++k) {
+            int x = rng() % 2000;
+            assert(flat.erase(x) == ref.erase(x));
+        }
+        assert(flat.size() == ref.size());
+        assert(std::equal(flat.begin(), flat.end(), ref.begin(), ref.end()));
+    }
+
+    Marcus::flat_set<int> copy = flat;
+    assert(copy == flat);
+    copy.erase(copy.begin(), copy.begin() + copy.size() / 2);
+    assert(copy.size() == flat.size() - flat.size() / 2);
+    assert(copy != flat);
+
+    // heterogeneous lookup through std::less<>
+    Marcus::flat_set<std::string, std::less<>> names{"carol", "alice", "bob"};
+    assert(names.contains(std::string_view("bob")));
+    assert(names.find("dave") == names.end());
+    assert(*names.begin() == "alice");
+    Marcus::vector<std::string> out = std::move(names).extract();
+    assert(out.size() == 3 && names.empty());
+    return 0;
+}
@@ -1,7 +1,32 @@
+#include "_alloc_counter.hpp"
+#include <cassert>
 #include <cstdio>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <utility/functional.hpp>
 
+struct counted {
+    static inline int live = 0;
+    int value;
+
+    counted(int v) : value(v) {
+        ++live;
+    }
+
+    counted(const counted &that) : value(that.value) {
+        ++live;
+    }
+
+    ~counted() {
+        --live;
+    }
+
+    int operator()(int x) const {
+        return value + x;
+    }
+};
+
 void func_hello(int i) {
     printf("#%d Hello\n", i);
 }
@@ -37,5 +62,94 @@ int main() {
     auto ff = f;
     ff(3);
 
+    // 不超过三个指针的可调用对象不分配内存，复制和移动也不分配
+    int before = allocations;
+    long a = 1, b = 2, c = 3;
+    Marcus::Function<long(long)> small = [a, b, c](long x) {
+        return a + b + c + x;
+    };
+    Marcus::Function<long(long)> small_copy = small;
+    Marcus::Function<long(long)> small_moved = std::move(small_copy);
+    assert(allocations == before);
+    assert(small(1) == 7 && small_moved(2) == 8 && !small_copy);
+
+    // 超过缓冲区的放到堆上，每次复制分配一次
+    long d = 4;
+    Marcus::Function<long(long)> big = [a, b, c, d](long x) {
+        return a + b + c + d + x;
+    };
+    assert(allocations == before + 1);
+    Marcus::Function<long(long)> big_copy = big;
+    assert(allocations == before + 2);
+    Marcus::Function<long(long)> big_moved = std::move(big_copy);
+    assert(allocations == before + 2 && big_moved(0) == 10);
+
+    // 缓冲区大小可以调整
+    using roomy_function = Marcus::Function<long(long), 4 * sizeof(void *)>;
+    roomy_function roomy = [a, b, c, d](long x) {
+        return a + b + c + d + x;
+    };
+    assert(allocations == before + 2 && roomy(1) == 11);
+
+    // 非平凡对象的复制、析构和 target
+    {
+        Marcus::Function<int(int)> g = counted(5);
+        Marcus::Function<int(int)> h = g;
+        assert(counted::live == 2 && g(1) == 6 && h(2) == 7);
+        assert(h.target<counted>() && h.target<counted>()->value == 5);
+        assert(!h.target<int (*)(int)>());
+        assert(h.target_type() == typeid(counted));
+        g = nullptr;
+        assert(counted::live == 1 && !g);
+        g.swap(h);
+        assert(g && !h && g(0) == 5);
+        h = g;
+        assert(counted::live == 2);
+    }
+    assert(counted::live == 0);
+
+    int (*null_fn)(int) = nullptr;
+    Marcus::Function<int(int)> empty = null_fn;
+    assert(!empty);
+    try {
+        empty(1);
+        assert(false);
+    } catch (const std::bad_function_call &) {
+    }
+
+    // MoveOnlyFunction 可以持有只能移动的对象
+    auto owned = std::make_unique<std::string>("moved");
+    Marcus::MoveOnlyFunction<size_t()> length = [p = std::move(owned)] {
+        return p->size();
+    };
+    Marcus::MoveOnlyFunction<size_t()> length_moved = std::move(length);
+    assert(!length && length_moved() == 5);
+    Marcus::MoveOnlyFunction<int(int)> in_place(std::in_place_type<counted>,
+                                                3);
+    assert(in_place(4) == 7 && counted::live == 1);
+    in_place = nullptr;
+    assert(counted::live == 0);
+
+    // function_ref 只引用目标，不分配内存，可以平凡复制
+    static_assert(sizeof(Marcus::function_ref<int(int)>) == 2 * sizeof(void *));
+    static_assert(
+        std::is_trivially_copyable_v<Marcus::function_ref<int(int)>>);
+    before = allocations;
+    counted adder(10);
+    Marcus::function_ref<int(int)> by_object = adder;
+    Marcus::function_ref<int(int)> by_copy = by_object;
+    adder.value = 20;
+    assert(by_copy(1) == 21);
+    Marcus::function_ref<int(int)> by_pointer = +[](int x) {
+        return x * 2;
+    };
+    assert(by_pointer(4) == 8);
+    Marcus::function_ref<void(int)> by_function = func_hello;
+    by_function(3);
+    Marcus::Function<int(int)> wrapped = counted(1);
+    Marcus::function_ref<long(int)> by_wrapper = wrapped;
+    assert(by_wrapper(2) == 3);
+    assert(allocations == before + 1);
+
     return 0;
 }
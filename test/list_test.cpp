@@ -1,3 +1,4 @@
+#include <cassert>
 #include <containers/list.hpp>
 #include <cstddef>
 #include <cstdint>
@@ -39,4 +40,41 @@ int main() {
               << ", arr2.empty() = " << arr2.empty() << '\n';
     Marcus::list<int> arr3(3);
     std::cout << arr3.size() << '\n';
+
+    // splice 只改指针：迭代器和元素地址都不变
+    Marcus::list<std::string> lru{"a", "b", "c", "d"};
+    auto c = std::next(lru.begin(), 2);
+    const std::string *addr = &*c;
+    lru.splice(lru.cbegin(), lru, c);
+    lru.splice(lru.cbegin(), lru, lru.cbegin()); // 原地不动
+    assert(&lru.front() == addr && lru.size() == 4);
+    assert((lru == Marcus::list<std::string>{"c", "a", "b", "d"}));
+    lru.splice(lru.cend(), lru, lru.cbegin(), std::next(lru.cbegin(), 2));
+    assert((lru == Marcus::list<std::string>{"b", "d", "c", "a"}));
+
+    Marcus::list<std::string> other{"x", "y", "z"};
+    lru.splice(std::next(lru.cbegin()), other, std::next(other.cbegin()),
+               other.cend());
+    assert(lru.size() == 6 && other.size() == 1 && other.front() == "x");
+    assert(*std::next(lru.begin()) == "y" && *std::next(lru.begin(), 2) == "z");
+    lru.splice(lru.cend(), std::move(other));
+    assert(other.empty() && lru.size() == 7 && &lru.front() != addr);
+    assert(&*std::next(lru.begin(), 4) == addr && lru.back() == "x");
+
+    // 删除的节点进缓存，之后的插入先从缓存里拿
+    Marcus::list<int> cached;
+    cached.set_node_cache_limit(2);
+    for (int k = 0; k < 5; k++) {
+        cached.push_back(k);
+    }
+    cached.pop_front();
+    cached.clear();
+    assert(cached.node_cache_size() == 2);
+    cached.push_back(7);
+    cached.push_back(8);
+    cached.push_back(9);
+    assert(cached.node_cache_size() == 0 && cached.size() == 3);
+    cached.pop_back();
+    cached.set_node_cache_limit(0);
+    assert(cached.node_cache_size() == 0);
 }
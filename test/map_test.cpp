@@ -1,6 +1,59 @@
+#include <cassert>
 #include <containers/map.hpp>
+#include <cstddef>
 #include <iostream>
+#include <map>
 #include <string>
+#include <string_view>
+#include <utility>
+
+// 键只许移动：B 树分裂节点时如果复制了键，copies 就会增加
+struct counted_key {
+    std::string text;
+    static inline int copies = 0;
+
+    explicit counted_key(int i)
+        : text(std::to_string(i) + " is longer than the SSO buffer") {}
+    counted_key(const counted_key &that) : text(that.text) {
+        ++copies;
+    }
+    counted_key(counted_key &&) noexcept = default;
+
+    bool operator<(const counted_key &that) const {
+        return text < that.text;
+    }
+};
+
+// 每个默认构造的分配器都有自己的编号，释放时检查是不是同一个分配器申请的
+template <class T>
+struct tagged_allocator {
+    using value_type = T;
+    static inline int next_tag = 0;
+    static inline std::map<void *, int> owner;
+    int tag = ++next_tag;
+
+    tagged_allocator() = default;
+    template <class U>
+    tagged_allocator(const tagged_allocator<U> &that) noexcept
+        : tag(that.tag) {}
+
+    T *allocate(std::size_t n) {
+        T *p = std::allocator<T>().allocate(n);
+        owner[p] = tag;
+        return p;
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+        assert(owner.at(p) == tag);
+        owner.erase(p);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <class U>
+    bool operator==(const tagged_allocator<U> &that) const noexcept {
+        return tag == that.tag;
+    }
+};
 
 int main() {
     std::cout << std::boolalpha;
@@ -18,4 +71,92 @@ int main() {
 
     std::cout << "at(delay)" << table.at("delay") << std::endl;
     std::cout << "size: " << table.size() << std::endl;
+
+    auto node = table.extract("delay");
+    assert(node.key() == "delay" && node.mapped() == 12);
+    assert(!table.contains("delay"));
+    {
+        Marcus::map<std::string, int> other;
+        other.insert(std::move(node));
+        assert(other.at("delay") == 12);
+        node = other.extract("delay");
+    } // node outlives the map it was extracted from
+    table.insert(std::move(node));
+    std::cout << "after reinsert: " << table.at("delay") << std::endl;
+    std::cout << "nodes in use: " << table.memory_stats().nodes_in_use
+              << std::endl;
+
+    Marcus::btree_map<std::string, int, std::less<>> btable;
+    for (int i = 0; i < 1000; i++) {
+        btable[std::to_string(i)] = i;
+    }
+    assert(btable.at("500") == 500);
+    assert(btable.find(std::string_view("42"))->second == 42);
+    for (int i = 0; i < 1000; i += 2) {
+        btable.erase(std::to_string(i));
+    }
+    std::cout << "btree_map size: " << btable.size() << std::endl;
+    for (auto &[key, value]: btable) {
+        assert(value % 2 == 1 && std::to_string(value) == key);
+    }
+
+    // range construction and insertion
+    std::pair<int, int> items[] = {{3, 30}, {1, 10}, {3, 31}, {2, 20}};
+    Marcus::map<int, int> ranged(items, items + 4);
+    assert(ranged.size() == 3 && ranged.at(3) == 30);
+    Marcus::multimap<int, int> mranged;
+    mranged.insert(items, items + 4);
+    assert(mranged.size() == 4);
+
+    // hinted insertion: appends at end(), a correct hint, a wrong hint
+    Marcus::map<int, int> hinted;
+    for (int i = 0; i < 1000; i += 2) {
+        assert(hinted.emplace_hint(hinted.end(), i, i)->first == i);
+    }
+    auto hint = hinted.find(500);
+    assert(hinted.insert(hint, {499, 499})->first == 499);
+    assert(hinted.emplace_hint(hint, 7, 7)->first == 7);
+    assert(hinted.emplace_hint(hint, 500, -1)->second == 500);
+    assert(hinted.size() == 502);
+    int previous = -1;
+    for (auto &[key, value]: hinted) {
+        assert(key > previous && key == value);
+        previous = key;
+    }
+    Marcus::multimap<int, int> mhinted;
+    for (int i = 0; i < 10; i++) {
+        mhinted.emplace_hint(mhinted.end(), i / 3, i);
+    }
+    previous = -1;
+    for (auto &[key, value]: mhinted) {
+        assert(value == previous + 1 && key == value / 3);
+        previous = value;
+    }
+
+    // 分裂、合并节点时键被移动，不被复制
+    {
+        Marcus::btree_map<counted_key, int> moved;
+        for (int i = 0; i < 1000; i++) {
+            moved.emplace(counted_key(i), i);
+        }
+        for (int i = 0; i < 1000; i += 3) {
+            moved.erase(counted_key(i));
+        }
+        assert(counted_key::copies == 0 && moved.size() == 666);
+    }
+
+    // 移动赋值后，每棵树的节点仍由申请它的分配器释放
+    {
+        using tagged_map =
+            Marcus::btree_map<int, int, std::less<int>,
+                              tagged_allocator<std::pair<const int, int>>>;
+        tagged_map left, right;
+        for (int i = 0; i < 500; i++) {
+            left[i] = i;
+            right[-i] = i;
+        }
+        left = std::move(right);
+        assert(left.size() == 500 && left.at(-499) == 499);
+    }
+    assert(tagged_allocator<int>::owner.empty());
 }
@@ -0,0 +1,144 @@
+#include <cassert>
+#include <containers/deque.hpp>
+#include <containers/forward_list.hpp>
+#include <containers/list.hpp>
+#include <containers/map.hpp>
+#include <containers/set.hpp>
+#include <containers/vector.hpp>
+#include <cstdint>
+#include <memory/memory_resource.hpp>
+#include <stdio.h>
+#include <string>
+
+// 记录向上游申请和归还次数的资源
+struct counting_resource : Marcus::memory_resource {
+    int allocations = 0;
+    int deallocations = 0;
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t align) override {
+        ++allocations;
+        return Marcus::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes,
+                       std::size_t align) override {
+        ++deallocations;
+        Marcus::new_delete_resource()->deallocate(p, bytes, align);
+    }
+};
+
+template <class T>
+using alloc = Marcus::polymorphic_allocator<T>;
+
+void test_monotonic_arena() {
+    counting_resource upstream;
+    {
+        Marcus::monotonic_arena arena(&upstream);
+        assert(arena.deallocate_is_noop());
+        void *a = arena.allocate(10, 1);
+        void *b = arena.allocate(8, 64);
+        assert(reinterpret_cast<std::uintptr_t>(b) % 64 == 0);
+        assert(static_cast<char *>(b) >= static_cast<char *>(a) + 10);
+        // 超过当前大块的请求也能满足
+        void *big = arena.allocate(100000);
+        assert(big != nullptr && upstream.allocations == 2);
+        arena.deallocate(big, 100000);
+        assert(upstream.deallocations == 0);
+        arena.release();
+        assert(upstream.deallocations == 2);
+        assert(arena.allocate(16) != nullptr);
+    }
+    assert(upstream.allocations == upstream.deallocations);
+
+    // 先用完栈上的缓冲区才向上游申请
+    alignas(std::max_align_t) char buffer[256];
+    Marcus::monotonic_arena arena(buffer, sizeof(buffer), &upstream);
+    int before = upstream.allocations;
+    void *p = arena.allocate(200);
+    assert(p == buffer && upstream.allocations == before);
+    assert(arena.allocate(200) != buffer);
+    assert(upstream.allocations == before + 1);
+}
+
+void test_pool_resource() {
+    counting_resource upstream;
+    {
+        Marcus::pool_resource pool(&upstream);
+        assert(!pool.deallocate_is_noop());
+        void *a = pool.allocate(24);
+        void *b = pool.allocate(24);
+        assert(a != b && upstream.allocations == 1);
+        // 释放的块按大小挂回空闲链表，下次同级请求直接复用
+        pool.deallocate(a, 24);
+        assert(pool.allocate(32) == a);
+        void *big = pool.allocate(4096);
+        assert(upstream.allocations == 2);
+        pool.deallocate(big, 4096);
+        assert(upstream.deallocations == 1);
+    }
+    assert(upstream.allocations == upstream.deallocations);
+}
+
+void test_containers() {
+    counting_resource upstream;
+    {
+        Marcus::monotonic_arena arena(&upstream);
+        Marcus::vector<int, alloc<int>> v(&arena);
+        Marcus::deque<int, alloc<int>> d(&arena);
+        Marcus::list<std::string, alloc<std::string>> l(&arena);
+        Marcus::forward_list<int, alloc<int>> fl(&arena);
+        Marcus::map<int, std::string, std::less<int>,
+                    alloc<std::pair<const int, std::string>>>
+            m(&arena);
+        Marcus::set<int, std::less<int>, alloc<int>> s(&arena);
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(i);
+            d.push_front(i);
+            l.push_back(std::to_string(i));
+            fl.push_front(i);
+            m.emplace(i, std::to_string(i));
+            s.insert(i);
+        }
+        assert(v.size() == 1000 && d.front() == 999 && l.back() == "999");
+        assert(m.size() == 1000 && m[500] == "500" && s.count(999) == 1);
+
+        // 复制出来的容器仍然使用同一个资源
+        auto m2 = m;
+        assert(m2.get_allocator().resource() == &arena);
+        Marcus::vector<int, alloc<int>> v2;
+        v2 = std::move(v);
+        assert(v2.get_allocator().resource() == &arena && v2.size() == 1000);
+        assert(upstream.deallocations == 0);
+    }
+    assert(upstream.allocations == upstream.deallocations);
+
+    Marcus::pool_resource pool(&upstream);
+    {
+        Marcus::list<int, alloc<int>> l(&pool);
+        for (int i = 0; i < 100; ++i) {
+            l.push_back(i);
+        }
+        int before = upstream.allocations;
+        l.clear();
+        for (int i = 0; i < 100; ++i) {
+            l.push_back(i);
+        }
+        // 清空后再插入的节点全部来自空闲链表
+        assert(upstream.allocations == before);
+
+        // 资源不同时节点不能换主人，splice 退化为逐个移动
+        Marcus::pool_resource other_pool;
+        Marcus::list<int, alloc<int>> other(&other_pool);
+        other.push_back(-1);
+        l.splice(l.cbegin(), other);
+        assert(other.empty() && l.size() == 101 && l.front() == -1);
+    }
+}
+
+int main() {
+    test_monotonic_arena();
+    test_pool_resource();
+    test_containers();
+    printf("memory_resource tests passed\n");
+}
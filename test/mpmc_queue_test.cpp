@@ -0,0 +1,107 @@
+#include <adaptors/mpmc_queue.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main() {
+    Marcus::mpmc_queue<std::string, 4> strings;
+    assert(strings.empty() && strings.capacity() == 4);
+    assert(strings.try_push("a"));
+    assert(strings.try_emplace(3, 'b'));
+    std::string c = "c";
+    assert(strings.try_push(c) && strings.try_push(std::move(c)));
+    assert(!strings.try_push("full") && strings.size() == 4);
+    std::string out;
+    assert(strings.try_pop(out) && out == "a");
+    assert(strings.try_pop(out) && out == "bbb");
+    assert(strings.try_push("d"));
+    std::string batch[8];
+    assert(strings.try_pop_n(batch, 8) == 3);
+    assert(batch[0] == "c" && batch[1] == "c" && batch[2] == "d");
+    assert(!strings.try_pop(out) && strings.empty());
+    std::string more[] = {"e", "f", "g", "h", "i"};
+    assert(strings.try_push_n(more, 5) == 4 && strings.size() == 4);
+
+    // 析构时释放队列里剩余的元素
+    {
+        Marcus::mpmc_queue<std::unique_ptr<int>, 8> owned;
+        owned.push(std::make_unique<int>(1));
+        owned.push(std::make_unique<int>(2));
+        std::unique_ptr<int> first;
+        owned.pop(first);
+        assert(*first == 1);
+    }
+
+    // 多生产者多消费者，容量很小以便频繁走到满和空的阻塞路径；
+    // 批量操作认领不到位置时退回阻塞的单个操作
+    Marcus::mpmc_queue<long, 16> queue;
+    const int producers = 4, consumers = 4, per_thread = 50000;
+    std::atomic<long> sum{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            long base = long(p) * per_thread, values[4];
+            for (int i = 0; i < per_thread;) {
+                size_t n = 0;
+                if (p % 2 == 0 && i + 4 <= per_thread) {
+                    for (int k = 0; k < 4; k++) {
+                        values[k] = base + i + k;
+                    }
+                    n = queue.try_push_n(values, 4);
+                }
+                if (n == 0) {
+                    queue.push(base + i);
+                    n = 1;
+                }
+                i += int(n);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        threads.emplace_back([&, c] {
+            long local = 0, values[4];
+            for (int i = 0; i < per_thread;) {
+                size_t n = 0;
+                if (c % 2 == 0) {
+                    n = queue.try_pop_n(values, std::min(4, per_thread - i));
+                }
+                if (n == 0) {
+                    queue.pop(values[0]);
+                    n = 1;
+                }
+                for (size_t k = 0; k < n; k++) {
+                    local += values[k];
+                }
+                i += int(n);
+            }
+            sum += local;
+        });
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+    long n = long(producers) * per_thread;
+    printf("sum = %ld\n", sum.load());
+    assert(sum.load() == n * (n - 1) / 2);
+    assert(queue.empty());
+
+    // 阻塞的 pop 被之后的 push 唤醒
+    Marcus::mpmc_queue<int, 2> handoff;
+    std::thread waiter([&] {
+        for (int i = 0; i < 1000; i++) {
+            int value;
+            handoff.pop(value);
+            assert(value == i);
+        }
+    });
+    for (int i = 0; i < 1000; i++) {
+        handoff.push(i);
+    }
+    waiter.join();
+    assert(handoff.empty());
+}
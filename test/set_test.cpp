@@ -1,6 +1,90 @@
+#include <algorithm>
+#include <cassert>
 #include <containers/set.hpp>
+#include <cstddef>
 #include <cstdio>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 复制到 copies_left 归零时抛异常，live 统计还活着的对象
+struct fragile {
+    static inline int live = 0;
+    static inline int copies_left = -1;
+    int key;
+
+    fragile(int k) : key(k) {
+        ++live;
+    }
+
+    fragile(const fragile &that) : key(that.key) {
+        if (copies_left >= 0 && copies_left-- == 0) {
+            throw 1;
+        }
+        ++live;
+    }
+
+    // B 树搬移节点里的值时要求移动不抛异常
+    fragile(fragile &&that) noexcept : key(that.key) {
+        ++live;
+    }
+
+    ~fragile() {
+        --live;
+    }
+
+    bool operator<(const fragile &that) const {
+        return key < that.key;
+    }
+};
+
+// 第 calls_left 次比较时抛异常
+struct fragile_less {
+    static inline int calls_left = -1;
+
+    bool operator()(const fragile &a, const fragile &b) const {
+        if (calls_left >= 0 && calls_left-- == 0) {
+            throw 2;
+        }
+        return a.key < b.key;
+    }
+};
+
+// 按编号区分的分配器，释放时检查内存是不是同一编号的分配器申请的
+template <class T>
+struct tagged_allocator {
+    using value_type = T;
+    static inline std::map<void *, int> owner;
+    int tag;
+
+    explicit tagged_allocator(int t = 0) noexcept : tag(t) {}
+    template <class U>
+    tagged_allocator(const tagged_allocator<U> &that) noexcept
+        : tag(that.tag) {}
+
+    T *allocate(std::size_t n) {
+        T *p = std::allocator<T>().allocate(n);
+        owner[p] = tag;
+        return p;
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+        assert(owner.at(p) == tag);
+        owner.erase(p);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <class U>
+    bool operator==(const tagged_allocator<U> &that) const noexcept {
+        return tag == that.tag;
+    }
+};
 
 int main() {
     Marcus::multiset<int> table;
@@ -51,4 +135,321 @@ int main() {
     for (int i: s) {
         printf("%d\n", i);
     }
+
+    // random insert/erase against std::set, nodes are recycled by the pool
+    std::mt19937 rng(1);
+    Marcus::set<int> pooled;
+    std::set<int> expected;
+    for (int i = 0; i < 100000; i++) {
+        int key = rng() % 2000;
+        if (rng() % 2) {
+            pooled.insert(key);
+            expected.insert(key);
+        } else {
+            pooled.erase(key);
+            expected.erase(key);
+        }
+    }
+    assert(std::equal(pooled.begin(), pooled.end(), expected.begin(),
+                      expected.end()));
+    _RbTreeMemoryStats stats = pooled.memory_stats();
+    printf("nodes_in_use = %zu, nodes_free = %zu, chunks = %zu\n",
+           stats.nodes_in_use, stats.nodes_free, stats.chunks);
+    assert(stats.nodes_in_use == expected.size());
+    assert(stats.nodes_in_use + stats.nodes_free <= stats.nodes_reserved);
+    pooled.clear();
+    assert(pooled.memory_stats().nodes_in_use == 0);
+    assert(pooled.memory_stats().chunks == stats.chunks);
+
+    // sorted input is linked in one pass from a single chunk
+    std::vector<int> sorted;
+    for (int i = 0; i < 5000; i++) {
+        sorted.push_back(i / 2);
+    }
+    Marcus::set<int> bulk(sorted.begin(), sorted.end());
+    Marcus::multiset<int> mbulk(sorted.begin(), sorted.end());
+    assert(bulk.memory_stats().chunks == 1);
+    assert(bulk.memory_stats().nodes_in_use == 2500);
+    assert(std::equal(mbulk.begin(), mbulk.end(), sorted.begin(),
+                      sorted.end()));
+    Marcus::set<int> bulk_copy = bulk;
+    assert(bulk_copy.memory_stats().chunks == 1);
+    assert(std::equal(bulk_copy.begin(), bulk_copy.end(), bulk.begin(),
+                      bulk.end()));
+    for (int i = 0; i < 10000; i++) {
+        int key = rng() % 3000;
+        if (rng() % 2) {
+            assert(bulk.insert(key).second ==
+                   (bulk_copy.find(key) == bulk_copy.end()));
+            bulk_copy.insert(key);
+        } else {
+            assert(bulk.erase(key) == bulk_copy.erase(key));
+        }
+    }
+    assert(std::equal(bulk.begin(), bulk.end(), bulk_copy.begin(),
+                      bulk_copy.end()));
+
+    // an out-of-order element falls back to one-by-one insertion
+    std::vector<int> unsorted = {1, 2, 2, 5, 3, 9, 0, 5};
+    Marcus::set<int> partly(unsorted.begin(), unsorted.end());
+    Marcus::multiset<int> mpartly(unsorted.begin(), unsorted.end());
+    std::multiset<int> mexpected(unsorted.begin(), unsorted.end());
+    expected = std::set<int>(unsorted.begin(), unsorted.end());
+    assert(std::equal(partly.begin(), partly.end(), expected.begin(),
+                      expected.end()));
+    assert(std::equal(mpartly.begin(), mpartly.end(), mexpected.begin(),
+                      mexpected.end()));
+    assert(partly.memory_stats().nodes_in_use == expected.size());
+
+    // join-based set algebra against the std algorithms; merged nodes are
+    // relinked, never reallocated
+    std::vector<int> lhs_keys, rhs_keys, expected_keys;
+    for (int i = 0; i < 20000; i++) {
+        lhs_keys.push_back(rng() % 30000);
+        rhs_keys.push_back(rng() % 30000);
+    }
+    std::set<int> lhs_expected(lhs_keys.begin(), lhs_keys.end());
+    std::set<int> rhs_expected(rhs_keys.begin(), rhs_keys.end());
+    Marcus::set<int> lhs(lhs_expected.begin(), lhs_expected.end());
+    Marcus::set<int> rhs(rhs_expected.begin(), rhs_expected.end());
+    const int *rhs_first = &*rhs.begin();
+    size_t lhs_chunks = lhs.memory_stats().chunks;
+    size_t rhs_chunks = rhs.memory_stats().chunks;
+    lhs.merge(rhs);
+    // each tree keeps counting only the chunks it allocated itself
+    assert(lhs.memory_stats().chunks == lhs_chunks);
+    assert(rhs.memory_stats().chunks == rhs_chunks);
+    std::set_union(lhs_expected.begin(), lhs_expected.end(),
+                   rhs_expected.begin(), rhs_expected.end(),
+                   std::back_inserter(expected_keys));
+    assert(std::equal(lhs.begin(), lhs.end(), expected_keys.begin(),
+                      expected_keys.end()));
+    assert(&*lhs.find(*rhs_first) == rhs_first ||
+           &*rhs.find(*rhs_first) == rhs_first);
+    expected_keys.clear();
+    std::set_intersection(rhs_expected.begin(), rhs_expected.end(),
+                          lhs_expected.begin(), lhs_expected.end(),
+                          std::back_inserter(expected_keys));
+    assert(std::equal(rhs.begin(), rhs.end(), expected_keys.begin(),
+                      expected_keys.end()));
+
+    Marcus::set<int> filter(rhs_expected.begin(), rhs_expected.end());
+    lhs = Marcus::set<int>(lhs_expected.begin(), lhs_expected.end());
+    lhs.set_intersection(filter);
+    assert(std::equal(lhs.begin(), lhs.end(), expected_keys.begin(),
+                      expected_keys.end()));
+    lhs = Marcus::set<int>(lhs_expected.begin(), lhs_expected.end());
+    lhs.set_difference(filter);
+    expected_keys.clear();
+    std::set_difference(lhs_expected.begin(), lhs_expected.end(),
+                        rhs_expected.begin(), rhs_expected.end(),
+                        std::back_inserter(expected_keys));
+    assert(std::equal(lhs.begin(), lhs.end(), expected_keys.begin(),
+                      expected_keys.end()));
+    assert(lhs.memory_stats().nodes_in_use == expected_keys.size());
+    assert(std::equal(filter.begin(), filter.end(), rhs_expected.begin(),
+                      rhs_expected.end()));
+
+    // a single node moved between trees does not keep the chunks of the
+    // tree it came from alive
+    Marcus::set<int> keeper;
+    std::vector<int> range(20000);
+    for (int round = 0; round < 200; round++) {
+        std::iota(range.begin(), range.end(), round * 20000);
+        Marcus::set<int> temp(range.begin(), range.end());
+        assert(keeper.insert(temp.extract(temp.begin())).second);
+    }
+    stats = keeper.memory_stats();
+    assert(keeper.size() == 200 && stats.nodes_in_use == 200);
+    assert(stats.bytes_reserved < 200 * 2 * stats.node_size);
+
+    // 默认构造和移动构造不申请内存
+    static_assert(std::is_nothrow_default_constructible_v<Marcus::set<int>>);
+    static_assert(std::is_nothrow_move_constructible_v<Marcus::set<int>>);
+    {
+        tagged_allocator<int>::owner.clear();
+        Marcus::set<int, std::less<int>, tagged_allocator<int>> source(
+            tagged_allocator<int>(5));
+        source.insert(1);
+        auto moved = std::move(source);
+        size_t blocks = tagged_allocator<int>::owner.size();
+        Marcus::set<int, std::less<int>, tagged_allocator<int>> fresh(
+            tagged_allocator<int>(6));
+        auto again = std::move(fresh);
+        assert(tagged_allocator<int>::owner.size() == blocks);
+        assert(source.empty() && moved.size() == 1 && *moved.begin() == 1);
+        source.insert(2);
+        assert(source.size() == 1 && *--source.end() == 2);
+    }
+
+    // 节点句柄可以在别的线程上销毁，销毁时槽位交还给原来的树复用
+    {
+        Marcus::set<int> source;
+        for (int i = 0; i < 1000; i++) {
+            source.insert(i);
+        }
+        size_t chunks = source.memory_stats().chunks;
+        std::vector<Marcus::set<int>::node_type> handles;
+        for (int round = 0; round < 20; round++) {
+            for (int i = 0; i < 500; i++) {
+                handles.push_back(source.extract(source.begin()));
+            }
+            std::thread dropper([moved = std::move(handles)]() mutable {
+                moved.clear();
+            });
+            handles.clear();
+            for (int i = 0; i < 500; i++) {
+                source.insert(1000 + round * 500 + i);
+            }
+            dropper.join();
+        }
+        assert(source.size() == 1000 &&
+               source.memory_stats().nodes_in_use == 1000);
+        assert(source.memory_stats().chunks <= chunks + 1);
+    }
+
+    Marcus::multiset<int> mlhs(lhs_keys.begin(), lhs_keys.end());
+    Marcus::multiset<int> mrhs(rhs_keys.begin(), rhs_keys.end());
+    mlhs.merge(mrhs);
+    std::multiset<int> mmerged(lhs_keys.begin(), lhs_keys.end());
+    mmerged.insert(rhs_keys.begin(), rhs_keys.end());
+    assert(mrhs.empty() && std::equal(mlhs.begin(), mlhs.end(),
+                                      mmerged.begin(), mmerged.end()));
+
+    // 分配器不相等时 merge 逐个搬移元素，节点仍由申请它的分配器释放
+    {
+        using tagged_set = Marcus::set<int, std::less<int>,
+                                       tagged_allocator<int>>;
+        tagged_set left(tagged_allocator<int>(1));
+        tagged_set right(tagged_allocator<int>(2));
+        for (int i = 0; i < 1000; i++) {
+            left.insert(i * 2);
+            right.insert(i * 3);
+        }
+        left.merge(right);
+        assert(left.size() == 1666 && right.size() == 334);
+        assert(std::all_of(right.begin(), right.end(),
+                           [](int key) { return key % 6 == 0; }));
+        Marcus::multiset<int, std::less<int>, tagged_allocator<int>> mleft(
+            tagged_allocator<int>(3)),
+            mright(tagged_allocator<int>(4));
+        mleft.insert(left.begin(), left.end());
+        mright.insert(left.begin(), left.end());
+        mleft.merge(mright);
+        assert(mleft.size() == 2 * 1666 && mright.empty());
+    }
+    assert(tagged_allocator<int>::owner.empty());
+
+    // merge 之后两棵树共用大块，但各自的分配和释放可以在不同线程上进行
+    {
+        Marcus::set<int> left, right;
+        for (int i = 0; i < 20000; i++) {
+            left.insert(i * 2);
+            right.insert(i * 3);
+        }
+        left.merge(right);
+        auto churn = [](Marcus::set<int> &tree, int seed) {
+            std::mt19937 local(seed);
+            for (int i = 0; i < 100000; i++) {
+                int key = local() % 120000;
+                if (local() % 2) {
+                    tree.insert(key);
+                } else {
+                    tree.erase(key);
+                }
+            }
+        };
+        std::thread worker(churn, std::ref(right), 1);
+        churn(left, 2);
+        worker.join();
+    }
+
+    // order statistics: nth / rank / distance against a ordered vector
+    Marcus::multiset<int> ranked;
+    std::vector<int> ordered;
+    for (int i = 0; i < 20000; i++) {
+        int key = rng() % 1000;
+        if (rng() % 3) {
+            ranked.insert(key);
+            ordered.insert(std::upper_bound(ordered.begin(), ordered.end(), key),
+                          key);
+        } else if (auto it = ranked.find(key); it != ranked.end()) {
+            ranked.erase(it);
+            ordered.erase(std::lower_bound(ordered.begin(), ordered.end(), key));
+        }
+    }
+    assert(ranked.size() == ordered.size());
+    for (size_t k = 0; k < ordered.size(); k += 7) {
+        assert(*ranked.nth(k) == ordered[k]);
+        assert(ranked.distance(ranked.begin(), ranked.nth(k)) == k);
+    }
+    assert(ranked.nth(ordered.size()) == ranked.end());
+    for (int key = -1; key <= 1000; key++) {
+        auto lower = std::lower_bound(ordered.begin(), ordered.end(), key);
+        auto upper = std::upper_bound(ordered.begin(), ordered.end(), key);
+        assert(ranked.rank(key) == size_t(lower - ordered.begin()));
+        assert(ranked.count(key) == size_t(upper - lower));
+    }
+
+    // btree_set against std::set, including erase returning the successor
+    Marcus::btree_set<int> btree;
+    expected.clear();
+    for (int i = 0; i < 100000; i++) {
+        int key = rng() % 5000;
+        if (rng() % 3) {
+            assert(btree.insert(key).second == expected.insert(key).second);
+        } else if (auto it = btree.find(key); it != btree.end()) {
+            auto next = btree.erase(it);
+            auto expected_next = expected.erase(expected.find(key));
+            assert(next == btree.end() ? expected_next == expected.end()
+                                       : *next == *expected_next);
+        }
+    }
+    assert(btree.size() == expected.size());
+    assert(std::equal(btree.begin(), btree.end(), expected.begin(),
+                      expected.end()));
+    assert(std::equal(btree.rbegin(), btree.rend(), expected.rbegin(),
+                      expected.rend()));
+    printf("btree_set size = %zu, node_slots = %zu\n", btree.size(),
+           btree.node_slots());
+    Marcus::btree_set<int> copy = btree;
+    copy.erase(copy.begin(), copy.end());
+    assert(copy.empty() && btree.size() == expected.size());
+
+    // 复制到一半抛异常时，已经复制出的节点和元素都要释放
+    {
+        Marcus::btree_set<fragile> source;
+        for (int i = 0; i < 1000; i++) {
+            source.insert(fragile(i));
+        }
+        fragile::copies_left = 600;
+        bool thrown = false;
+        try {
+            Marcus::btree_set<fragile> partial = source;
+        } catch (int) {
+            thrown = true;
+        }
+        fragile::copies_left = -1;
+        assert(thrown && fragile::live == 1000);
+    }
+    assert(fragile::live == 0);
+
+    // 批量构造时比较器抛异常，刚构造、还没比较完的元素也要析构
+    {
+        std::vector<fragile> input;
+        for (int i = 0; i < 100; i++) {
+            input.emplace_back(i);
+        }
+        fragile_less::calls_left = 10;
+        bool thrown = false;
+        try {
+            Marcus::set<fragile, fragile_less> partial(input.begin(),
+                                                       input.end());
+        } catch (int) {
+            thrown = true;
+        }
+        fragile_less::calls_left = -1;
+        assert(thrown && fragile::live == 100);
+    }
+    assert(fragile::live == 0);
 }
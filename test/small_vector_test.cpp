@@ -0,0 +1,124 @@
+#include "_alloc_counter.hpp"
+#include <cassert>
+#include <containers/small_vector.hpp>
+#include <list>
+#include <memory/memory_resource.hpp>
+#include <stdio.h>
+#include <string>
+
+void test_inline_storage() {
+    int before = allocations;
+    Marcus::small_vector<int, 8> arr;
+    for (int i = 0; i < 6; i++) {
+        arr.push_back(i);
+    }
+    arr.insert(arr.begin() + 2, {40, 41});
+    arr.erase(arr.begin(), arr.begin() + 2);
+    arr.push_back(6);
+    arr.push_back(7);
+    // 八个以内都在对象内部
+    assert(allocations == before);
+    assert(arr.size() == 8 && arr.capacity() == 8);
+    assert(arr[0] == 40 && arr[1] == 41 && arr.back() == 7);
+
+    // 第九个元素时整体搬到堆上
+    arr.push_back(8);
+    assert(allocations == before + 1 && arr.capacity() == 16);
+    for (std::size_t i = 0; i < arr.size(); i++) {
+        printf("arr[%zd] = %d\n", i, arr[i]);
+    }
+    arr.erase(arr.begin() + 4, arr.end());
+    arr.shrink_to_fit();
+    assert(arr.capacity() == 8 && arr.size() == 4 && arr[3] == 3);
+    assert(allocations == before + 1);
+}
+
+void test_copy_and_move() {
+    using strings = Marcus::small_vector<std::string, 2>;
+    strings small{"a", "b"};
+    strings large{"c", "d", "e"};
+    strings copy = large;
+    assert(copy == large && copy != small);
+    assert(small < large);
+
+    // 内部存放的元素逐个移动，堆上的直接交出指针
+    strings moved_small = std::move(small);
+    strings moved_large = std::move(large);
+    assert(small.empty() && large.empty());
+    assert(moved_small.size() == 2 && moved_small[1] == "b");
+    assert(moved_large.size() == 3 && moved_large[2] == "e");
+
+    moved_small.swap(moved_large);
+    assert(moved_small.size() == 3 && moved_large.size() == 2);
+    moved_large = moved_small;
+    assert(moved_large == moved_small);
+    moved_small.assign(5, "x");
+    assert(moved_small.size() == 5 && moved_small[4] == "x");
+    moved_small.assign({"y"});
+    assert(moved_small.size() == 1 && moved_small.front() == "y");
+    moved_large.erase(moved_large.begin(), moved_large.begin());
+    assert(moved_large.size() == 3 && moved_large[2] == "e");
+}
+
+void test_overwrite() {
+    Marcus::small_vector<char, 4> buf;
+    buf.append_with(3, [](char *p, std::size_t n) {
+        for (std::size_t i = 0; i < n; i++) {
+            p[i] = 'a' + i;
+        }
+        return n;
+    });
+    // 超出内部容量时先搬到堆上再交给回调
+    buf.append_with(6, [](char *p, std::size_t) {
+        p[0] = 'z';
+        return std::size_t(1);
+    });
+    assert(buf.size() == 4 && buf[2] == 'c' && buf[3] == 'z');
+    assert(buf.capacity() >= 9);
+    buf.resize_for_overwrite(6);
+    assert(buf.size() == 6 && buf[0] == 'a');
+}
+
+void test_ranges() {
+    int before = allocations;
+    int raw[] = {1, 2, 3};
+    Marcus::small_vector<int, 8> arr;
+    arr.append_range(raw);
+    arr.insert_range(arr.begin(), raw);
+    // 长度已知时一次腾出位置，放得下就不分配
+    assert(allocations == before);
+    assert(arr.size() == 6 && arr[2] == 3 && arr[3] == 1);
+
+    std::list<int> l = {7, 8, 9, 10};
+    before = allocations;
+    arr.insert(arr.begin() + 1, l.begin(), l.end());
+    assert(allocations == before + 1 && arr.capacity() == 16);
+    assert(arr[1] == 7 && arr[4] == 10 && arr[5] == 2);
+    arr.assign_range(l);
+    assert(arr.size() == 4 && arr.front() == 7);
+}
+
+void test_swap_allocators() {
+    using alloc = Marcus::polymorphic_allocator<int>;
+    Marcus::pool_resource left_pool, right_pool;
+    Marcus::small_vector<int, 2, alloc> left(&left_pool), right(&right_pool);
+    for (int i = 0; i < 10; i++) {
+        left.push_back(i);
+        right.push_back(-i);
+    }
+    // 两边都在堆上时交换缓冲区，分配器也要跟着交换
+    left.swap(right);
+    assert(left.get_allocator().resource() == &right_pool);
+    assert(right.get_allocator().resource() == &left_pool);
+    assert(left[9] == -9 && right[9] == 9);
+}
+
+int main() {
+    test_inline_storage();
+    test_copy_and_move();
+    test_overwrite();
+    test_ranges();
+    test_swap_allocators();
+    printf("sizeof(small_vector<int, 8>) = %zd\n",
+           sizeof(Marcus::small_vector<int, 8>));
+}
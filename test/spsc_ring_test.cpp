@@ -0,0 +1,84 @@
+#include <adaptors/spsc_ring.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+struct message {
+    unsigned long seq;
+    unsigned length;
+    char payload[52];
+};
+
+int main() {
+    Marcus::spsc_ring<int, 8> ring;
+    assert(ring.empty() && ring.capacity() == 8);
+    auto slots = ring.reserve(5);
+    assert(slots.size() == 5);
+    for (int i = 0; i < 5; i++) {
+        slots[i] = i;
+    }
+    ring.commit(3); // 只发布前三个
+    assert(ring.size() == 3);
+    auto ready = ring.peek();
+    assert(ready.size() == 3 && ready[0] == 0 && ready[2] == 2);
+    ring.release(2);
+    // 队尾在下标 3，只剩 5 个到数组末尾的连续空位
+    assert(ring.reserve(8).size() == 5);
+    ring.commit(5);
+    // 回绕：剩下的 2 个空位在数组开头
+    slots = ring.reserve(8);
+    assert(slots.size() == 2 && slots.data() == ring.peek().data() - 2);
+    ring.commit(0);
+    assert(ring.size() == 6);
+    int value;
+    assert(ring.try_pop(value) && value == 2);
+    assert(ring.peek().size() == 5);
+    ring.release(5);
+    assert(ring.empty() && !ring.try_pop(value));
+    for (int i = 0; i < 8; i++) {
+        assert(ring.try_push(i));
+    }
+    assert(!ring.try_push(8) && ring.reserve(1).empty());
+
+    // 一个线程原地写消息，另一个原地读，批量大小随意变化
+    static Marcus::spsc_ring<message, 64> feed;
+    const unsigned long total = 200000;
+    std::thread producer([&] {
+        unsigned long seq = 0;
+        while (seq < total) {
+            auto out = feed.reserve(1 + seq % 7);
+            if (out.empty()) {
+                std::this_thread::yield();
+            }
+            for (message &m: out) {
+                m.seq = seq;
+                m.length = unsigned(seq % 52);
+                std::memset(m.payload, int(seq & 0x7f), m.length);
+                ++seq;
+            }
+            feed.commit(out.size());
+        }
+    });
+    unsigned long expected = 0;
+    while (expected < total) {
+        auto in = feed.peek();
+        if (in.empty()) {
+            std::this_thread::yield();
+        }
+        size_t take = std::min<size_t>(in.size(), 1 + expected % 5);
+        for (size_t i = 0; i < take; i++) {
+            const message &m = in[i];
+            assert(m.seq == expected && m.length == expected % 52);
+            for (unsigned k = 0; k < m.length; k++) {
+                assert(m.payload[k] == char(expected & 0x7f));
+            }
+            ++expected;
+        }
+        feed.release(take);
+    }
+    producer.join();
+    printf("received = %lu\n", expected);
+    assert(feed.empty());
+}
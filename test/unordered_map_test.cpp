@@ -0,0 +1,121 @@
+#include <cassert>
+#include <containers/unordered_map.hpp>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+struct string_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view __s) const noexcept {
+        return std::hash<std::string_view>()(__s);
+    }
+};
+
+// 所有键哈希值相同，逼出最长的探测链和溢出区扩容
+struct constant_hash {
+    std::size_t operator()(int) const noexcept {
+        return ~std::size_t(0);
+    }
+};
+
+int main() {
+    Marcus::unordered_map<std::string, int> table;
+    table["hello"] = 1;
+    table["world"] = 2;
+    table.emplace("foo", 3);
+    table.try_emplace("bar", 4);
+    printf("size = %zu\n", table.size()); // 4
+    printf("at(foo) = %d\n", table.at("foo")); // 3
+    printf("insert foo = %d\n", table.insert({"foo", 5}).second); // 0
+    table.insert_or_assign("foo", 5);
+    printf("at(foo) = %d\n", table.at("foo")); // 5
+    for (auto &[key, value]: table) {
+        printf("%s %d\n", key.c_str(), value);
+    }
+    assert(table.erase("hello") == 1 && table.erase("hello") == 0);
+    try {
+        table.at("hello");
+        assert(false);
+    } catch (std::out_of_range const &) {
+    }
+
+    // heterogeneous lookup with a transparent hash and key_equal
+    Marcus::unordered_map<std::string, int, string_hash, std::equal_to<>>
+        names{{"alice", 1}, {"bob", 2}};
+    assert(names.contains(std::string_view("alice")));
+    assert(names.find("bob")->second == 2);
+    assert(names.at(std::string_view("bob")) == 2);
+    assert(names.erase(std::string_view("alice")) == 1);
+
+    // random insert/erase against std::unordered_map
+    std::mt19937 rng(4);
+    Marcus::unordered_map<int, int> hashed;
+    std::unordered_map<int, int> ref;
+    for (int i = 0; i < 200000; ++i) {
+        int key = rng() % 5000;
+        if (rng() % 3 == 0) {
+            assert(hashed.erase(key) == ref.erase(key));
+        } else {
+            hashed[key] = i;
+            ref[key] = i;
+        }
+    }
+    assert(hashed.size() == ref.size());
+    for (auto const &[key, value]: ref) {
+        assert(hashed.at(key) == value);
+    }
+    std::size_t visited = 0;
+    for (auto const &[key, value]: hashed) {
+        assert(ref.at(key) == value);
+        ++visited;
+    }
+    assert(visited == ref.size());
+
+    Marcus::unordered_map<int, int> copy = hashed;
+    assert(copy == hashed);
+    copy[-1] = 0;
+    assert(copy != hashed);
+
+    // erase while iterating visits every element exactly once
+    std::size_t kept = 0;
+    for (auto it = hashed.begin(); it != hashed.end();) {
+        if (it->first % 2 == 0) {
+            it = hashed.erase(it);
+        } else {
+            ++kept;
+            ++it;
+        }
+    }
+    assert(kept == hashed.size());
+    for (auto const &[key, value]: hashed) {
+        assert(key % 2 == 1);
+    }
+
+    // reserve keeps the table from growing while it is filled
+    Marcus::unordered_map<int, int> reserved;
+    reserved.reserve(1000);
+    std::size_t buckets = reserved.bucket_count();
+    for (int i = 0; i < 1000; ++i) {
+        reserved.emplace(i, i);
+    }
+    assert(reserved.bucket_count() == buckets);
+    assert(reserved.load_factor() <= reserved.max_load_factor());
+    reserved.erase(reserved.begin(), reserved.end());
+    assert(reserved.empty() && reserved.begin() == reserved.end());
+
+    Marcus::unordered_map<int, int, constant_hash> colliding;
+    for (int i = 0; i < 300; ++i) {
+        colliding[i] = i;
+    }
+    for (int i = 0; i < 300; i += 3) {
+        colliding.erase(i);
+    }
+    assert(colliding.size() == 200);
+    for (int i = 0; i < 300; ++i) {
+        assert(colliding.contains(i) == (i % 3 != 0));
+    }
+    return 0;
+}
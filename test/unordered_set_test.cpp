@@ -0,0 +1,42 @@
+#include <cassert>
+#include <containers/unordered_set.hpp>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_set>
+
+int main() {
+    Marcus::unordered_set<int> s{1, 3, 5, 3};
+    printf("size = %zu\n", s.size()); // 3
+    printf("insert 4 = %d\n", s.insert(4).second); // 1
+    printf("insert 4 = %d\n", s.insert(4).second); // 0
+    printf("find 3 = %d\n", s.find(3) != s.end()); // 1
+    printf("find 2 = %d\n", s.find(2) != s.end()); // 0
+    s.erase(3);
+    printf("find 3 = %d\n", s.find(3) != s.end()); // 0
+
+    // random insert/erase against std::unordered_set
+    std::mt19937 rng(6);
+    Marcus::unordered_set<std::string> hashed;
+    std::unordered_set<std::string> ref;
+    for (int i = 0; i < 100000; ++i) {
+        std::string key = std::to_string(rng() % 3000);
+        if (rng() % 2 == 0) {
+            assert(hashed.erase(key) == ref.erase(key));
+        } else {
+            assert(hashed.insert(key).second == ref.insert(key).second);
+        }
+    }
+    assert(hashed.size() == ref.size());
+    for (auto const &key: ref) {
+        assert(hashed.contains(key));
+    }
+
+    Marcus::unordered_set<std::string> copy(hashed.begin(), hashed.end());
+    assert(copy == hashed);
+    copy.rehash(0);
+    assert(copy == hashed);
+    copy.clear();
+    assert(copy.empty() && copy.begin() == copy.end());
+    return 0;
+}
@@ -1,4 +1,6 @@
+#include <cassert>
 #include <iostream>
+#include <string>
 #include <utility/variant.hpp>
 
 void print(Marcus::variant<std::string, int, double> v) {
@@ -13,6 +15,114 @@ void print(Marcus::variant<std::string, int, double> v) {
     }
 }
 
+struct shape_area {
+    double operator()(int side) const {
+        return side * side;
+    }
+
+    double operator()(double radius) const {
+        return 3 * radius * radius;
+    }
+
+    double operator()(const std::string &) const {
+        return 0;
+    }
+};
+
+void test_visit() {
+    using V = Marcus::variant<std::string, int, double>;
+    V s(Marcus::in_place_index<0>, "abc"), i(3), d(2.0);
+    const V &cd = d;
+    assert(i.visit(shape_area()) == 9);
+    assert(cd.visit(shape_area()) == 12);
+    // 访问者可以修改备选值
+    i.visit([](auto &x) {
+        x += x;
+    });
+    assert(i.get<int>() == 6);
+
+    // 多个 variant：访问者收到每个 variant 当前的备选值
+    auto both = [](const auto &a, const auto &b) {
+        return shape_area()(a) + shape_area()(b);
+    };
+    assert(Marcus::visit(both, i, cd) == 48);
+    assert(Marcus::visit(both, s, s) == 0);
+    assert(Marcus::visit(shape_area(), d) == 12);
+    assert(Marcus::visit([] { return 7; }) == 7);
+
+    // 右值 variant 的备选值以右值传给访问者
+    std::string taken = Marcus::visit(
+        [](auto &&x) -> std::string {
+            if constexpr (std::is_same_v<std::decay_t<decltype(x)>,
+                                         std::string>) {
+                return std::move(x);
+            } else {
+                return "";
+            }
+        },
+        std::move(s));
+    assert(taken == "abc" && s.get<std::string>().empty());
+}
+
+// 下标只占一个字节；备选类型都平凡时 variant 本身也平凡
+using small_variant = Marcus::variant<int, float, char>;
+static_assert(sizeof(small_variant) == 2 * sizeof(int));
+static_assert(std::is_trivially_copyable_v<small_variant>);
+static_assert(std::is_trivially_destructible_v<small_variant>);
+static_assert(!std::is_trivially_copyable_v<
+              Marcus::variant<std::string, int, double>>);
+
+void test_copy_and_assign() {
+    small_variant a(1.5f), b = a;
+    b = small_variant('c');
+    assert(a.get<float>() == 1.5f && b.get<char>() == 'c');
+
+    using V = Marcus::variant<std::string, int, double>;
+    V s(std::string(40, 's')), i(7);
+    V copy = s;
+    assert(copy.get<std::string>() == s.get<std::string>());
+    // 换成另一种备选类型时先销毁原来的值
+    copy = i;
+    assert(copy.get<int>() == 7);
+    copy = s;
+    assert(copy.get<std::string>().size() == 40);
+    V moved = std::move(copy);
+    assert(moved.get<std::string>().size() == 40);
+    assert(copy.get<std::string>().empty());
+    i = std::move(moved);
+    assert(i.get<std::string>().size() == 40);
+}
+
+// 复制时抛异常的类型
+struct thrower {
+    thrower() = default;
+
+    thrower(const thrower &) {
+        throw 1;
+    }
+
+    thrower(thrower &&) noexcept = default;
+
+    thrower &operator=(const thrower &) = default;
+};
+
+void test_throwing_assign() {
+    using V = Marcus::variant<std::string, thrower>;
+    V p(std::string(100, 'a')), q(Marcus::in_place_index<1>);
+    bool thrown = false;
+    try {
+        p = q;
+    } catch (int) {
+        thrown = true;
+    }
+    // 复制失败时原来的值保持不变，析构时也不会重复销毁
+    assert(thrown && p.index() == 0);
+    assert(p.get<std::string>() == std::string(100, 'a'));
+    V r(std::string(50, 'b'));
+    r = std::move(q);
+    assert(r.index() == 1);
+}
+
 int main() {
     Marcus::variant<std::string, int, double> v1(Marcus::in_place_index<0>,
                                                  "Marcus");
@@ -21,4 +131,7 @@ int main() {
     print(v2);
     Marcus::variant<std::string, int, double> v3 = 3.14;
     print(v3);
+    test_visit();
+    test_copy_and_assign();
+    test_throwing_assign();
 }
@@ -1,5 +1,156 @@
+#include <cassert>
 #include <containers/vector.hpp>
+#include <list>
+#include <ranges>
+#include <sstream>
 #include <stdio.h>
+#include <string>
+
+// 自定义增长策略：每次只多一个元素
+struct grow_by_one {
+    static std::size_t next_capacity(std::size_t, std::size_t required) {
+        return required;
+    }
+};
+
+void test_growth_and_relocation() {
+    Marcus::vector<int> ints;
+    for (int i = 0; i < 5; i++) {
+        ints.push_back(i);
+    }
+    // 容量用满才扩容，默认翻倍
+    assert(ints.capacity() == 8);
+    ints.reserve(20);
+    assert(ints.capacity() == 20);
+    ints.shrink_to_fit();
+    assert(ints.capacity() == 5);
+
+    Marcus::vector<int, std::allocator<int>, grow_by_one> exact;
+    for (int i = 0; i < 5; i++) {
+        exact.insert(exact.begin(), i);
+        assert(exact.capacity() == exact.size());
+    }
+    assert(exact.front() == 4 && exact.back() == 0);
+
+    // 插入的值引用自身元素时，扩容后仍然正确
+    Marcus::vector<std::string> strs(3, std::string(30, 'x'));
+    assert(strs.size() == 3);
+    strs.push_back(strs[0]);
+    strs.insert(strs.begin(), strs[3]);
+    strs.insert(strs.begin() + 1, 2, std::string("y"));
+    strs.erase(strs.begin() + 3, strs.begin() + 5);
+    assert(strs.size() == 5 && strs[1] == "y" && strs[4] == strs[0]);
+    // 空区间什么也不做，不能把元素移动赋值给自己
+    strs.erase(strs.begin() + 1, strs.begin() + 1);
+    assert(strs.size() == 5 && strs[2] == "y" && strs[3] == strs[0]);
+    Marcus::vector<std::string> copy(strs);
+    copy = strs;
+    assert(copy == strs);
+}
+
+// 复制到 copies_left 归零时抛异常；移动没有 noexcept，扩容时只能复制
+struct brittle {
+    static inline int live = 0;
+    static inline int copies_left = -1;
+    std::string text;
+
+    brittle(int i) : text(30, static_cast<char>('a' + i)) {
+        ++live;
+    }
+
+    brittle(const brittle &that) : text(that.text) {
+        if (copies_left >= 0 && copies_left-- == 0) {
+            throw 1;
+        }
+        ++live;
+    }
+
+    brittle(brittle &&that) : text(std::move(that.text)) {
+        ++live;
+    }
+
+
+    ~brittle() {
+        --live;
+    }
+};
+
+// 搬到新缓冲区时复制失败，旧缓冲区里的元素原样保留
+void test_throwing_relocation() {
+    Marcus::vector<brittle> items;
+    for (int i = 0; i < 10; i++) {
+        items.emplace_back(i);
+    }
+    // 容量恰好用满，之后每种增长操作都要换缓冲区
+    items.shrink_to_fit();
+    std::size_t old_cap = items.capacity();
+    auto attempt = [&](auto &&op) {
+        brittle::copies_left = 5;
+        bool thrown = false;
+        try {
+            op();
+        } catch (int) {
+            thrown = true;
+        }
+        brittle::copies_left = -1;
+        assert(thrown && items.size() == 10 && items.capacity() == old_cap);
+        assert(brittle::live == 10);
+        for (int i = 0; i < 10; i++) {
+            assert(items[i].text == brittle(i).text);
+        }
+    };
+    attempt([&] { items.reserve(100); });
+    attempt([&] { items.resize(11, brittle(0)); });
+    attempt([&] { items.emplace_back(10); });
+    attempt([&] { items.insert(items.begin() + 3, 2, brittle(0)); });
+}
+
+void test_overwrite() {
+    Marcus::vector<unsigned char> buf(4, 'a');
+    buf.resize_for_overwrite(10);
+    assert(buf.size() == 10 && buf[3] == 'a');
+    for (int i = 4; i < 10; i++) {
+        buf[i] = 'b';
+    }
+    // 回调只写了一部分时，只有写入的部分计入 size
+    std::size_t n = buf.append_with(8, [](unsigned char *p, std::size_t) {
+        p[0] = 'c';
+        p[1] = 'd';
+        return std::size_t(2);
+    });
+    assert(n == 2 && buf.size() == 12 && buf.capacity() >= 18);
+    assert(buf[9] == 'b' && buf[10] == 'c' && buf[11] == 'd');
+    buf.resize_for_overwrite(3);
+    assert(buf.size() == 3 && buf.back() == 'a');
+}
+
+void test_ranges() {
+    int raw[] = {1, 2, 3, 4};
+    Marcus::vector<int> v;
+    v.append_range(raw);
+    std::list<int> l = {7, 8};
+    v.insert_range(v.begin() + 1, l);
+    assert(v.size() == 6 && v[0] == 1 && v[1] == 7 && v[2] == 8 &&
+           v[3] == 2 && v.back() == 4);
+
+    // 只能单遍读的区间：追加后旋转到插入位置
+    std::istringstream in("5 6 9");
+    v.insert_range(v.begin() + 2, std::ranges::istream_view<int>(in));
+    assert(v.size() == 9 && v[1] == 7 && v[2] == 5 && v[4] == 9 &&
+           v[5] == 8);
+
+    std::istringstream in2("10 11");
+    Marcus::vector<int> w(std::istream_iterator<int>(in2),
+                          std::istream_iterator<int>{});
+    assert(w.size() == 2 && w[0] == 10 && w[1] == 11);
+
+    Marcus::vector<std::string> strs = {"a", "b"};
+    std::list<std::string> more = {"c", "d", "e"};
+    strs.insert(strs.begin() + 1, more.begin(), more.end());
+    assert(strs.size() == 5 && strs[1] == "c" && strs[4] == "b");
+    strs.assign_range(more);
+    assert(strs.size() == 3 && strs[0] == "c");
+}
 
 int main() {
     Marcus::vector<int> arr;
@@ -22,4 +173,9 @@ int main() {
     printf("arr.size() = %zd\n", arr.size());
     printf("bar.size() = %zd\n", bar.size());
     printf("sizeof(vector) = %zd\n", sizeof(Marcus::vector<int>));
+
+    test_growth_and_relocation();
+    test_throwing_relocation();
+    test_overwrite();
+    test_ranges();
 }